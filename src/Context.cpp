@@ -1,16 +1,16 @@
 #include "Context.hpp"
 
-void Context::name(std::string const& name) {
-    m_name = name;
+void Context::name(std::string name) {
+    m_name = std::move(name);
 }
-std::string Context::name() const {
+std::string const& Context::name() const {
     return m_name;
 }
 
-void Context::gdPath(std::filesystem::path const& path) {
-    m_gdPath = path;
+void Context::gdPath(std::filesystem::path path) {
+    m_gdPath = std::move(path);
 }
-std::filesystem::path Context::gdPath() const {
+std::filesystem::path const& Context::gdPath() const {
     return m_gdPath;
 }
 
@@ -29,6 +29,6 @@ Contexts* Contexts::get() {
     return inst;
 }
 
-std::vector<Context*> Contexts::all() const {
+Span<Context* const> Contexts::all() const {
     return m_contexts;
 }
@@ -4,6 +4,7 @@
 #include <utils.hpp>
 #include <filesystem>
 #include <string>
+#include <Span.hpp>
 
 class Context {
 protected:
@@ -11,11 +12,11 @@ protected:
     std::string m_name;
 
 public:
-    void name(std::string const& name);
-    std::string name() const;
+    void name(std::string name);
+    std::string const& name() const;
 
-    void gdPath(std::filesystem::path const& name);
-    std::filesystem::path gdPath() const;
+    void gdPath(std::filesystem::path path);
+    std::filesystem::path const& gdPath() const;
 
     Context(std::filesystem::path const& gdPath);
 };
@@ -29,5 +30,5 @@ public:
 
     static Contexts* get();
 
-    std::vector<Context*> all() const;
+    Span<Context* const> all() const;
 };
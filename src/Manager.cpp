@@ -1,5 +1,6 @@
 #include "Manager.hpp"
 #include "windows/Window.hpp"
+#include "graphics/GdiTextMeasurer.hpp"
 #include <ShellScalingApi.h>
 #include <fstream>
 
@@ -8,16 +9,20 @@ static Manager* g_manager = new Manager();
 Manager* Manager::setupManager(HINSTANCE inst) {
     m_inst = inst;
     #ifndef NDEBUG
-    if (AllocConsole()) {
-        FILE* dummyFile;
-        freopen_s(&dummyFile, "CONOUT$", "w", stdout);
-        freopen_s(&dummyFile, "CONIN$", "r", stdin);
-    } else {
-        MessageBoxA(nullptr, "Unable to attach console", "wtf", MB_ICONERROR);
+    // console programs like the widget tests have one already
+    if (!GetConsoleWindow()) {
+        if (AllocConsole()) {
+            FILE* dummyFile;
+            freopen_s(&dummyFile, "CONOUT$", "w", stdout);
+            freopen_s(&dummyFile, "CONIN$", "r", stdin);
+        } else {
+            MessageBoxA(nullptr, "Unable to attach console", "wtf", MB_ICONERROR);
+        }
     }
     #endif
     this->load();
     this->theme();
+    TextCache::get()->measurer(std::make_unique<GdiTextMeasurer>());
     m_dataLoaded = true;
     return this;
 }
@@ -93,12 +98,13 @@ HINSTANCE Manager::getInst() const {
     return m_inst;
 }
 
-std::wstring Manager::fontFaceID(std::wstring const& font, int size) {
-    return font + std::to_wstring(size);
+std::wstring Manager::fontFaceID(std::wstring const& font, int size, int style) {
+    return font + std::to_wstring(size) + L"_" + std::to_wstring(style);
 }
 
 HFONT Manager::loadFont(std::wstring const& face, int size, int style) {
-    auto faceid = fontFaceID(face, size);
+    auto faceid = fontFaceID(face, size, style);
+    std::lock_guard<std::mutex> lock(m_fontLock);
     if (m_fonts.count(faceid)) return m_fonts.at(faceid);
     auto font = CreateFontW(
         size,
@@ -118,25 +124,28 @@ HFONT Manager::loadFont(std::wstring const& face, int size, int style) {
 }
 
 HMENU Manager::acquireMenuID() {
-    HMENU id = reinterpret_cast<HMENU>(0x100);
-    while (m_menuIDs.count(id)) id++;
-    m_menuIDs.insert(id);
-    return id;
+    // generations start from 1, so these never clash with IDOK and the like
+    auto id = m_menuIDs.insert(true);
+    if (!id) {
+        throw std::runtime_error("Out of menu IDs");
+    }
+    return reinterpret_cast<HMENU>(static_cast<uintptr_t>(id.value()));
 }
 
 void Manager::relinquishMenuID(HMENU id) {
-    m_menuIDs.erase(id);
+    m_menuIDs.erase(SlotHandle(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(id))));
 }
 
 int Manager::acquireWindowClassID() {
-    auto id = 0;
-    while (m_classIDs.count(id)) id++;
-    m_classIDs.insert(id);
-    return id;
+    auto id = m_classIDs.insert(true);
+    if (!id) {
+        throw std::runtime_error("Out of window class IDs");
+    }
+    return static_cast<int>(id.value());
 }
 
 void Manager::relinquishWindowClassID(int id) {
-    m_classIDs.erase(id);
+    m_classIDs.erase(SlotHandle(static_cast<uint32_t>(id)));
 }
 
 void Manager::borderlessWindows(bool b) {
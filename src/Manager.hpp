@@ -7,6 +7,8 @@
 #include <unordered_set>
 #include <Style.hpp>
 #include <filesystem>
+#include <mutex>
+#include <SlotMap.hpp>
 #include "config.hpp"
 
 class Window;
@@ -17,16 +19,19 @@ protected:
     HINSTANCE m_inst;
     Window* m_mainWindow = nullptr;
     std::unordered_map<std::wstring, HFONT> m_fonts;
+    // fonts get loaded by text measured off the UI thread too
+    std::mutex m_fontLock;
     std::unordered_map<LPTSTR, HCURSOR> m_cursors;
-    std::unordered_set<HMENU> m_menuIDs;
-    std::unordered_set<int> m_classIDs;
+    // menu IDs end up in the low word of WM_COMMAND, so they're kept to 16 bits
+    SlotMap<bool, 10, 6> m_menuIDs;
+    SlotMap<bool> m_classIDs;
     Theme::Default m_theme = Theme::Default::Dark;
     bool m_dataLoaded = false;
     int m_dpi = 0;
     ULONG_PTR m_gdiToken;
     Gdiplus::GdiplusStartupInput m_gdiStartupInput;
     
-    std::wstring fontFaceID(std::wstring const& font, int size);
+    std::wstring fontFaceID(std::wstring const& font, int size, int style);
 
     Manager* setupManager(HINSTANCE inst);
 
@@ -15,6 +15,7 @@ Style* Style::current() {
 
 void Style::load(Theme const& t) {
     m_theme = t;
+    m_generation++;
 }
 
 Theme& Theme::get(Theme::Default d) {
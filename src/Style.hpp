@@ -41,6 +41,7 @@ struct Theme {
 class Style {
 protected:
     Theme m_theme;
+    size_t m_generation = 0;
 
     Style();
 
@@ -70,5 +71,7 @@ public:
     DEF_THEME_GETTER(useBorders);
 
     static Style* current();
+    // bumped on every load so cached paint objects know to go stale
+    static size_t generation() { return Style::current()->m_generation; }
     void load(Theme const& theme);
 };
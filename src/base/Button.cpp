@@ -50,12 +50,9 @@ void Button::updateSize(HDC hdc, SIZE available) {
     Widget::updateSize(hdc, available);
 }
 
-void Button::paint(HDC hdc, PAINTSTRUCT* ps) {
+void Button::paint(Canvas& canvas) {
     auto r = this->rect();
 
-    Graphics g(hdc);
-    InitGraphics(g);
-
     auto c1 = m_mousedown ?
             color::lighten(m_bgColor, Style::buttonPress()) :
         (m_hovered ?
@@ -64,27 +61,21 @@ void Button::paint(HDC hdc, PAINTSTRUCT* ps) {
         );
     auto c2 = color::darken(c1, Style::buttonGradient());
 
-    FillRoundRect(
-        &g, r,
-        LinearGradientBrush(
-            Point { 0, r.Y }, Point { 0, r.Y + r.Height }, c1, c2
-        ),
-        s_rounding / 2, s_rounding
+    canvas.fillRoundRect(
+        r, s_rounding / 2,
+        Fill::linear(Point { 0, 0 }, Point { 0, r.Height }, c1, c2)
     );
     
-    StringFormat f;
-    f.SetAlignment(StringAlignmentCenter);
-    f.SetLineAlignment(StringAlignmentCenter);
-    f.SetTrimming(StringTrimmingNone);
-    this->paintText(hdc, r, f);
+    this->paintText(canvas, r, {
+        StringAlignmentCenter, StringAlignmentCenter, StringTrimmingNone
+    });
 
     if (Style::useBorders()) {
-        DrawRoundRect(
-            &g, r,
-            color::lighten(c1, Style::buttonBorder()),
-            s_rounding / 2, s_rounding
+        canvas.strokeRoundRect(
+            r, s_rounding / 2,
+            color::lighten(c1, Style::buttonBorder())
         );
     }
 
-    Widget::paint(hdc, ps);
+    Widget::paint(canvas);
 }
@@ -17,7 +17,7 @@ public:
     Button(std::string const& text);
 
     void updateSize(HDC hdc, SIZE) override;
-    void paint(HDC hdc, PAINTSTRUCT* ps) override;
+    void paint(Canvas& canvas) override;
 
     bool wantsMouse() const override;
     HCURSOR cursor() const;
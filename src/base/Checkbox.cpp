@@ -58,7 +58,7 @@ void Checkbox::updateSize(HDC hdc, SIZE available) {
     Widget::updateSize(hdc, available);
 }
 
-void Checkbox::paint(HDC hdc, PAINTSTRUCT* ps) {
+void Checkbox::paint(Canvas& canvas) {
     auto r = this->rect();
 
     Rect cr;
@@ -70,9 +70,6 @@ void Checkbox::paint(HDC hdc, PAINTSTRUCT* ps) {
     r.X += m_fontSize + 5_px;
     r.Width -= m_fontSize - 5_px;
 
-    Graphics g(hdc);
-    InitGraphics(g);
-
     auto color = m_checked ? Style::button() : Style::button();
     auto c1 = 
         m_mousedown ?
@@ -82,12 +79,11 @@ void Checkbox::paint(HDC hdc, PAINTSTRUCT* ps) {
             color);
     auto c2 = color::darken(c1, Style::buttonGradient());
     
-    FillRoundRect(&
-        g, cr, 
-        LinearGradientBrush(
-            Point { 0, r.Y }, Point { 0, r.Y + r.Height }, c1, c2
-        ),
-        Button::s_rounding / 2, Button::s_rounding
+    canvas.fillRoundRect(
+        cr, Button::s_rounding / 2,
+        Fill::linear(
+            Point { 0, r.Y - cr.Y }, Point { 0, r.Y - cr.Y + r.Height }, c1, c2
+        )
     );
 
     if (m_checked) {
@@ -97,32 +93,28 @@ void Checkbox::paint(HDC hdc, PAINTSTRUCT* ps) {
         auto wt = w / t;
         auto wh = (t - 1) * wt;
         auto d = (cr.Height - wh) / 2;
-        Pen pen(Style::text(), 1.0_pxf);
-        GraphicsPath path;
-        path.AddLine(
+        Path path;
+        path.addLine(
             cr.X + p, cr.Y + d + (t - 2) * wt,
             cr.X + p + wt, cr.Y + d + wh
         );
-        path.AddLine(
+        path.addLine(
             cr.X + p + wt, cr.Y + d + wh,
             cr.X + p + w, cr.Y + d
         );
-        g.DrawPath(&pen, &path);
+        canvas.strokePath(path, Style::text(), 1.0_pxf);
     }
 
     if (Style::useBorders()) {
-        DrawRoundRect(
-            &g, cr,
-            color::lighten(c1, Style::buttonBorder()),
-            Button::s_rounding / 2, Button::s_rounding
+        canvas.strokeRoundRect(
+            cr, Button::s_rounding / 2,
+            color::lighten(c1, Style::buttonBorder())
         );
     }
 
-    StringFormat f;
-    f.SetAlignment(StringAlignmentNear);
-    f.SetLineAlignment(StringAlignmentCenter);
-    f.SetTrimming(StringTrimmingNone);
-    this->paintText(hdc, r, f);
+    this->paintText(canvas, r, {
+        StringAlignmentNear, StringAlignmentCenter, StringTrimmingNone
+    });
 
-    Widget::paint(hdc, ps);
+    Widget::paint(canvas);
 }
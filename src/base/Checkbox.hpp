@@ -14,7 +14,7 @@ public:
     Checkbox(std::string const& text, bool checked = false);
 
     void updateSize(HDC hdc, SIZE available) override;
-    void paint(HDC hdc, PAINTSTRUCT* ps) override;
+    void paint(Canvas& canvas) override;
 
     bool wantsMouse() const override;
     HCURSOR cursor() const;
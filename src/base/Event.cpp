@@ -0,0 +1,11 @@
+#include "Event.hpp"
+
+Event::Event(Type type) : m_type(type) {}
+
+void Event::stopPropagation() {
+    m_stopped = true;
+}
+
+bool Event::isMouse() const {
+    return m_type != Type::KeyDown && m_type != Type::KeyUp;
+}
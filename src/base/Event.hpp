@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Types.hpp>
+#include <cstddef>
+
+class Widget;
+
+// Goes down from the window to the target in the capture phase, and
+// back up to the window in the bubble phase
+struct Event {
+    enum class Type {
+        MouseDown,
+        MouseUp,
+        MouseDoubleClick,
+        MouseMove,
+        MouseWheel,
+        KeyDown,
+        KeyUp,
+    };
+    enum class Phase {
+        Capture,
+        Target,
+        Bubble,
+    };
+
+    Type m_type;
+    Phase m_phase = Phase::Capture;
+    Widget* m_target = nullptr;
+    // whose listeners are running
+    Widget* m_current = nullptr;
+    Point m_point;
+    bool m_down = false;
+    // sent to the widget capturing the mouse rather than what's under it
+    bool m_captured = false;
+    // in WHEEL_DELTA units, positive when scrolling up
+    int m_delta = 0;
+    size_t m_key = 0;
+    size_t m_scanCode = 0;
+    bool m_stopped = false;
+
+    Event(Type type);
+
+    // the widget it's at still gets to handle it, but it goes no further
+    void stopPropagation();
+    bool isMouse() const;
+};
@@ -5,6 +5,7 @@ using namespace std::chrono_literals;
 int Input::s_pad = 5_px;
 
 Input::Input() {
+    this->updateMeasureString();
     this->text("");
     this->font(Style::font());
     this->color(Style::text());
@@ -28,8 +29,8 @@ void Input::keyboardCaptured(bool k) {
     }
 }
 
-void Input::placeHolder(std::wstring const& text) {
-    m_placeHolder = text;
+void Input::placeHolder(std::wstring text) {
+    m_placeHolder = std::move(text);
     this->update();
 }
 
@@ -57,34 +58,39 @@ void Input::limit(size_t characters) {
 void Input::drawSize(size_t characters, size_t lines) {
     m_drawCharCount = characters;
     m_drawLineCount = lines;
+    this->updateMeasureString();
+    this->invalidateLayout();
     this->update();
 }
 
+void Input::updateMeasureString() {
+    m_measureString = L"";
+    for (size_t i = 0; i < m_drawLineCount; i++) {
+        m_measureString += std::wstring(m_drawCharCount, 'w') + L'\n';
+    }
+    if (m_measureString.size()) {
+        m_measureString.pop_back();
+    }
+}
+
+std::wstring const* Input::sizingText() const {
+    return &m_measureString;
+}
+
 void Input::updateSize(HDC hdc, SIZE available) {
     if (m_autoresize) {
-        std::wstring mtext = L"";
-        for (size_t i = 0; i < m_drawLineCount; i++) {
-            mtext += std::wstring(m_drawCharCount, 'w') + L'\n';
-        }
-        mtext.pop_back();
-        auto r = this->measureText(hdc, mtext, available, StringFormat());
+        auto r = this->measureText(hdc, m_measureString, available);
         this->resize(static_cast<int>(r.Width) + 10_px, static_cast<int>(r.Height) + 10_px);
         m_autoresize = true;
     }
     Widget::updateSize(hdc, available);
 }
 
-void Input::paint(HDC hdc, PAINTSTRUCT* ps) {
+void Input::paint(Canvas& canvas) {
     auto r = this->rect();
+    auto hdc = static_cast<HDC>(canvas.device());
 
-    Graphics g(hdc);
-    InitGraphics(g);
-
-    FillRoundRect(
-        &g, r, 
-        Style::inputBG(),
-        Button::s_rounding / 2, Button::s_rounding
-    );
+    canvas.fillRoundRect(r, Button::s_rounding / 2, Style::inputBG());
 
     m_wordWrap = m_drawLineCount > 1;
 
@@ -96,36 +102,34 @@ void Input::paint(HDC hdc, PAINTSTRUCT* ps) {
     tr.Height -= s_pad * 2;
     if (!m_text.size() && !m_keyboardFocused) {
         this->paintText(
-            hdc, m_placeHolder, FontStyleItalic,
+            canvas, m_placeHolder, FontStyleItalic,
             color::alpha(m_color, 150), tr
         );
     } else {
-        this->paintText(hdc, tr);
+        this->paintText(canvas, tr);
     }
     if (m_keyboardFocused) {
         if (m_cursorStart - m_cursorEnd) {
-            SolidBrush selectBrush(Style::select());
             auto textTo = m_text.substr(0, m_cursorStart);
             auto p = this->measureText(
-                hdc, textTo, { tr.Width, tr.Height }, StringFormat()
+                hdc, textTo, { tr.Width, tr.Height }
             );
             auto textFrom = m_text.substr(0, m_cursorEnd);
             auto p2 = this->measureText(
-                hdc, textFrom, { tr.Width, tr.Height }, StringFormat()
+                hdc, textFrom, { tr.Width, tr.Height }
             );
             auto swidth = std::min(p.Width, p2.Width);
             auto ewidth = std::max(p.Width, p2.Width);
             swidth = (swidth ? swidth - s_pad / 2.f : swidth);
             auto h = fabsf(p2.Height - p.Height);
-            g.FillRectangle(
-                &selectBrush,
+            canvas.fillRect(
                 RectF {
                     tr.X + swidth, static_cast<REAL>(tr.Y),
                     ewidth - swidth, h ? h : static_cast<REAL>(m_fontSize)
-                }
+                },
+                Style::select()
             );
         } else if (m_blink) {
-            SolidBrush selectBrush(Style::text());
             auto textTo = m_text.substr(0, m_cursorStart);
             auto lines = std::count(textTo.begin(), textTo.end(), '\n');
             if (lines) {
@@ -134,31 +138,30 @@ void Input::paint(HDC hdc, PAINTSTRUCT* ps) {
             }
             std::wcout << textTo << "\n";
             auto p = this->measureText(
-                hdc, textTo, { tr.Width, tr.Height }, StringFormat()
+                hdc, textTo, { tr.Width, tr.Height }
             );
             if (lines) {
                 tr.Y += static_cast<int>(p.Height + ((!textTo.size() || textTo.back() == L'\n') ? lines * m_fontSize : 0));
             }
-            g.FillRectangle(
-                &selectBrush,
+            canvas.fillRect(
                 RectF {
                     tr.X + (p.Width ? p.Width - s_pad / 2.f : p.Width),
                     static_cast<REAL>(tr.Y),
                     0.5_pxf, static_cast<REAL>(m_fontSize)
-                }
+                },
+                Style::text()
             );
         }
     }
 
     if (Style::useBorders()) {
-        DrawRoundRect(
-            &g, r,
-            color::lighten(Style::inputBG(), Style::buttonBorder()),
-            Button::s_rounding / 2, Button::s_rounding
+        canvas.strokeRoundRect(
+            r, Button::s_rounding / 2,
+            color::lighten(Style::inputBG(), Style::buttonBorder())
         );
     }
 
-    Widget::paint(hdc, ps);
+    Widget::paint(canvas);
 }
 
 void Input::moveCursorBy(int pos, bool shift) {
@@ -19,9 +19,12 @@ protected:
     size_t m_hScroll = 0;
     size_t m_vScroll = 0;
     std::wstring m_placeHolder = L"";
+    std::wstring m_measureString = L"";
     UINT m_blinkTimer = 0;
 
     void blink();
+    void updateMeasureString();
+    std::wstring const* sizingText() const override;
 
 public:
     Input();
@@ -40,11 +43,11 @@ public:
 
     void drawSize(size_t characters, size_t lines);
     void limit(size_t characters);
-    void placeHolder(std::wstring const& text);
+    void placeHolder(std::wstring text);
     void placeHolder(std::string const& text);
     
     void keyDown(size_t key, size_t scanCode) override;
     void updateSize(HDC hdc, SIZE size) override;
-    void paint(HDC hdc, PAINTSTRUCT* ps) override;
+    void paint(Canvas& canvas) override;
 };
 
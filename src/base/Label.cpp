@@ -19,6 +19,6 @@ void Label::updateSize(HDC hdc, SIZE available) {
     Widget::updateSize(hdc, available);
 }
 
-void Label::paint(HDC hdc, PAINTSTRUCT* ps) {
-    TextWidget::paint(hdc, ps);
+void Label::paint(Canvas& canvas) {
+    TextWidget::paint(canvas);
 }
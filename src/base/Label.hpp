@@ -8,5 +8,5 @@ public:
     Label(std::string const& text);
 
     void updateSize(HDC hdc, SIZE size) override;
-    void paint(HDC hdc, PAINTSTRUCT* ps) override;
+    void paint(Canvas& canvas) override;
 };
@@ -1,4 +1,6 @@
 #include "Layout.hpp"
+#include <Window.hpp>
+#include <cmath>
 
 Pad::Pad(bool exp) {
     m_typeName = "Pad";
@@ -23,6 +25,8 @@ void Pad::resize(int size) {
 
 void Pad::expand(bool e) {
     m_expand = e;
+    this->invalidateLayout();
+    this->update();
 }
 
 bool Pad::doesExpand() const {
@@ -81,6 +85,7 @@ void PadWidget::clear() {
 void PadWidget::pad(int size) {
     m_pad = size;
     if (m_widget) m_widget->move(m_pad, m_pad);
+    this->invalidateLayout();
     this->update();
 }
 
@@ -97,12 +102,20 @@ void PadWidget::updateSize(HDC hdc, SIZE available) {
     this->resize(size.Width + m_pad * 2, size.Height + m_pad * 2);
 }
 
+void PadWidget::collectText(std::vector<TextQuery>& queries, SIZE available) {
+    if (!m_widget) return;
+    available.cx -= m_pad;
+    available.cy -= m_pad;
+    Widget::collectText(queries, available);
+}
+
 void Layout::updateSize(HDC hdc, SIZE available) {
     Widget::updateSize(hdc, available);
 }
 
 void Layout::pad(int p) {
     m_pad = p;
+    this->invalidateLayout();
     this->update();
 }
 
@@ -113,8 +126,9 @@ HorizontalLayout::HorizontalLayout() {
 }
 
 void HorizontalLayout::add(Widget* child, HorizontalLayout::Align alignment) {
-    m_alignments[child] = alignment;
+    m_alignments[child->handle()] = alignment;
     this->add(child);
+    this->invalidateLayout();
 }
 
 void HorizontalLayout::add(Widget* child) {
@@ -122,25 +136,41 @@ void HorizontalLayout::add(Widget* child) {
 }
 
 void HorizontalLayout::remove(Widget* child, bool release) {
-    m_alignments.erase(child);
+    m_alignments.erase(child->handle());
     Widget::remove(child, release);
 }
 
 void HorizontalLayout::fill(bool on) {
     m_fill = on;
+    this->invalidateLayout();
     this->update();
 }
 
 void HorizontalLayout::invert(bool on) {
     m_inverted = on;
+    this->invalidateLayout();
     this->update();
 }
 
 void HorizontalLayout::align(Align defaultAlign) {
     m_defaultAlign = defaultAlign;
+    this->invalidateLayout();
     this->update();
 }
 
+void HorizontalLayout::collectText(std::vector<TextQuery>& queries, SIZE available) {
+    // each child gets what the ones before it leave over, and the ones
+    // that are about to be measured again can only be guessed at by
+    // what they took last time
+    for (auto& child : m_children) {
+        if (!child->visible()) continue;
+        auto pad = dynamic_cast<Pad*>(child);
+        if (pad && pad->doesExpand()) continue;
+        Widget::collectChildText(child, queries, available);
+        available.cx -= child->width() + m_pad;
+    }
+}
+
 void HorizontalLayout::updateSize(HDC hdc, SIZE available) {
     int widths = 0;
     int height = 0;
@@ -150,7 +180,7 @@ void HorizontalLayout::updateSize(HDC hdc, SIZE available) {
         if (!child->visible()) continue;
         auto pad = dynamic_cast<Pad*>(child);
         if (!pad || !pad->doesExpand()) {
-            child->updateSize(hdc, available);
+            child->measure(hdc, available);
             available.cx -= child->width() + m_pad;
             widths += child->width() + m_pad;
             if (!pad && child->height() > height) {
@@ -161,28 +191,36 @@ void HorizontalLayout::updateSize(HDC hdc, SIZE available) {
         }
     }
     widths -= m_pad;
+    m_fixedSize = widths;
+    m_expanders = pads;
     if (m_autoresize) {
-        m_width = availableWidth;
-        m_height = m_fill ? available.cy : height;
+        this->storeSize(availableWidth, m_fill ? available.cy : height);
     }
+}
+
+void HorizontalLayout::updateLayout() {
+    auto widths = m_fixedSize;
+    auto pads = m_expanders;
     int pos = 0;
-    auto arr = m_inverted ? reverse(m_children) : m_children;
-    for (auto& child : arr) {
+    auto count = m_children.size();
+    for (size_t i = 0; i < count; i++) {
+        // walked back to front when inverted rather than copied reversed
+        auto child = m_children[m_inverted ? count - 1 - i : i];
         if (!child->visible()) continue;
         auto ypos = 0;
         auto alignment = m_defaultAlign;
-        if (m_alignments.count(child)) {
-            alignment = m_alignments[child];
+        if (m_alignments.count(child->handle())) {
+            alignment = m_alignments[child->handle()];
         }
         switch (alignment) {
             case Align::Start: ypos = 0; break;
-            case Align::Middle: ypos = (m_height - child->height()) / 2; break;
-            case Align::End: ypos = m_height - child->height(); break;
+            case Align::Middle: ypos = (this->height() - child->height()) / 2; break;
+            case Align::End: ypos = this->height() - child->height(); break;
         }
         child->move(pos, ypos);
         auto pad = dynamic_cast<Pad*>(child);
         if (pad && pad->doesExpand()) {
-            pad->resize((m_width - widths) / pads);
+            pad->resize((this->width() - widths) / pads);
         }
         pos += child->width() + m_pad;
     }
@@ -195,8 +233,9 @@ VerticalLayout::VerticalLayout() {
 }
 
 void VerticalLayout::add(Widget* child, VerticalLayout::Align alignment) {
-    m_alignments[child] = alignment;
+    m_alignments[child->handle()] = alignment;
     this->add(child);
+    this->invalidateLayout();
 }
 
 void VerticalLayout::add(Widget* child) {
@@ -204,25 +243,41 @@ void VerticalLayout::add(Widget* child) {
 }
 
 void VerticalLayout::remove(Widget* child, bool release) {
-    m_alignments.erase(child);
+    m_alignments.erase(child->handle());
     Widget::remove(child, release);
 }
 
 void VerticalLayout::fill(bool on) {
     m_fill = on;
+    this->invalidateLayout();
     this->update();
 }
 
 void VerticalLayout::invert(bool on) {
     m_inverted = on;
+    this->invalidateLayout();
     this->update();
 }
 
 void VerticalLayout::align(Align defaultAlign) {
     m_defaultAlign = defaultAlign;
+    this->invalidateLayout();
     this->update();
 }
 
+void VerticalLayout::collectText(std::vector<TextQuery>& queries, SIZE available) {
+    // each child gets what the ones before it leave over, and the ones
+    // that are about to be measured again can only be guessed at by
+    // what they took last time
+    for (auto& child : m_children) {
+        if (!child->visible()) continue;
+        auto pad = dynamic_cast<Pad*>(child);
+        if (pad && pad->doesExpand()) continue;
+        Widget::collectChildText(child, queries, available);
+        available.cy -= child->height() + m_pad;
+    }
+}
+
 void VerticalLayout::updateSize(HDC hdc, SIZE available) {
     int heights = 0;
     int width = 0;
@@ -232,7 +287,7 @@ void VerticalLayout::updateSize(HDC hdc, SIZE available) {
         if (!child->visible()) continue;
         auto pad = dynamic_cast<Pad*>(child);
         if (!pad || !pad->doesExpand()) {
-            child->updateSize(hdc, available);
+            child->measure(hdc, available);
             available.cy -= child->height() + m_pad;
             heights += child->height() + m_pad;
             if (!pad && child->width() > width) {
@@ -243,33 +298,527 @@ void VerticalLayout::updateSize(HDC hdc, SIZE available) {
         }
     }
     heights -= m_pad;
+    m_fixedSize = heights;
+    m_expanders = pads;
     if (m_autoresize) {
-        m_width = m_fill ? available.cx : width;
-        m_height = availableHeight;
+        this->storeSize(m_fill ? available.cx : width, availableHeight);
     }
+}
+
+void VerticalLayout::updateLayout() {
+    auto heights = m_fixedSize;
+    auto pads = m_expanders;
     int pos = 0;
-    auto arr = m_inverted ? reverse(m_children) : m_children;
-    for (auto& child : arr) {
+    auto count = m_children.size();
+    for (size_t i = 0; i < count; i++) {
+        auto child = m_children[m_inverted ? count - 1 - i : i];
         if (!child->visible()) continue;
         auto xpos = 0;
         auto alignment = m_defaultAlign;
-        if (m_alignments.count(child)) {
-            alignment = m_alignments[child];
+        if (m_alignments.count(child->handle())) {
+            alignment = m_alignments[child->handle()];
         }
         switch (alignment) {
             case Align::Start: xpos = 0; break;
-            case Align::Middle: xpos = (m_width - child->width()) / 2; break;
-            case Align::End: xpos = m_width - child->width(); break;
+            case Align::Middle: xpos = (this->width() - child->width()) / 2; break;
+            case Align::End: xpos = this->width() - child->width(); break;
         }
         child->move(xpos, pos);
         auto pad = dynamic_cast<Pad*>(child);
         if (pad && pad->doesExpand()) {
-            pad->resize((m_height - heights) / pads);
+            pad->resize((this->height() - heights) / pads);
         }
         pos += child->height() + m_pad;
     }
 }
 
+FlexLayout::FlexLayout(Direction direction) {
+    m_typeName = "FlexLayout";
+    m_direction = direction;
+    this->autoResize();
+    this->show();
+}
+
+void FlexLayout::direction(Direction direction) {
+    m_direction = direction;
+    this->invalidateLayout();
+    this->update();
+}
+
+void FlexLayout::align(Align align) {
+    // Auto only means something for items
+    m_align = align == Align::Auto ? Align::Start : align;
+    this->invalidateLayout();
+    this->update();
+}
+
+void FlexLayout::justify(Justify justify) {
+    m_justify = justify;
+    this->invalidateLayout();
+    this->update();
+}
+
+void FlexLayout::wrap(bool on) {
+    m_wrap = on;
+    this->invalidateLayout();
+    this->update();
+}
+
+void FlexLayout::gap(int gap) {
+    this->pad(gap);
+}
+
+void FlexLayout::add(Widget* child) {
+    this->add(child, Item());
+}
+
+void FlexLayout::add(Widget* child, Item const& item) {
+    if (child->getParent()) return;
+    m_slots.push_back({ child, item });
+    Widget::add(child);
+}
+
+void FlexLayout::item(Widget* child, Item const& item) {
+    for (auto& slot : m_slots) {
+        if (slot.m_widget == child) {
+            slot.m_item = item;
+            this->invalidateLayout();
+            this->update();
+            return;
+        }
+    }
+}
+
+void FlexLayout::remove(Widget* child, bool release) {
+    m_slots.erase(
+        std::remove_if(m_slots.begin(), m_slots.end(), [child](Slot const& slot) {
+            return slot.m_widget == child;
+        }),
+        m_slots.end()
+    );
+    Widget::remove(child, release);
+}
+
+void FlexLayout::clear() {
+    m_slots.clear();
+    m_lines.clear();
+    Widget::clear();
+}
+
+void FlexLayout::collectText(std::vector<TextQuery>& queries, SIZE available) {
+    // the size children are first measured in, the ones that grow or
+    // shrink are measured again once their share is known
+    if (!m_autoresize) {
+        available = { this->width(), this->height() };
+    }
+    for (auto& slot : m_slots) {
+        Widget::collectChildText(slot.m_widget, queries, available);
+    }
+}
+
+void FlexLayout::updateSize(HDC hdc, SIZE available) {
+    auto row = m_direction == Direction::Row;
+    if (!m_autoresize) {
+        available = { this->width(), this->height() };
+    }
+    auto mainSize = row ? available.cx : available.cy;
+    auto crossSize = row ? available.cy : available.cx;
+
+    m_lines.clear();
+    Line line;
+    for (size_t i = 0; i < m_slots.size(); i++) {
+        auto& slot = m_slots[i];
+        auto child = slot.m_widget;
+        if (!child->visible()) continue;
+        child->measure(hdc, available);
+        auto measured = row ? child->width() : child->height();
+        slot.m_base = slot.m_item.m_basis >= 0 ? slot.m_item.m_basis : measured;
+        slot.m_cross = row ? child->height() : child->width();
+        if (m_wrap && line.m_count && line.m_main + m_pad + slot.m_base > mainSize) {
+            m_lines.push_back(line);
+            line = Line();
+        }
+        if (line.m_count) {
+            line.m_main += m_pad;
+        } else {
+            line.m_first = i;
+        }
+        line.m_main += slot.m_base;
+        line.m_end = i + 1;
+        line.m_count++;
+    }
+    if (line.m_count) {
+        m_lines.push_back(line);
+    }
+
+    int cross = 0;
+    for (auto& l : m_lines) {
+        this->resolveLine(hdc, l, mainSize, crossSize);
+        cross += l.m_cross + m_pad;
+    }
+    if (m_lines.size()) {
+        cross -= m_pad;
+    }
+    if (m_autoresize) {
+        if (row) {
+            this->storeSize(mainSize, cross);
+        } else {
+            this->storeSize(cross, mainSize);
+        }
+    }
+}
+
+void FlexLayout::resolveLine(HDC hdc, Line& line, int mainSize, int crossSize) {
+    auto row = m_direction == Direction::Row;
+    auto free = mainSize - line.m_main;
+    auto weight = [free](Slot const& slot) {
+        // shrinking is weighted by size so small children don't vanish first
+        return free > 0 ? slot.m_item.m_grow : slot.m_item.m_shrink * slot.m_base;
+    };
+    float weights = 0.f;
+    for (auto i = line.m_first; i < line.m_end; i++) {
+        if (m_slots[i].m_widget->visible()) {
+            weights += weight(m_slots[i]);
+        }
+    }
+
+    // shares are handed out as a running total so that
+    // rounding them doesn't leave a gap at the end
+    float share = 0.f;
+    int given = 0;
+    line.m_main = 0;
+    line.m_cross = 0;
+    for (auto i = line.m_first; i < line.m_end; i++) {
+        auto& slot = m_slots[i];
+        auto child = slot.m_widget;
+        if (!child->visible()) continue;
+        auto main = slot.m_base;
+        if (free != 0 && weights > 0.f) {
+            share += free * weight(slot) / weights;
+            auto rounded = static_cast<int>(std::lround(share));
+            main += rounded - given;
+            given = rounded;
+        }
+        slot.m_main = std::max(main, 0);
+        if (slot.m_main != (row ? child->width() : child->height())) {
+            // let the child fit its contents to the size it's getting
+            child->measure(hdc, row ? SIZE { slot.m_main, crossSize } : SIZE { crossSize, slot.m_main });
+            slot.m_cross = row ? child->height() : child->width();
+        }
+        line.m_main += slot.m_main + m_pad;
+        line.m_cross = std::max(line.m_cross, slot.m_cross);
+    }
+    line.m_main -= m_pad;
+    // a single line of a fixed size layout takes up all of it
+    if (!m_autoresize && !m_wrap) {
+        line.m_cross = crossSize;
+    }
+
+    for (auto i = line.m_first; i < line.m_end; i++) {
+        auto& slot = m_slots[i];
+        if (!slot.m_widget->visible()) continue;
+        auto align = slot.m_item.m_align == Align::Auto ? m_align : slot.m_item.m_align;
+        if (align == Align::Stretch) {
+            slot.m_cross = line.m_cross;
+        }
+        if (row) {
+            Widget::assignSize(slot.m_widget, slot.m_main, slot.m_cross);
+        } else {
+            Widget::assignSize(slot.m_widget, slot.m_cross, slot.m_main);
+        }
+    }
+}
+
+void FlexLayout::updateLayout() {
+    auto row = m_direction == Direction::Row;
+    auto mainSize = row ? this->width() : this->height();
+    int crossPos = 0;
+    for (auto& line : m_lines) {
+        auto free = static_cast<float>(std::max(mainSize - line.m_main, 0));
+        auto count = static_cast<float>(line.m_count);
+        float pos = 0.f;
+        float extra = 0.f;
+        switch (m_justify) {
+            case Justify::Start: break;
+            case Justify::Center: pos = free / 2; break;
+            case Justify::End: pos = free; break;
+            case Justify::SpaceBetween: {
+                if (line.m_count > 1) extra = free / (count - 1);
+            } break;
+            case Justify::SpaceAround: {
+                extra = free / count;
+                pos = extra / 2;
+            } break;
+        }
+        for (auto i = line.m_first; i < line.m_end; i++) {
+            auto& slot = m_slots[i];
+            auto child = slot.m_widget;
+            if (!child->visible()) continue;
+            auto align = slot.m_item.m_align == Align::Auto ? m_align : slot.m_item.m_align;
+            auto offset = 0;
+            switch (align) {
+                case Align::Center: offset = (line.m_cross - slot.m_cross) / 2; break;
+                case Align::End: offset = line.m_cross - slot.m_cross; break;
+                default: break;
+            }
+            auto main = static_cast<int>(std::lround(pos));
+            if (row) {
+                child->move(main, crossPos + offset);
+            } else {
+                child->move(crossPos + offset, main);
+            }
+            pos += slot.m_main + m_pad + extra;
+        }
+        crossPos += line.m_cross + m_pad;
+    }
+}
+
+GridLayout::Track GridLayout::Track::fixed(int size) {
+    return { Type::Fixed, static_cast<float>(size) };
+}
+
+GridLayout::Track GridLayout::Track::content() {
+    return { Type::Auto, 0.f };
+}
+
+GridLayout::Track GridLayout::Track::fraction(float share) {
+    return { Type::Fraction, share };
+}
+
+GridLayout::GridLayout() {
+    m_typeName = "GridLayout";
+    this->autoResize();
+    this->show();
+}
+
+void GridLayout::columns(std::vector<Track> const& columns) {
+    m_columns = columns;
+    m_tracksDirty = true;
+    this->invalidateLayout();
+    this->update();
+}
+
+void GridLayout::rows(std::vector<Track> const& rows) {
+    m_rows = rows;
+    m_tracksDirty = true;
+    this->invalidateLayout();
+    this->update();
+}
+
+void GridLayout::add(Widget* child) {
+    size_t row = 0;
+    size_t column = 0;
+    if (m_cells.size()) {
+        auto& last = m_cells.back();
+        row = last.m_row;
+        column = last.m_column + last.m_columnSpan;
+        if (column >= std::max<size_t>(m_columns.size(), 1)) {
+            row += last.m_rowSpan;
+            column = 0;
+        }
+    }
+    this->add(child, row, column);
+}
+
+void GridLayout::add(Widget* child, size_t row, size_t column, size_t rowSpan, size_t columnSpan) {
+    if (child->getParent()) return;
+    m_cells.push_back({
+        child, row, column, std::max<size_t>(rowSpan, 1), std::max<size_t>(columnSpan, 1)
+    });
+    m_tracksDirty = true;
+    Widget::add(child);
+}
+
+void GridLayout::remove(Widget* child, bool release) {
+    m_cells.erase(
+        std::remove_if(m_cells.begin(), m_cells.end(), [child](Cell const& cell) {
+            return cell.m_widget == child;
+        }),
+        m_cells.end()
+    );
+    m_tracksDirty = true;
+    Widget::remove(child, release);
+}
+
+void GridLayout::clear() {
+    m_cells.clear();
+    m_tracksDirty = true;
+    Widget::clear();
+}
+
+size_t GridLayout::trackSolves() const {
+    return m_solves;
+}
+
+void GridLayout::solve(
+    std::vector<Track> const& tracks, bool columns, int available,
+    std::vector<int>& sizes, std::vector<int>& positions
+) {
+    auto start = [columns](Cell const& cell) { return columns ? cell.m_column : cell.m_row; };
+    auto span = [columns](Cell const& cell) { return columns ? cell.m_columnSpan : cell.m_rowSpan; };
+    auto natural = [columns](Cell const& cell) { return columns ? cell.m_width : cell.m_height; };
+
+    auto count = tracks.size();
+    for (auto& cell : m_cells) {
+        count = std::max(count, start(cell) + span(cell));
+    }
+    auto type = [&tracks](size_t i) {
+        return i < tracks.size() ? tracks[i].m_type : Track::Auto;
+    };
+    sizes.assign(count, 0);
+    positions.assign(count, 0);
+
+    float fractions = 0.f;
+    for (size_t i = 0; i < tracks.size(); i++) {
+        switch (tracks[i].m_type) {
+            case Track::Fixed: sizes[i] = static_cast<int>(tracks[i].m_value); break;
+            case Track::Fraction: fractions += tracks[i].m_value; break;
+            default: break;
+        }
+    }
+    for (auto& cell : m_cells) {
+        if (natural(cell) < 0 || span(cell) != 1) continue;
+        auto i = start(cell);
+        if (type(i) == Track::Auto) {
+            sizes[i] = std::max(sizes[i], natural(cell));
+        }
+    }
+    // cells spanning several tracks make room for themselves
+    // by growing the auto ones among them evenly
+    for (auto& cell : m_cells) {
+        if (natural(cell) < 0 || span(cell) == 1) continue;
+        auto used = static_cast<int>(span(cell) - 1) * m_pad;
+        size_t autos = 0;
+        for (auto i = start(cell); i < start(cell) + span(cell); i++) {
+            used += sizes[i];
+            if (type(i) == Track::Auto) autos++;
+        }
+        auto missing = natural(cell) - used;
+        if (missing <= 0 || !autos) continue;
+        for (auto i = start(cell); i < start(cell) + span(cell); i++) {
+            if (type(i) != Track::Auto) continue;
+            auto share = missing / static_cast<int>(autos--);
+            sizes[i] += share;
+            missing -= share;
+        }
+    }
+
+    if (fractions > 0.f) {
+        auto left = available - static_cast<int>(count - 1) * m_pad;
+        for (size_t i = 0; i < count; i++) {
+            if (type(i) != Track::Fraction) left -= sizes[i];
+        }
+        left = std::max(left, 0);
+        // handed out as a running total so rounding doesn't leave a gap
+        float share = 0.f;
+        int given = 0;
+        for (size_t i = 0; i < tracks.size(); i++) {
+            if (tracks[i].m_type != Track::Fraction) continue;
+            share += left * tracks[i].m_value / fractions;
+            auto rounded = static_cast<int>(std::lround(share));
+            sizes[i] = rounded - given;
+            given = rounded;
+        }
+    }
+
+    int pos = 0;
+    for (size_t i = 0; i < count; i++) {
+        positions[i] = pos;
+        pos += sizes[i] + m_pad;
+    }
+}
+
+SIZE GridLayout::cellSize(Cell const& cell) const {
+    SIZE size = {
+        static_cast<LONG>(cell.m_columnSpan - 1) * m_pad,
+        static_cast<LONG>(cell.m_rowSpan - 1) * m_pad,
+    };
+    for (auto i = cell.m_column; i < cell.m_column + cell.m_columnSpan; i++) {
+        size.cx += m_columnSizes[i];
+    }
+    for (auto i = cell.m_row; i < cell.m_row + cell.m_rowSpan; i++) {
+        size.cy += m_rowSizes[i];
+    }
+    return size;
+}
+
+void GridLayout::collectText(std::vector<TextQuery>& queries, SIZE available) {
+    if (!m_autoresize) {
+        available = { this->width(), this->height() };
+    }
+    for (auto& cell : m_cells) {
+        Widget::collectChildText(cell.m_widget, queries, available);
+    }
+}
+
+void GridLayout::updateSize(HDC hdc, SIZE available) {
+    if (!m_autoresize) {
+        available = { this->width(), this->height() };
+    }
+    for (auto& cell : m_cells) {
+        auto child = cell.m_widget;
+        if (!child->visible()) {
+            if (cell.m_width >= 0) {
+                cell.m_width = cell.m_height = -1;
+                m_tracksDirty = true;
+            }
+            continue;
+        }
+        // a child that didn't need measuring still has the size of
+        // its cell, so its own size is only read when it was measured
+        if (child->measure(hdc, available) || cell.m_width < 0) {
+            if (child->width() != cell.m_width || child->height() != cell.m_height) {
+                cell.m_width = child->width();
+                cell.m_height = child->height();
+                m_tracksDirty = true;
+            }
+        }
+    }
+    if (
+        available.cx != m_solvedFor.cx ||
+        available.cy != m_solvedFor.cy ||
+        m_pad != m_solvedPad
+    ) {
+        m_tracksDirty = true;
+    }
+    if (m_tracksDirty) {
+        this->solve(m_columns, true, available.cx, m_columnSizes, m_columnPos);
+        this->solve(m_rows, false, available.cy, m_rowSizes, m_rowPos);
+        m_solvedFor = available;
+        m_solvedPad = m_pad;
+        m_tracksDirty = false;
+        m_solves++;
+    }
+
+    for (auto& cell : m_cells) {
+        auto child = cell.m_widget;
+        if (!child->visible()) continue;
+        auto size = this->cellSize(cell);
+        if (child->width() != size.cx || child->height() != size.cy) {
+            // let the child fit its contents to the cell before stretching it
+            child->measure(hdc, size);
+            Widget::assignSize(child, size.cx, size.cy);
+        }
+    }
+
+    if (m_autoresize) {
+        auto extent = [](std::vector<int> const& sizes, std::vector<int> const& positions) {
+            return sizes.empty() ? 0 : positions.back() + sizes.back();
+        };
+        this->storeSize(
+            extent(m_columnSizes, m_columnPos),
+            extent(m_rowSizes, m_rowPos)
+        );
+    }
+}
+
+void GridLayout::updateLayout() {
+    for (auto& cell : m_cells) {
+        if (!cell.m_widget->visible()) continue;
+        cell.m_widget->move(m_columnPos[cell.m_column], m_rowPos[cell.m_row]);
+    }
+}
+
 ResizeGrip::ResizeGrip(SplitLayout* l) {
     m_typeName = "ResizeGrip";
     m_layout = l;
@@ -278,6 +827,7 @@ ResizeGrip::ResizeGrip(SplitLayout* l) {
 
 void ResizeGrip::direct(bool horizontal) {
     m_horizontal = horizontal;
+    m_layout->invalidateLayout();
     this->update();
 }
 
@@ -305,7 +855,7 @@ void ResizeGrip::mouseDown(int x, int y) {
     this->captureMouse();
     m_layout->grow();
     m_mousestart = { x, y };
-    m_pos = m_x + s_size;
+    m_pos = this->x() + s_size;
     this->update();
 }
 
@@ -321,7 +871,7 @@ void ResizeGrip::mouseDoubleClick(int x, int y) {
 }
 
 void ResizeGrip::mouseMove(int x, int y) {
-    if (Widget::s_capturingWidget != this) return;
+    if (!m_window || m_window->capturingWidget() != this) return;
     if (m_mousedown) {
         if (m_horizontal) {
             m_moved = x - m_mousestart.x;
@@ -330,35 +880,28 @@ void ResizeGrip::mouseMove(int x, int y) {
             m_moved = y - m_mousestart.y;
             m_layout->m_split = m_pos + m_moved;
         }
+        m_layout->invalidateLayout();
         this->update();
     } else {
         this->releaseMouse();
     }
 }
 
-void ResizeGrip::paint(HDC hdc, PAINTSTRUCT* ps) {
+void ResizeGrip::paint(Canvas& canvas) {
     if (m_layout->m_collapsed && m_hovered) {
-        Graphics g(hdc);
-        InitGraphics(g);
-
-        SolidBrush brush(Style::hover());
-        g.FillRectangle(&brush, toRectF(this->rect()));
-
+        canvas.fillRect(toRectF(this->rect()), Style::hover());
         return;
     }
     if (!m_paintLine || m_layout->m_collapsed) return;
-    Graphics g(hdc);
-    InitGraphics(g);
     auto r = this->rect();
-    SolidBrush brush(Style::separator());
     if (m_horizontal) {
         r.X += r.Width / 2;
         r.Width = 1_px;
-        g.FillRectangle(&brush, toRectF(r));
+        canvas.fillRect(toRectF(r), Style::separator());
     } else {
         r.Y += r.Height / 2;
         r.Height = 1_px;
-        g.FillRectangle(&brush, toRectF(r));
+        canvas.fillRect(toRectF(r), Style::separator());
     }
 }
 
@@ -377,6 +920,7 @@ SplitLayout::SplitLayout() {
 void SplitLayout::setDirection(bool h) {
     m_horizontal = h;
     m_separator->direct(h);
+    this->invalidateLayout();
     this->update();
 }
 
@@ -402,39 +946,74 @@ Widget* SplitLayout::second() const {
 
 void SplitLayout::moveSplit(int split) {
     m_split = split;
+    this->invalidateLayout();
     this->update();
 }
 
 void SplitLayout::collapseFirst(bool first) {
     m_collapseFirst = first;
+    this->invalidateLayout();
 }
 
 void SplitLayout::hideSeparatorLine() {
     m_separator->hideLine();
 }
 
-void SplitLayout::paint(HDC hdc, PAINTSTRUCT* ps) {
-    if (!(m_collapsed && m_collapseFirst))  m_first->paint(hdc, ps);
-    if (!(m_collapsed && !m_collapseFirst)) m_second->paint(hdc, ps);
-    m_separator->paint(hdc, ps);
+void SplitLayout::paint(Canvas& canvas) {
+    if (!(m_collapsed && m_collapseFirst))  this->paintChild(m_first, canvas);
+    if (!(m_collapsed && !m_collapseFirst)) this->paintChild(m_second, canvas);
+    this->paintChild(m_separator, canvas);
+}
+
+int SplitLayout::splitFor(SIZE size) const {
+    auto split = m_split;
+    if (!split) {
+        split = m_horizontal ? size.cx / 2 : size.cy / 2;
+    }
+    if (m_min && split < m_min) split = m_min;
+    if (m_max && split > m_max) split = m_max;
+    return split;
+}
+
+void SplitLayout::sideSizes(SIZE size, SIZE& first, SIZE& second) const {
+    auto split = this->splitFor(size);
+    auto asplit = m_collapsed ? (m_collapseFirst ? 0 : this->width()) : split;
+    first = size;
+    second = size;
+    if (m_horizontal) {
+        first.cx = asplit;
+        second.cx = size.cx - asplit;
+    } else {
+        first.cy = asplit;
+        second.cy = size.cy - asplit;
+    }
+}
+
+void SplitLayout::collectText(std::vector<TextQuery>& queries, SIZE size) {
+    if (!m_first || !m_second) return;
+    SIZE fsize, ssize;
+    this->sideSizes(size, fsize, ssize);
+    Widget::collectChildText(m_first, queries, fsize);
+    Widget::collectChildText(m_second, queries, ssize);
 }
 
 void SplitLayout::updateSize(HDC hdc, SIZE size) {
     if (!m_first || !m_second) return;
-    if (!m_split) {
-        m_split = m_horizontal ? size.cx / 2 : size.cy / 2;
-    }
-    if (m_min && m_split < m_min) m_split = m_min;
-    if (m_max && m_split > m_max) m_split = m_max;
-    auto asplit = m_collapsed ? (m_collapseFirst ? 0 : m_width) : m_split;
-    auto fsize = size;
-    auto ssize = size;
+    m_split = this->splitFor(size);
+    SIZE fsize, ssize;
+    this->sideSizes(size, fsize, ssize);
+    m_first->measure(hdc, fsize);
+    m_second->measure(hdc, ssize);
+}
+
+void SplitLayout::updateLayout() {
+    if (!m_first || !m_second) return;
+    auto size = m_lastAvailable;
+    auto asplit = m_collapsed ? (m_collapseFirst ? 0 : this->width()) : m_split;
     POINT spos;
     POINT seppos;
     SIZE sepsize;
     if (m_horizontal) {
-        fsize.cx = asplit;
-        ssize.cx = size.cx - asplit;
         spos.x = asplit;
         spos.y = 0;
         seppos.x = asplit - ResizeGrip::s_size;
@@ -443,8 +1022,6 @@ void SplitLayout::updateSize(HDC hdc, SIZE size) {
         if (m_collapsed) sepsize.cx *= 2;
         sepsize.cy = size.cy;
     } else {
-        fsize.cy = asplit;
-        ssize.cy = size.cy - asplit;
         spos.x = 0;
         spos.y = asplit;
         seppos.x = 0;
@@ -453,8 +1030,6 @@ void SplitLayout::updateSize(HDC hdc, SIZE size) {
         sepsize.cy = ResizeGrip::s_size * 2;
         if (m_collapsed) sepsize.cy *= 2;
     }
-    m_first->updateSize(hdc, fsize);
-    m_second->updateSize(hdc, ssize);
     m_second->move(spos.x, spos.y);
     m_separator->move(seppos.x, seppos.y);
     m_separator->resize(sepsize.cx, sepsize.cy);
@@ -463,19 +1038,25 @@ void SplitLayout::updateSize(HDC hdc, SIZE size) {
 void SplitLayout::min(int m) {
     m_min = m;
     if (m_min && m_split < m_min) m_split = m_min;
+    this->invalidateLayout();
 }
 
 void SplitLayout::max(int m) {
     m_max = m;
     if (m_max && m_split > m_max) m_split = m_max;
+    this->invalidateLayout();
 }
 
 void SplitLayout::collapse() {
     m_collapsed = true;
+    this->invalidateLayout();
+    m_separator->update();
     this->update();
 }
 
 void SplitLayout::grow() {
     m_collapsed = false;
+    this->invalidateLayout();
+    m_separator->update();
     this->update();
 }
@@ -23,6 +23,8 @@ protected:
     int m_pad = 0;
     Widget* m_widget = nullptr;
 
+    void collectText(std::vector<TextQuery>& queries, SIZE available) override;
+
 public:
     PadWidget(int size, Widget* widget);
     PadWidget(int size);
@@ -61,7 +63,11 @@ protected:
     bool m_fill = false;
     bool m_inverted = false;
     Align m_defaultAlign = Align::Start;
-    std::unordered_map<Widget*, Align> m_alignments;
+    std::unordered_map<SlotHandle, Align> m_alignments;
+    int m_fixedSize = 0;
+    int m_expanders = 0;
+
+    void collectText(std::vector<TextQuery>& queries, SIZE available) override;
 
 public:
     HorizontalLayout();
@@ -70,6 +76,7 @@ public:
     void invert(bool on = true);
     void align(Align defaultAlign);
     void updateSize(HDC, SIZE) override;
+    void updateLayout() override;
     void add(Widget* child) override;
     void add(Widget* child, Align alignment);
     void remove(Widget* child, bool release = true) override;
@@ -87,7 +94,11 @@ protected:
     bool m_fill = false;
     bool m_inverted = false;
     Align m_defaultAlign = Align::Start;
-    std::unordered_map<Widget*, Align> m_alignments;
+    std::unordered_map<SlotHandle, Align> m_alignments;
+    int m_fixedSize = 0;
+    int m_expanders = 0;
+
+    void collectText(std::vector<TextQuery>& queries, SIZE available) override;
 
 public:
     VerticalLayout();
@@ -96,11 +107,167 @@ public:
     void invert(bool on = true);
     void align(Align defaultAlign);
     void updateSize(HDC, SIZE) override;
+    void updateLayout() override;
     void add(Widget* child) override;
     void add(Widget* child, Align alignment);
     void remove(Widget* child, bool release = true) override;
 };
 
+// Lays children out in a row or column like CSS flexbox. What each
+// child does is kept in its slot next to it instead of being looked
+// up, and sizes are worked out in updateSize so that updateLayout only
+// has to move things into place. m_pad is the gap between children
+// and between lines
+class FlexLayout : public Layout {
+public:
+    enum class Direction {
+        Row,
+        Column,
+    };
+    enum class Align {
+        // for items, whatever the layout's align is
+        Auto,
+        Start,
+        Center,
+        End,
+        Stretch,
+    };
+    enum class Justify {
+        Start,
+        Center,
+        End,
+        SpaceBetween,
+        SpaceAround,
+    };
+
+    struct Item {
+        // share of the free space taken, or given up if there isn't enough
+        float m_grow = 0.f;
+        float m_shrink = 1.f;
+        // size along the main axis before growing or
+        // shrinking, -1 for the child's measured size
+        int m_basis = -1;
+        Align m_align = Align::Auto;
+    };
+
+protected:
+    struct Slot {
+        Widget* m_widget;
+        Item m_item;
+        int m_base = 0;
+        int m_main = 0;
+        int m_cross = 0;
+    };
+    struct Line {
+        // slots [m_first, m_end), some of which may be hidden
+        size_t m_first = 0;
+        size_t m_end = 0;
+        size_t m_count = 0;
+        int m_main = 0;
+        int m_cross = 0;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<Line> m_lines;
+    Direction m_direction = Direction::Row;
+    Align m_align = Align::Start;
+    Justify m_justify = Justify::Start;
+    bool m_wrap = false;
+
+    void resolveLine(HDC hdc, Line& line, int main, int cross);
+    void collectText(std::vector<TextQuery>& queries, SIZE available) override;
+
+public:
+    FlexLayout(Direction direction = Direction::Row);
+
+    void direction(Direction direction);
+    void align(Align align);
+    void justify(Justify justify);
+    void wrap(bool on = true);
+    void gap(int gap);
+
+    void add(Widget* child) override;
+    void add(Widget* child, Item const& item);
+    void item(Widget* child, Item const& item);
+    void remove(Widget* child, bool release = true) override;
+    void clear() override;
+
+    void updateSize(HDC, SIZE) override;
+    void updateLayout() override;
+};
+
+// Lays children out in cells of a grid whose columns and rows are
+// each a fixed number of pixels, sized to fit their contents or a
+// share of the space that's left. Track sizes are kept from one
+// layout pass to the next, and only worked out again when a cell
+// measures differently or the tracks or space available change
+class GridLayout : public Layout {
+public:
+    struct Track {
+        enum Type {
+            Fixed,
+            Auto,
+            Fraction,
+        };
+        Type m_type = Type::Auto;
+        float m_value = 0.f;
+
+        static Track fixed(int size);
+        static Track content();
+        static Track fraction(float share = 1.f);
+    };
+
+protected:
+    struct Cell {
+        Widget* m_widget;
+        size_t m_row;
+        size_t m_column;
+        size_t m_rowSpan;
+        size_t m_columnSpan;
+        // size measured with everything available, before stretching to the cell
+        int m_width = -1;
+        int m_height = -1;
+    };
+
+    // rows and columns past the defined ones are auto
+    std::vector<Track> m_columns;
+    std::vector<Track> m_rows;
+    std::vector<Cell> m_cells;
+    std::vector<int> m_columnSizes;
+    std::vector<int> m_rowSizes;
+    std::vector<int> m_columnPos;
+    std::vector<int> m_rowPos;
+    bool m_tracksDirty = true;
+    SIZE m_solvedFor = { -1, -1 };
+    int m_solvedPad = -1;
+    size_t m_solves = 0;
+
+    void solve(
+        std::vector<Track> const& tracks, bool columns, int available,
+        std::vector<int>& sizes, std::vector<int>& positions
+    );
+    SIZE cellSize(Cell const& cell) const;
+    void collectText(std::vector<TextQuery>& queries, SIZE available) override;
+
+public:
+    GridLayout();
+
+    void columns(std::vector<Track> const& columns);
+    void rows(std::vector<Track> const& rows);
+
+    // the cell after the last one added, wrapping at the defined columns
+    void add(Widget* child) override;
+    void add(Widget* child, size_t row, size_t column, size_t rowSpan = 1, size_t columnSpan = 1);
+    void remove(Widget* child, bool release = true) override;
+    void clear() override;
+
+    // how many times the track sizes have been worked out
+    size_t trackSolves() const;
+
+    void updateSize(HDC, SIZE) override;
+    void updateLayout() override;
+};
+
 class SplitLayout;
 
 class ResizeGrip : public Widget {
@@ -132,7 +299,7 @@ public:
     void mouseDoubleClick(int x, int y) override;
     void hideLine();
 
-    void paint(HDC, PAINTSTRUCT*) override;
+    void paint(Canvas&) override;
 };
 
 class SplitLayout : public Layout {
@@ -149,6 +316,11 @@ protected:
 
     friend class ResizeGrip;
 
+    // where the split ends up in size, and what that leaves each side
+    int splitFor(SIZE size) const;
+    void sideSizes(SIZE size, SIZE& first, SIZE& second) const;
+    void collectText(std::vector<TextQuery>& queries, SIZE available) override;
+
 public:
     SplitLayout();
 
@@ -159,7 +331,7 @@ public:
     Widget* second() const;
     void moveSplit(int split);
     void collapseFirst(bool first = true);
-    void paint(HDC, PAINTSTRUCT*) override;
+    void paint(Canvas&) override;
     void hideSeparatorLine();
     void min(int m);
     void max(int m);
@@ -167,4 +339,5 @@ public:
     void grow();
 
     void updateSize(HDC, SIZE) override;
+    void updateLayout() override;
 };
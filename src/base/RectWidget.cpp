@@ -9,6 +9,7 @@ RectWidget::RectWidget() {
 
 void RectWidget::fill(bool b) {
     m_fill = b;
+    this->invalidateLayout();
     this->update();
 }
 
@@ -41,22 +42,21 @@ void RectWidget::updateSize(HDC hdc, SIZE available) {
     }
 }
 
-void RectWidget::paint(HDC hdc, PAINTSTRUCT* ps) {
+void RectWidget::paint(Canvas& canvas) {
     auto r = this->rect();
 
-    Graphics g(hdc);
-    InitGraphics(g);
-
     if (m_cornerRadius) {
-        FillRoundRect(
-            &g, r, m_color, m_cornerRadius / 2, m_cornerRadius
-        );
+        canvas.fillRoundRect(r, m_cornerRadius / 2, m_color);
     } else {
-        SolidBrush brush(m_color);
-        g.FillRectangle(&brush, toRectF(r));
+        canvas.fillRect(toRectF(r), m_color);
     }
     
-    Widget::paint(hdc, ps);
+    Widget::paint(canvas);
+}
+
+bool RectWidget::opaque() const {
+    // rounded corners let whatever's below show through
+    return !m_cornerRadius && m_color.GetA() == 255;
 }
 
 
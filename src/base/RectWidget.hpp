@@ -13,5 +13,6 @@ public:
     void fill(bool = true);
     void cornerRadius(int c);
     void updateSize(HDC, SIZE) override;
-    void paint(HDC, PAINTSTRUCT*) override;
+    void paint(Canvas&) override;
+    bool opaque() const override;
 };
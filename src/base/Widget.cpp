@@ -1,9 +1,123 @@
 #include "Widget.hpp"
 #include <Window.hpp>
+#include <ThreadPool.hpp>
+#include <cassert>
 
-Widget* Widget::s_hoveredWidget = nullptr;
-Widget* Widget::s_capturingWidget = nullptr;
-Widget* Widget::s_keyboardWidget = nullptr;
+// set while a subtree that had its text prefetched is measured,
+// so nothing in it goes through the text again
+static bool g_measuringPrefetched = false;
+
+// GDI+ can't use one DC from several threads at once, so each gets its own
+static HDC measureDC() {
+    struct DC {
+        HDC m_hdc = CreateCompatibleDC(nullptr);
+        ~DC() { DeleteDC(m_hdc); }
+    };
+    thread_local DC dc;
+    return dc.m_hdc;
+}
+
+SlotMap<Widget*>& Widget::handles() {
+    static SlotMap<Widget*> handles;
+    return handles;
+}
+
+Widget::Widget() : m_handle(Widget::handles().insert(this)) {
+    if (!m_handle) {
+        throw std::runtime_error("Out of widget handles");
+    }
+    m_slot = m_handle.value() & SlotMap<Widget*>::s_indexMask;
+    Widget::detached().attach(m_slot);
+}
+
+GeometryStore& Widget::detached() {
+    static GeometryStore store;
+    return store;
+}
+
+GeometryStore& Widget::geometry() const {
+    if (m_root) return const_cast<Window*>(static_cast<Window const*>(this))->m_geometry;
+    if (m_window) return m_window->m_geometry;
+    return Widget::detached();
+}
+
+void* Widget::operator new(size_t size) {
+    return Arena::allocateScoped(size);
+}
+
+void Widget::operator delete(void* ptr, size_t size) {
+    Arena::deallocateScoped(ptr, size);
+}
+
+SlotHandle Widget::handle() const {
+    return m_handle;
+}
+
+Widget* Widget::fromHandle(SlotHandle handle) {
+    auto widget = Widget::handles().get(handle);
+    return widget ? *widget : nullptr;
+}
+
+void Widget::listen(Event::Type type, std::function<void(Event&)> func, bool capture) {
+    m_listeners.push_back({ type, std::move(func), capture });
+}
+
+void Widget::runListeners(Event& event, bool capture) {
+    event.m_current = this;
+    for (auto& listener : m_listeners) {
+        if (listener.m_type == event.m_type && listener.m_capture == capture) {
+            listener.m_func(event);
+        }
+    }
+}
+
+void Widget::handleEvent(Event& event) {
+    auto& p = event.m_point;
+    switch (event.m_type) {
+        case Event::Type::MouseDown: {
+            m_mousedown = true;
+            this->mouseDown(p.X, p.Y);
+            this->update();
+        } break;
+
+        case Event::Type::MouseDoubleClick: {
+            m_mousedown = true;
+            this->mouseDown(p.X, p.Y);
+            this->mouseDoubleClick(p.X, p.Y);
+            this->update();
+        } break;
+
+        case Event::Type::MouseUp: {
+            m_mousedown = false;
+            this->mouseUp(p.X, p.Y);
+            this->update();
+        } break;
+
+        case Event::Type::MouseMove: {
+            // dragged off of and back onto while captured,
+            // which is drawn pressed or not
+            if (event.m_captured && m_mousedown != event.m_down) {
+                m_mousedown = event.m_down;
+                this->update();
+            }
+            this->mouseMove(p.X, p.Y);
+        } break;
+
+        case Event::Type::MouseWheel: {
+            if (this->mouseWheel(event.m_delta)) {
+                event.stopPropagation();
+            }
+        } break;
+
+        case Event::Type::KeyDown: {
+            this->keyDown(event.m_key, event.m_scanCode);
+        } break;
+
+        case Event::Type::KeyUp: {
+            this->keyUp(event.m_key, event.m_scanCode);
+        } break;
+    }
+}
 
 void Widget::userData(void* data) {
     m_userData = data;
@@ -18,31 +132,32 @@ const char* Widget::type() const {
 }
 
 void Widget::captureMouse() {
-    if (!s_capturingWidget) {
-        s_capturingWidget = this;
+    if (m_window && !m_window->capturingWidget()) {
+        m_window->m_capturingWidget = m_handle;
     }
 }
 
 void Widget::releaseMouse() {
-    if (s_capturingWidget == this) {
-        s_capturingWidget = nullptr;
+    if (m_window && m_window->m_capturingWidget == m_handle) {
+        m_window->m_capturingWidget = SlotHandle();
     }
 }
 
 void Widget::captureKeyboard() {
-    if (s_keyboardWidget) {
-        s_keyboardWidget->releaseKeyboard();
+    if (!m_window) return;
+    if (auto keyboard = m_window->keyboardWidget()) {
+        keyboard->releaseKeyboard();
     }
     m_keyboardFocused = true;
-    s_keyboardWidget = this;
+    m_window->m_keyboardWidget = m_handle;
     this->keyboardCaptured(true);
     this->update();
 }
 
 void Widget::releaseKeyboard() {
-    if (s_keyboardWidget == this) {
+    if (m_window && m_window->m_keyboardWidget == m_handle) {
         m_keyboardFocused = false;
-        s_keyboardWidget = nullptr;
+        m_window->m_keyboardWidget = SlotHandle();
         this->keyboardCaptured(false);
     }
     this->update();
@@ -51,22 +166,45 @@ void Widget::releaseKeyboard() {
 void Widget::add(Widget* child) {
     if (!child->m_parent) {
         child->m_parent = this;
-        child->setWindow(m_window);
+        // a window's own m_window is its owner
+        child->setWindow(m_root ? static_cast<Window*>(this) : m_window);
         child->updatePosition();
         this->m_children.push_back(child);
+        child->invalidateHit(true);
+        if (child->m_window) {
+            child->m_window->focusChainInsert(child);
+            child->m_window->indexSubtree(child, true);
+        }
+        this->invalidateLayout();
+        child->update();
     }
 }
 
 void Widget::remove(Widget* child, bool release) {
     for (auto& widget : m_children) {
         if (child == widget) {
+            // an arena's widgets stay in the tree they were built in and
+            // go with it, anything that's moved around has to be on the heap
+            assert(
+                (release || !Arena::ownerOf(child)) &&
+                "widgets built in an arena can't be taken out of their tree"
+            );
+            if (child->m_window) {
+                child->m_window->focusChainRemove(child);
+                child->m_window->unindexSubtree(child);
+            }
             child->m_parent = nullptr;
             if (release) {
                 delete child;
+            } else {
+                child->updatePosition();
+                child->invalidateHit(true);
             }
         }
     }
     m_children.erase(std::remove(m_children.begin(), m_children.end(), child), m_children.end());
+    this->invalidateLayout();
+    this->update();
 }
 
 void Widget::clear() {
@@ -74,25 +212,75 @@ void Widget::clear() {
         delete widget;
     }
     m_children.clear();
+    this->invalidateLayout();
+    this->update();
 }
 
 void Widget::setWindow(Window* window) {
-    m_window = window;
+    if (m_window && m_window != window) {
+        m_window->forgetWidget(this);
+    }
+    if (m_window != window) {
+        auto& from = this->geometry();
+        m_window = window;
+        this->geometry().take(from, m_slot);
+    }
     for (auto& child : m_children) {
         child->setWindow(window);
     }
 }
 
 Point Widget::offset() const {
-    Point p;
-    p.X = m_x;
-    p.Y = m_y;
-    if (m_parent && !dynamic_cast<Window*>(m_parent)) {
-        auto add = m_parent->offset();
-        p.X += add.X;
-        p.Y += add.Y;
+    auto& g = this->geometry();
+    return Point(g.offsetX(m_slot), g.offsetY(m_slot));
+}
+
+bool Widget::paintsBefore(Widget const* a, Widget const* b) {
+    if (a == b) return false;
+    auto depth = [](Widget const* w) -> size_t {
+        size_t d = 0;
+        for (; w->m_parent; w = w->m_parent) d++;
+        return d;
+    };
+    auto da = depth(a);
+    auto db = depth(b);
+    // walk the deeper one up to the same depth, then both up to
+    // just below the ancestor they share
+    auto pa = a;
+    auto pb = b;
+    for (auto d = da; d > db; d--) pa = pa->m_parent;
+    for (auto d = db; d > da; d--) pb = pb->m_parent;
+    // parents paint before their children
+    if (pa == pb) return da < db;
+    while (pa->m_parent != pb->m_parent) {
+        pa = pa->m_parent;
+        pb = pb->m_parent;
     }
-    return p;
+    if (!pa->m_parent) return a < b;
+    auto& siblings = pa->m_parent->m_children;
+    return
+        std::find(siblings.begin(), siblings.end(), pa) <
+        std::find(siblings.begin(), siblings.end(), pb);
+}
+
+bool Widget::validateOffsets() const {
+    Point p(this->x(), this->y());
+    for (auto w = m_parent; w && !w->m_root; w = w->m_parent) {
+        p.X += w->x();
+        p.Y += w->y();
+    }
+    auto offset = this->offset();
+    auto valid = m_root || (p.X == offset.X && p.Y == offset.Y);
+    if (!valid) {
+        std::cout
+            << "Offset of " << m_typeName << " \"" << m_name << "\" is "
+            << offset.X << ", " << offset.Y << " but should be "
+            << p.X << ", " << p.Y << "\n";
+    }
+    for (auto& child : m_children) {
+        valid = child->validateOffsets() && valid;
+    }
+    return valid;
 }
 
 Rect Widget::rect() const {
@@ -100,39 +288,122 @@ Rect Widget::rect() const {
     Rect r;
     r.X = p.X;
     r.Y = p.Y;
-    r.Width = m_width;
-    r.Height = m_height;
+    auto& g = this->geometry();
+    r.Width = g.width(m_slot);
+    r.Height = g.height(m_slot);
     return r;
 }
 
+Rect Widget::bounds() const {
+    return m_bounds;
+}
+
 Size Widget::size() const {
-    return { m_width, m_height };
+    return { this->width(), this->height() };
+}
+
+void Widget::updateBounds() {
+    if (!this->visible()) {
+        m_bounds = Rect();
+        return;
+    }
+    // children aren't clipped to their parent unless it clips
+    // them, so the bounds have to cover the whole subtree
+    auto r = this->rect();
+    r.Inflate(1, 1);
+    for (auto& child : m_children) {
+        child->updateBounds();
+        auto b = child->m_bounds;
+        if (m_clipChildren && !b.Intersect(r)) continue;
+        r = unionRect(r, b);
+    }
+    m_bounds = r;
+}
+
+void Widget::damage() {
+    if (!m_window) return;
+    auto old = m_bounds;
+    this->updateBounds();
+    auto r = unionRect(old, m_bounds);
+    // nothing shows outside of an ancestor that clips it
+    for (auto p = m_parent; p && !r.IsEmptyArea(); p = p->m_parent) {
+        if (p->m_clipChildren) {
+            auto clip = p->rect();
+            clip.Inflate(1, 1);
+            r.Intersect(clip);
+        }
+    }
+    if (!r.IsEmptyArea()) {
+        m_window->updateWindow(toRECT(r));
+    }
 }
 
 void Widget::updatePosition() {
-    this->move(m_x, m_y);
+    this->move(this->x(), this->y());
 }
 
 void Widget::move(int x, int y) {
-    m_x = x;
-    m_y = y;
+    auto& g = this->geometry();
+    auto changed = g.x(m_slot) != x || g.y(m_slot) != y;
+    g.x(m_slot) = x;
+    g.y(m_slot) = y;
+    auto old = this->offset();
+    auto offset = Point(x, y);
+    if (m_parent && !m_parent->m_root) {
+        auto parent = m_parent->offset();
+        offset.X += parent.X;
+        offset.Y += parent.Y;
+    }
+    g.offsetX(m_slot) = offset.X;
+    g.offsetY(m_slot) = offset.Y;
+    if (old.X != offset.X || old.Y != offset.Y) {
+        this->invalidateHit(false);
+    }
     for (auto& child : m_children) {
         child->updatePosition();
     }
+    if (changed && m_parent) {
+        this->invalidateLayout();
+        // the recorded list is just replayed further along, only
+        // the parents referring to it have to record again
+        m_parent->invalidatePaint();
+        this->damage();
+    }
 }
 
 void Widget::resize(int w, int h) {
+    auto changed = this->width() != w || this->height() != h;
     m_autoresize = false;
-    m_width = w;
-    m_height = h;
+    this->storeSize(w, h);
+    if (changed) {
+        this->invalidateHit(false);
+    }
+    if (changed && m_parent) {
+        this->invalidateLayout();
+        this->invalidatePaint();
+        this->damage();
+    }
 }
 
 void Widget::autoResize() {
     m_autoresize = true;
+    this->invalidateLayout();
 }
 
 void Widget::show(bool v) {
-    m_visible = v;
+    if (this->visible() != v) {
+        this->geometry().flag(m_slot, GeometryStore::Visible, v);
+        this->invalidateLayout();
+        this->invalidateHit(true);
+        // a window's focus chain doesn't depend on the window itself
+        if (m_window && !m_root) {
+            if (v) {
+                m_window->focusChainInsert(this);
+            } else {
+                m_window->focusChainRemove(this);
+            }
+        }
+    }
     this->update();
 }
 
@@ -149,6 +420,7 @@ void Widget::leave() {
 void Widget::click() {}
 void Widget::mouseDoubleClick(int x, int y) {}
 void Widget::mouseMove(int x, int y) {}
+bool Widget::mouseWheel(int delta) { return false; }
 void Widget::mouseDown(int x, int y) {}
 void Widget::mouseUp(int x, int y) {
     this->click();
@@ -174,85 +446,10 @@ bool Widget::wantsMouse() const {
     return false;
 }
 
-bool Widget::propagateCaptureMouse(Point& p) {
-    auto r = this->rect();
-    if (r.Contains(p) && this->wantsMouse()) return true;
-    for (auto& child : m_children) {
-        if (child->propagateCaptureMouse(p))
-            return true;
-    }
+bool Widget::handlesChildMouse() const {
     return false;
 }
 
-bool Widget::propagateTabEvent(int& index, int target) {
-    for (auto& child : m_children) {
-        if (child->m_visible && child->wantsMouse()) {
-            if (index == target) {
-                child->tabEnter();
-                return true;
-            }
-            child->tabLeave();
-            index++;
-        }
-        if (child->propagateTabEvent(index, target))
-            return true;
-    }
-    return false;
-}
-
-Widget* Widget::propagateMouseEvent(Point& p, bool down, int clickCount) {
-    Widget* ret = nullptr;
-    for (auto& it = m_children.rbegin(); it != m_children.rend(); it++) {
-        auto child = *it;
-        if (child->wantsMouse()) {
-            auto r = child->rect();
-            if (r.Contains(p)) {
-                ret = child;
-                switch (clickCount) {
-                    case 0: {
-                        if (!child->m_hovered) {
-                            child->m_hovered = true;
-                            child->m_mousedown = down;
-                            child->enter();
-                        }
-                        child->mouseMove(p.X, p.Y);
-                    } break;
-
-                    case 1: {
-                        if (down) {
-                            child->m_mousedown = true;
-                            child->mouseDown(p.X, p.Y);
-                            child->update();
-                        } else {
-                            child->m_mousedown = false;
-                            child->mouseUp(p.X, p.Y);
-                            child->update();
-                        }
-                    } break;
-
-                    default: {
-                        child->m_mousedown = true;
-                        child->mouseDown(p.X, p.Y);
-                        child->mouseDoubleClick(p.X, p.Y);
-                        child->update();
-                    } break;
-                }
-            } else if (clickCount == 0) {
-                if (child->m_hovered) {
-                    child->m_hovered = false;
-                    child->m_mousedown = false;
-                    child->leave();
-                }
-            }
-        }
-    }
-    for (auto& it = m_children.rbegin(); it != m_children.rend(); it++) {
-        auto r = (*it)->propagateMouseEvent(p, down, clickCount);
-        if (r) ret = r;
-    }
-    return ret;
-}
-
 void Widget::propagateFocusEvent(bool focused) {
     for (auto child : m_children) {
         child->windowFocused(focused);
@@ -260,38 +457,245 @@ void Widget::propagateFocusEvent(bool focused) {
     }
 }
 
-void Widget::name(std::string const& name) {
-    m_name = name;
+void Widget::name(std::string name) {
+    if (m_window && !m_root) m_window->unindexWidget(this);
+    m_name = std::move(name);
+    m_nameID = m_name.empty() ? 0 : InternTable::get()->intern(m_name);
+    if (m_window && !m_root) m_window->indexSubtree(this, false);
+}
+
+void Widget::id(int id) {
+    if (m_window && !m_root) m_window->unindexWidget(this);
+    m_id = id;
+    if (m_window && !m_root) m_window->indexSubtree(this, false);
+}
+
+int Widget::id() const {
+    return m_id;
 }
 
-std::string const& Widget::name() {
+std::string const& Widget::name() const {
     return m_name;
 }
 
 void Widget::update() {
-    if (m_window) {
-        m_window->updateWindow();
+    this->invalidatePaint();
+    this->damage();
+}
+
+void Widget::invalidatePaint() {
+    for (auto w = this; w; w = w->m_parent) {
+        w->m_version++;
+    }
+}
+
+void Widget::invalidateLayout() {
+    // sizes and positions set by the layout pass itself are
+    // its output, not a reason to lay out again
+    if (m_window && m_window->m_layingOut) return;
+    for (auto w = this; w; w = w->m_parent) {
+        w->m_layoutDirty = true;
+    }
+    if (m_window) m_window->m_scheduler.requestLayout();
+}
+
+bool Widget::measure(HDC hdc, SIZE available) {
+    if (
+        !m_layoutDirty &&
+        available.cx == m_lastAvailable.cx &&
+        available.cy == m_lastAvailable.cy
+    ) return false;
+    if (m_window) m_window->m_frameStats.m_measured++;
+    m_lastAvailable = available;
+    if (m_parallelMeasure && !g_measuringPrefetched) {
+        this->prefetchText(available);
+        g_measuringPrefetched = true;
+        this->updateSize(hdc, available);
+        g_measuringPrefetched = false;
+    } else {
+        this->updateSize(hdc, available);
+    }
+    m_layoutDirty = false;
+    m_needsArrange = true;
+    return true;
+}
+
+void Widget::arrange() {
+    if (!m_needsArrange) return;
+    m_needsArrange = false;
+    this->updateLayout();
+    for (auto& child : m_children) {
+        child->arrange();
     }
 }
 
 void Widget::updateSize(HDC hdc, SIZE available) {
     for (auto& child : m_children) {
-        if (child->m_visible) {
+        if (child->visible()) {
             auto av = available;
-            av.cx -= child->m_x;
-            av.cy -= child->m_y;
-            child->updateSize(hdc, av);
+            av.cx -= child->x();
+            av.cy -= child->y();
+            child->measure(hdc, av);
         }
     }
 }
 
-void Widget::paint(HDC hdc, PAINTSTRUCT* ps) {
-    if (m_tabbed) {
-        Pen pen(Style::tab());
-        Graphics(hdc).DrawRectangle(&pen, toRectF(this->rect()));
+void Widget::updateLayout() {}
+
+void Widget::paintChild(Widget* child, Canvas& canvas) {
+    if (!child->visible()) return;
+    if (!child->m_bounds.IntersectsWith(canvas.dirty())) {
+        if (m_window) m_window->m_frameStats.m_skipped++;
+        return;
+    }
+    if (!child->m_bounds.IntersectsWith(canvas.cull())) {
+        if (m_window) m_window->m_frameStats.m_culled++;
+        return;
+    }
+    if (m_window) m_window->m_frameStats.m_painted++;
+    child->paintRetained(canvas);
+}
+
+std::shared_ptr<RecordingCanvas const> const& Widget::record(
+    Widget* widget, Canvas& canvas, Point& moved, Rect& bounds
+) {
+    auto offset = widget->offset();
+    if (
+        !widget->m_displayList ||
+        widget->m_displayVersion != widget->m_version ||
+        widget->m_displayGeneration != Style::generation()
+    ) {
+        // recorded unculled so the list stays valid for any dirty area
+        auto list = std::make_shared<RecordingCanvas>(
+            RecordingCanvas::everything(), canvas.device()
+        );
+        widget->paint(*list);
+        widget->m_displayList = list;
+        widget->m_displayVersion = widget->m_version;
+        widget->m_displayGeneration = Style::generation();
+        widget->m_displayOffset = offset;
+        if (widget->m_window) widget->m_window->m_frameStats.m_recorded++;
+    } else {
+        if (widget->m_window) widget->m_window->m_frameStats.m_replayed++;
+    }
+    moved = Point(offset.X - widget->m_displayOffset.X, offset.Y - widget->m_displayOffset.Y);
+    bounds = Rect(
+        widget->m_bounds.X - moved.X, widget->m_bounds.Y - moved.Y,
+        widget->m_bounds.Width, widget->m_bounds.Height
+    );
+    return widget->m_displayList;
+}
+
+void Widget::paintRetained(Canvas& canvas) {
+    Point moved;
+    Rect bounds;
+    auto& list = Widget::record(this, canvas, moved, bounds);
+    if (m_cacheLayer) {
+        canvas.drawLayer(m_handle.value(), list, moved, bounds);
+    } else {
+        canvas.drawList(list, moved, bounds);
     }
+}
+
+void Widget::clipChildren(bool clip) {
+    m_clipChildren = clip;
+    this->update();
+}
+
+bool Widget::clipsChildren() const {
+    return m_clipChildren;
+}
+
+bool Widget::opaque() const {
+    return false;
+}
+
+void Widget::collectText(std::vector<TextQuery>& queries, SIZE available) {
     for (auto& child : m_children) {
-        if (child->m_visible) child->paint(hdc, ps);
+        Widget::collectChildText(
+            child, queries, { available.cx - child->x(), available.cy - child->y() }
+        );
+    }
+}
+
+void Widget::collectChildText(Widget* child, std::vector<TextQuery>& queries, SIZE available) {
+    if (!child->visible()) return;
+    if (
+        child->m_layoutDirty ||
+        available.cx != child->m_lastAvailable.cx ||
+        available.cy != child->m_lastAvailable.cy
+    ) {
+        child->collectText(queries, available);
+    }
+}
+
+void Widget::prefetchText(SIZE available) {
+    std::vector<TextQuery> queries;
+    this->collectText(queries, available);
+    ThreadPool::get()->run(queries.size(), [&queries](size_t i) -> void {
+        TextCache::get()->measure(queries[i], measureDC());
+    });
+    if (m_window) m_window->m_frameStats.m_prefetched += queries.size();
+}
+
+void Widget::measureInParallel(bool on) {
+    m_parallelMeasure = on;
+    this->invalidateLayout();
+}
+
+bool Widget::measuresInParallel() const {
+    return m_parallelMeasure;
+}
+
+void Widget::cacheLayer(bool cache) {
+    m_cacheLayer = cache;
+    if (!cache && m_window) {
+        m_window->layerCache().drop(m_handle.value());
+    }
+    this->update();
+}
+
+bool Widget::cachesLayer() const {
+    return m_cacheLayer;
+}
+
+void Widget::paint(Canvas& canvas) {
+    if (m_tabbed) {
+        canvas.strokeRect(toRectF(this->rect()), Style::tab());
+    }
+    if (m_clipChildren) {
+        canvas.pushClip(this->rect());
+    }
+    // children are painted in order, so an opaque
+    // child hides every sibling that came before it
+    auto window = m_root ? static_cast<Window*>(this) : m_window;
+    std::vector<std::pair<size_t, Rect>> unattached;
+    auto& occluders = window ? window->m_occluders : unattached;
+    auto first = occluders.size();
+    for (size_t i = 0; i < m_children.size(); i++) {
+        auto child = m_children[i];
+        if (child->visible() && child->opaque()) {
+            occluders.push_back({ i, child->rect() });
+        }
+    }
+    // children painted from here push theirs after these and
+    // take them off again, so only indices stay valid
+    auto last = occluders.size();
+    for (size_t i = 0; i < m_children.size(); i++) {
+        auto child = m_children[i];
+        auto occluded = false;
+        for (auto o = first; o < last && !occluded; o++) {
+            occluded = occluders[o].first > i && occluders[o].second.Contains(child->m_bounds);
+        }
+        if (occluded && child->visible()) {
+            if (m_window) m_window->m_frameStats.m_occluded++;
+            continue;
+        }
+        this->paintChild(child, canvas);
+    }
+    occluders.resize(first);
+    if (m_clipChildren) {
+        canvas.popClip();
     }
 }
 
@@ -303,7 +707,7 @@ Widget* Widget::getParent() const {
     return m_parent;
 }
 
-std::vector<Widget*> Widget::getChildren() const {
+Span<Widget* const> Widget::getChildren() const {
     return m_children;
 }
 
@@ -311,24 +715,85 @@ Widget::~Widget() {
     for (auto& child : m_children) {
         delete child;
     }
+    // a window's m_window is its owner, which it was never indexed in
+    if (m_window && !m_root) {
+        m_window->forgetWidget(this);
+    }
+    // a window's store has already gone with the rest of it
+    if (!m_root) {
+        this->geometry().detach(m_slot);
+    }
+    Widget::handles().erase(m_handle);
 }
 
-int Widget::x() const { return m_x; }
-int Widget::y() const { return m_y; }
-int Widget::width() const { return m_width; }
-int Widget::height() const { return m_height; }
-bool Widget::visible() const { return m_visible; }
+void Widget::invalidateHit(bool subtree) {
+    // windows are never in an index, their m_window is their owner
+    if (!m_root) {
+        // whatever changed may have been whether it wants the mouse
+        this->geometry().flag(m_slot, GeometryStore::WantsMouse, this->wantsMouse());
+        if (!m_window) return;
+        m_window->m_hitDirty.insert(this);
+    }
+    if (subtree) {
+        for (auto& child : m_children) {
+            child->invalidateHit(true);
+        }
+    }
+}
+
+int Widget::x() const { return this->geometry().x(m_slot); }
+int Widget::y() const { return this->geometry().y(m_slot); }
+int Widget::width() const { return this->geometry().width(m_slot); }
+int Widget::height() const { return this->geometry().height(m_slot); }
+bool Widget::visible() const { return this->geometry().flag(m_slot, GeometryStore::Visible); }
+
+void Widget::storeSize(int w, int h) {
+    auto& g = this->geometry();
+    g.width(m_slot) = w;
+    g.height(m_slot) = h;
+}
+
+void Widget::storePosition(int x, int y) {
+    auto& g = this->geometry();
+    g.x(m_slot) = x;
+    g.y(m_slot) = y;
+    g.offsetX(m_slot) = x;
+    g.offsetY(m_slot) = y;
+}
+
+void Widget::assignSize(Widget* widget, int w, int h) {
+    if (widget->width() == w && widget->height() == h) return;
+    widget->storeSize(w, h);
+    widget->m_needsArrange = true;
+    widget->invalidateHit(false);
+    widget->invalidatePaint();
+    widget->damage();
+}
 
 void ColorWidget::color(Color color) {
     m_color = color;
+    this->update();
 }
 
 Color ColorWidget::color() const {
     return m_color;
 }
 
-void TextWidget::text(std::wstring const& text) {
-    m_text = text;
+void TextWidget::collectText(std::vector<TextQuery>& queries, SIZE available) {
+    auto text = m_autoresize ? this->sizingText() : nullptr;
+    if (text && text->size()) {
+        queries.push_back({ *text, m_font, m_fontSize, m_style, m_wordWrap, available.cx });
+    }
+    Widget::collectText(queries, available);
+}
+
+std::wstring const* TextWidget::sizingText() const {
+    return &m_text;
+}
+
+void TextWidget::text(std::wstring text) {
+    m_text = std::move(text);
+    this->invalidateLayout();
     this->update();
 }
 
@@ -336,13 +801,14 @@ void TextWidget::text(std::string const& text) {
     this->text(toWString(text));
 }
 
-std::wstring TextWidget::text() const {
+std::wstring const& TextWidget::text() const {
     return m_text;
 }
 
 void TextWidget::font(std::wstring const& font, int size) {
     m_font = font;
     m_fontSize = size;
+    this->invalidateLayout();
     this->update();
 }
 
@@ -364,11 +830,13 @@ void TextWidget::fontSize(int size) {
 
 void TextWidget::wrap(bool on) {
     m_wordWrap = on;
+    this->invalidateLayout();
     this->update();
 }
 
 void TextWidget::style(int style) {
     m_style = style;
+    this->invalidateLayout();
     this->update();
 }
 
@@ -378,105 +846,76 @@ RectF TextWidget::measureText(
     std::wstring const& fontFamily,
     int fontSize,
     int style,
-    SIZE const& available,
-    StringFormat const& format
+    SIZE const& available
 ) {
-    Graphics g(hdc);
-    InitGraphics(g);
-    auto tf = format.Clone();
-    tf->SetFormatFlags(StringFormatFlagsMeasureTrailingSpaces);
-    RectF r;
-    Font font(hdc, Manager::get()->loadFont(fontFamily, fontSize, style));
-    if (m_wordWrap) {
-        g.MeasureString(
-            text.c_str(), -1,
-            &font, { 
-                0, 0,
-                static_cast<REAL>(available.cx),
-                static_cast<REAL>(available.cy)
-            }, tf, &r
-        );
-    } else {
-        g.MeasureString(
-            text.c_str(), -1,
-            &font, { 
-                0, 0, 0, 0
-            }, tf, &r
-        );
-    }
+    auto size = TextCache::get()->measure(
+        { text, fontFamily, fontSize, style, m_wordWrap, available.cx }, hdc
+    );
+    RectF r(0, 0, size.m_width, size.m_height);
     if (r.Width > available.cx) r.Width = static_cast<REAL>(available.cx);
     if (r.Height > available.cy) r.Height = static_cast<REAL>(available.cy);
-    delete tf;
     return r;
 }
 
 RectF TextWidget::measureText(
     HDC hdc,
     std::wstring const& text,
-    SIZE const& available,
-    StringFormat const& format
+    SIZE const& available
 ) {
-    return this->measureText(hdc, text, m_font, m_fontSize, m_style, available, format);
+    return this->measureText(hdc, text, m_font, m_fontSize, m_style, available);
 }
 
-RectF TextWidget::measureText(HDC hdc, SIZE const& available, StringFormat const& format) {
-    return this->measureText(hdc, m_text, m_font, m_fontSize, m_style, available, format);
+RectF TextWidget::measureText(HDC hdc, SIZE const& available) {
+    return this->measureText(hdc, m_text, m_font, m_fontSize, m_style, available);
 }
 
 void TextWidget::paintText(
-    HDC hdc,
+    Canvas& canvas,
     std::wstring const& text,
     std::wstring const& fontFamily,
     int fontSize,
     int style,
     Color const& color,
     Rect const& drawRect,
-    StringFormat const& format
+    TextLayout layout
 ) {
-    Graphics g(hdc);
-    InitGraphics(g);
-
-    Font font(hdc, Manager::get()->loadFont(fontFamily, fontSize, style));
-    SolidBrush brush(color);
-    if (m_wordWrap) {
-        g.DrawString(
-            text.c_str(), -1,
-            &font, toRectF(drawRect), &format, &brush
-        );
-    } else {
-        Region reg(drawRect);
-        g.SetClip(&reg);
-        g.DrawString(
-            text.c_str(), -1,
-            &font, toPointF(drawRect), &format, &brush
-        );
-    }
+    layout.m_wrap = m_wordWrap;
+    canvas.drawText(
+        text, fontFamily, fontSize, style, color,
+        toRectF(drawRect), layout
+    );
 }
 
 void TextWidget::paintText(
-    HDC hdc,
+    Canvas& canvas,
     std::wstring const& text,
     int style,
     Color const& color,
     Rect const& drawRect
 ) {
-    return this->paintText(hdc, text, m_font, m_fontSize, style, color, drawRect, StringFormat());
+    return this->paintText(
+        canvas, text, m_font, m_fontSize, style, color, drawRect, TextLayout()
+    );
 }
 
 void TextWidget::paintText(
-    HDC hdc,
+    Canvas& canvas,
     std::wstring const& text,
     Rect const& drawRect,
-    StringFormat const& format
+    TextLayout const& layout
 ) {
-    return this->paintText(hdc, text, m_font, m_fontSize, m_style, m_color, drawRect, format);
+    return this->paintText(canvas, text, m_font, m_fontSize, m_style, m_color, drawRect, layout);
+}
+
+void TextWidget::paintText(Canvas& canvas, Rect const& drawRect, TextLayout const& layout) {
+    return this->paintText(canvas, m_text, m_font, m_fontSize, m_style, m_color, drawRect, layout);
 }
 
-void TextWidget::paintText(HDC hdc, Rect const& drawRect, StringFormat const& format) {
-    return this->paintText(hdc, m_text, m_font, m_fontSize, m_style, m_color, drawRect, format);
+void TextWidget::paintText(Canvas& canvas, Rect const& drawRect) {
+    return this->paintText(canvas, drawRect, TextLayout());
 }
 
-void TextWidget::paint(HDC hdc, PAINTSTRUCT* ps) {
-    this->paintText(hdc, this->rect());
-    Widget::paint(hdc, ps);
+void TextWidget::paint(Canvas& canvas) {
+    this->paintText(canvas, this->rect());
+    Widget::paint(canvas);
 }
@@ -10,37 +10,108 @@
 #include <string>
 #include <dwmapi.h>
 #include <functional>
+#include <TextCache.hpp>
+#include <Canvas.hpp>
+#include <RecordingCanvas.hpp>
+#include <memory>
+#include <SlotMap.hpp>
+#include <Arena.hpp>
+#include <GeometryStore.hpp>
+#include <Span.hpp>
+#include <Event.hpp>
+#include <InternTable.hpp>
 
 class Window;
 
 class Widget {
 protected:
-    int m_x = 0;
-    int m_y = 0;
-    int m_width = 0;
-    int m_height = 0;
+    // position, size and visibility live in the GeometryStore of
+    // the window the widget is in under this, see geometry()
+    uint32_t m_slot = 0;
     bool m_autoresize = false;
-    bool m_visible = false;
     bool m_hovered = false;
     bool m_mousedown = false;
     bool m_tabbed = false;
     bool m_keyboardFocused = false;
+    bool m_root = false;
+    bool m_layoutDirty = true;
+    bool m_needsArrange = false;
+    SIZE m_lastAvailable = { -1, -1 };
     Widget* m_parent = nullptr;
     Window* m_window = nullptr;
     std::vector<Widget*> m_children;
+    Rect m_bounds;
+    // bumped whenever this widget or anything below it paints differently
+    size_t m_version = 0;
+    std::shared_ptr<RecordingCanvas const> m_displayList;
+    size_t m_displayVersion = 0;
+    size_t m_displayGeneration = 0;
+    Point m_displayOffset;
+    bool m_cacheLayer = false;
+    bool m_clipChildren = false;
+    bool m_parallelMeasure = false;
+    // links in the window's focus chain, which is in tree order
+    Widget* m_focusPrev = nullptr;
+    Widget* m_focusNext = nullptr;
+    bool m_inFocusChain = false;
     const char* m_typeName = "Widget";
     std::string m_name = "";
+    // m_name interned, for the window's name index
+    uint32_t m_nameID = 0;
+    // type() interned when the widget was indexed, since
+    // it can't be called anymore once it's being deleted
+    uint32_t m_typeID = 0;
+    int m_id = 0;
     void* m_userData = nullptr;
-    static Widget* s_hoveredWidget;
-    static Widget* s_capturingWidget;
-    static Widget* s_keyboardWidget;
+    SlotHandle m_handle;
+    struct Listener {
+        Event::Type m_type;
+        std::function<void(Event&)> m_func;
+        bool m_capture;
+    };
+    std::vector<Listener> m_listeners;
+
+    static SlotMap<Widget*>& handles();
+    // the store of the window the widget is in, its own for a window
+    // and one shared by every widget that isn't in a window
+    GeometryStore& geometry() const;
+    static GeometryStore& detached();
+
+    // set the geometry without any of the bookkeeping resize/move
+    // do, for widgets working out their own size in updateSize
+    void storeSize(int w, int h);
+    // a window's offset is its position on the screen
+    void storePosition(int x, int y);
+    // for layouts deciding a child's size, which unlike resize() leaves
+    // the child autoresizing so that it's measured normally next time
+    static void assignSize(Widget* widget, int w, int h);
+    // The text in the subtree that measuring it would go through, with
+    // the space it would be measured in. Containers that give children
+    // something other than what Widget::updateSize does override this
+    virtual void collectText(std::vector<TextQuery>& queries, SIZE available);
+    // collects child's text if measuring it in available would do anything
+    static void collectChildText(Widget* child, std::vector<TextQuery>& queries, SIZE available);
+    void prefetchText(SIZE available);
 
     void updatePosition();
+    void updateBounds();
+    void damage();
+    void paintChild(Widget* child, Canvas& canvas);
+    void paintRetained(Canvas& canvas);
+    // brings widget's display list up to date, and tells how far the
+    // widget moved since it was recorded and the area it covered then
+    static std::shared_ptr<RecordingCanvas const> const& record(
+        Widget* widget, Canvas& canvas, Point& moved, Rect& bounds
+    );
     void setWindow(Window*);
-    Widget* propagateMouseEvent(Point& p, bool down, int clickCount);
-    bool propagateTabEvent(int& index, int target);
-    bool propagateCaptureMouse(Point& p);
+    // queues this widget (or the whole subtree) to be
+    // put back into the window's hit test index
+    void invalidateHit(bool subtree);
     void propagateFocusEvent(bool focused);
+    void runListeners(Event& event, bool capture);
+    // what happens to an event that reaches the widget by default,
+    // which is calling the matching mouse or key handler
+    void handleEvent(Event& event);
     void captureMouse();
     void releaseMouse();
     void captureKeyboard();
@@ -49,13 +120,53 @@ protected:
     friend class Window;
 
 public:
+    Widget();
     virtual ~Widget();
 
-    virtual void paint(HDC hdc, PAINTSTRUCT* ps);
+    // widgets go into the arena of the ArenaScope they're created in
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
+    // stays valid for as long as the widget is around,
+    // and resolves to nullptr once it's deleted
+    SlotHandle handle() const;
+    static Widget* fromHandle(SlotHandle handle);
+
+    // Runs func for events of type headed to this widget or anything
+    // below it; before they reach the target if capture is set,
+    // otherwise after. Can stop events with Event::stopPropagation
+    void listen(Event::Type type, std::function<void(Event&)> func, bool capture = false);
+
+    virtual void paint(Canvas& canvas);
     virtual void updateSize(HDC hdc, SIZE available);
+    virtual void updateLayout();
+
+    // returns false if the size from last time was still good
+    bool measure(HDC hdc, SIZE available);
+    void arrange();
+    void invalidateLayout();
+    void invalidatePaint();
+
+    // Keeps the subtree rendered offscreen and composites that until
+    // something in it changes. Meant for big subtrees that rarely do
+    void cacheLayer(bool cache = true);
+    bool cachesLayer() const;
+
+    // children are clipped to this widget, and
+    // not painted at all if they're entirely outside
+    void clipChildren(bool clip = true);
+    bool clipsChildren() const;
+    // Measures the text in the subtree on the thread pool before laying
+    // it out, which is then done as usual. Meant for subtrees with a lot
+    // of text that changes at once, like a page that was just built
+    void measureInParallel(bool on = true);
+    bool measuresInParallel() const;
+    // whether paint() covers all of rect() with opaque pixels,
+    // letting anything below it be skipped
+    virtual bool opaque() const;
 
     Widget* getParent() const;
-    std::vector<Widget*> getChildren() const;
+    Span<Widget* const> getChildren() const;
 
     virtual void add(Widget* child);
     virtual void remove(Widget* child, bool release = true);
@@ -75,14 +186,24 @@ public:
     virtual void mouseDoubleClick(int x, int y);
     virtual void mouseUp(int x, int y);
     virtual void mouseMove(int x, int y);
+    // returns whether the wheel was used, which stops it from
+    // scrolling anything further up as well
+    virtual bool mouseWheel(int delta);
     virtual bool wantsMouse() const;
+    // Whether the mouse handlers also get the clicks and moves that land
+    // on children, after the children did. For containers that drag
+    // whatever's in them around. The wheel always goes up regardless
+    virtual bool handlesChildMouse() const;
     virtual void keyDown(size_t key, size_t scanCode);
     virtual void keyUp(size_t key, size_t scanCode);
     virtual void windowFocused(bool focus);
     virtual void keyboardCaptured(bool captured);
     virtual const char* type() const;
-    void name(std::string const& name);
-    std::string const& name();
+    void name(std::string name);
+    std::string const& name() const;
+    // for finding the widget through its window, 0 for none
+    void id(int id);
+    int id() const;
     
     void userData(void*);
     void* userData() const;
@@ -97,6 +218,13 @@ public:
 
     Point offset() const;
     Rect rect() const;
+    // Checks the cached offsets in the subtree against ones worked
+    // out from scratch, logging any that are off. For debugging
+    bool validateOffsets() const;
+    // whether a is painted before (so below) b, without allocating
+    // since hit testing sorts with it on every mouse move
+    static bool paintsBefore(Widget const* a, Widget const* b);
+    Rect bounds() const;
     Size size() const;
 };
 
@@ -123,48 +251,52 @@ protected:
         std::wstring const& font,
         int fontSize,
         int style,
-        SIZE const& available,
-        StringFormat const& format
+        SIZE const& available
     );
     RectF measureText(
         HDC hdc,
         std::wstring const& text,
-        SIZE const& available,
-        StringFormat const& format
+        SIZE const& available
     );
-    RectF measureText(HDC hdc, SIZE const& available, StringFormat const& format = StringFormat());
+    RectF measureText(HDC hdc, SIZE const& available);
+    // the text updateSize measures to size the widget, nullptr if none
+    virtual std::wstring const* sizingText() const;
 
+    // whether the text wraps is always taken from the widget
     void paintText(
-        HDC hdc,
+        Canvas& canvas,
         std::wstring const& text,
         std::wstring const& font,
         int fontSize,
         int style,
         Color const& color,
         Rect const& drawRect,
-        StringFormat const& format
+        TextLayout layout
     );
     void paintText(
-        HDC hdc,
+        Canvas& canvas,
         std::wstring const& text,
         int style,
         Color const& color,
         Rect const& drawRect
     );
     void paintText(
-        HDC hdc,
+        Canvas& canvas,
         std::wstring const& text,
         Rect const& drawRect,
-        StringFormat const& format
+        TextLayout const& layout
     );
-    void paintText(HDC hdc, Rect const& drawRect, StringFormat const& format = StringFormat());
+    void paintText(Canvas& canvas, Rect const& drawRect, TextLayout const& layout);
+    void paintText(Canvas& canvas, Rect const& drawRect);
+
+    void collectText(std::vector<TextQuery>& queries, SIZE available) override;
 
 public:
     virtual void text(std::string const& text);
-    virtual void text(std::wstring const& text);
-    std::wstring text() const;
+    virtual void text(std::wstring text);
+    std::wstring const& text() const;
 
-    void paint(HDC hdc, PAINTSTRUCT* ps) override;
+    void paint(Canvas& canvas) override;
 
     void font(std::string const& font);
     void font(std::wstring const& font);
@@ -0,0 +1,135 @@
+#include "Canvas.hpp"
+#include "RecordingCanvas.hpp"
+
+Fill::Fill(Color const& color) : m_color1(color), m_color2(color) {}
+
+Fill Fill::linear(
+    Point const& p1, Point const& p2,
+    Color const& c1, Color const& c2
+) {
+    Fill fill(c1);
+    fill.m_color2 = c2;
+    fill.m_point1 = p1;
+    fill.m_point2 = p2;
+    fill.m_gradient = true;
+    return fill;
+}
+
+static Rect intersect(Rect const& a, Rect const& b) {
+    auto x1 = a.X > b.X ? a.X : b.X;
+    auto y1 = a.Y > b.Y ? a.Y : b.Y;
+    auto x2 = a.X + a.Width < b.X + b.Width ? a.X + a.Width : b.X + b.Width;
+    auto y2 = a.Y + a.Height < b.Y + b.Height ? a.Y + a.Height : b.Y + b.Height;
+    if (x2 <= x1 || y2 <= y1) return Rect();
+    return Rect(x1, y1, x2 - x1, y2 - y1);
+}
+
+void Canvas::enterClip(Rect const& rect) {
+    Rect abs(rect.X + m_listOffset.X, rect.Y + m_listOffset.Y, rect.Width, rect.Height);
+    m_clips.push_back(m_clips.empty() ? abs : intersect(m_clips.back(), abs));
+}
+
+void Canvas::leaveClip() {
+    m_clips.pop_back();
+}
+
+void Canvas::pushClip(Rect const& rect) {
+    this->save();
+    this->clipRect(rect);
+    this->enterClip(rect);
+}
+
+void Canvas::popClip() {
+    if (m_clips.empty()) return;
+    this->leaveClip();
+    this->restore();
+}
+
+Rect Canvas::cull() const {
+    if (m_clips.empty()) return this->dirty();
+    return intersect(this->dirty(), m_clips.back());
+}
+
+size_t Canvas::culledLists() const {
+    return m_culledLists;
+}
+
+void Canvas::drawList(
+    std::shared_ptr<RecordingCanvas const> const& list,
+    Point const& offset,
+    Rect const& bounds
+) {
+    auto dx = m_listOffset.X + offset.X;
+    auto dy = m_listOffset.Y + offset.Y;
+    Rect moved(bounds.X + dx, bounds.Y + dy, bounds.Width, bounds.Height);
+    if (!moved.IntersectsWith(this->cull())) {
+        m_culledLists++;
+        return;
+    }
+
+    if (!offset.X && !offset.Y) {
+        list->replay(*this);
+        return;
+    }
+    auto old = m_listOffset;
+    m_listOffset = Point(dx, dy);
+    this->save();
+    this->translate(static_cast<REAL>(offset.X), static_cast<REAL>(offset.Y));
+    list->replay(*this);
+    this->restore();
+    m_listOffset = old;
+}
+
+void Canvas::drawLayer(
+    uintptr_t,
+    std::shared_ptr<RecordingCanvas const> const& list,
+    Point const& offset,
+    Rect const& bounds
+) {
+    this->drawList(list, offset, bounds);
+}
+
+void Canvas::drawScrolled(
+    uintptr_t,
+    std::shared_ptr<RecordingCanvas const> const& list,
+    Point const& offset,
+    Rect const& bounds,
+    Rect const& viewport
+) {
+    this->pushClip(viewport);
+    this->drawList(list, offset, bounds);
+    this->popClip();
+}
+
+void Path::addLine(PointF const& from, PointF const& to) {
+    if (m_figures.empty()) {
+        m_figures.push_back(0);
+    }
+    auto last = m_points.size() > m_figures.back() ? &m_points.back() : nullptr;
+    if (!last || last->X != from.X || last->Y != from.Y) {
+        m_points.push_back(from);
+    }
+    m_points.push_back(to);
+}
+
+void Path::addLine(REAL x1, REAL y1, REAL x2, REAL y2) {
+    this->addLine(PointF(x1, y1), PointF(x2, y2));
+}
+
+void Path::startFigure() {
+    if (m_figures.empty() || m_figures.back() != m_points.size()) {
+        m_figures.push_back(m_points.size());
+    }
+}
+
+std::vector<PointF> const& Path::points() const {
+    return m_points;
+}
+
+std::vector<size_t> const& Path::figures() const {
+    return m_figures;
+}
+
+bool Path::empty() const {
+    return m_points.empty();
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Types.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class RecordingCanvas;
+
+// What a shape is filled with. Gradient endpoints are given in the
+// coordinates the shape is drawn in (local to the rect for round rects)
+struct Fill {
+    Color m_color1;
+    Color m_color2;
+    Point m_point1;
+    Point m_point2;
+    bool m_gradient = false;
+
+    Fill(Color const& color);
+    static Fill linear(
+        Point const& p1, Point const& p2,
+        Color const& c1, Color const& c2
+    );
+};
+
+struct TextLayout {
+    StringAlignment m_alignment = StringAlignmentNear;
+    StringAlignment m_lineAlignment = StringAlignmentNear;
+    StringTrimming m_trimming = StringTrimmingCharacter;
+    int m_flags = 0;
+    // wrapped text is laid out in the rect, otherwise it is drawn
+    // from the rect's corner and clipped to it
+    bool m_wrap = true;
+};
+
+// Open polylines, split into figures like a GraphicsPath
+class Path {
+protected:
+    std::vector<PointF> m_points;
+    std::vector<size_t> m_figures;
+
+public:
+    // connects to the end of the current figure, like GraphicsPath::AddLine
+    void addLine(PointF const& from, PointF const& to);
+    void addLine(REAL x1, REAL y1, REAL x2, REAL y2);
+    void startFigure();
+
+    std::vector<PointF> const& points() const;
+    // start index of each figure into points()
+    std::vector<size_t> const& figures() const;
+    bool empty() const;
+};
+
+// Everything widgets draw goes through this, so painting can be
+// recorded and replayed without a window or even Windows
+class Canvas {
+protected:
+    // sum of the offsets of the recorded lists being drawn,
+    // so that nested lists can be culled against cull()
+    Point m_listOffset;
+    // pushed clips in window coordinates, each one
+    // already intersected with the one below it
+    std::vector<Rect> m_clips;
+    size_t m_culledLists = 0;
+
+    // only the bookkeeping for pushClip/popClip
+    void enterClip(Rect const& rect);
+    void leaveClip();
+
+public:
+    virtual ~Canvas() = default;
+
+    virtual void fillRect(RectF const& rect, Fill const& fill) = 0;
+    virtual void strokeRect(RectF const& rect, Color const& color, REAL width = 1.f) = 0;
+    virtual void fillRoundRect(Rect const& rect, int radius, Fill const& fill) = 0;
+    virtual void strokeRoundRect(Rect const& rect, int radius, Color const& color) = 0;
+    virtual void fillEllipse(RectF const& rect, Fill const& fill) = 0;
+    virtual void strokePath(Path const& path, Color const& color, REAL width = 1.f) = 0;
+    virtual void drawText(
+        std::wstring const& text,
+        std::wstring const& font,
+        int size,
+        int style,
+        Color const& color,
+        RectF const& rect,
+        TextLayout const& layout
+    ) = 0;
+
+    // save/restore cover both the clip and the transform
+    virtual void save() = 0;
+    virtual void restore() = 0;
+    virtual void clipRect(Rect const& rect) = 0;
+    virtual void translate(REAL dx, REAL dy) = 0;
+    virtual void rotate(REAL degrees) = 0;
+
+    // A clip that painting is also culled against, unlike clipRect
+    // which only affects pixels. Must not be pushed while rotated
+    virtual void pushClip(Rect const& rect);
+    virtual void popClip();
+    // dirty() limited to the pushed clips
+    Rect cull() const;
+    // recorded lists skipped because they were outside cull()
+    size_t culledLists() const;
+
+    // Draws a recorded list moved by offset. bounds is the area the
+    // list covers where it was recorded, lists that miss the dirty
+    // area are skipped entirely
+    virtual void drawList(
+        std::shared_ptr<RecordingCanvas const> const& list,
+        Point const& offset,
+        Rect const& bounds
+    );
+    // Same as drawList, but backends that can are free to keep the
+    // list rendered to a surface under key and composite that instead
+    virtual void drawLayer(
+        uintptr_t key,
+        std::shared_ptr<RecordingCanvas const> const& list,
+        Point const& offset,
+        Rect const& bounds
+    );
+    // Draws a list that's scrolled inside of viewport, clipped to it.
+    // Backends that can keep what's in the viewport under key, and when
+    // only the offset changed since, shift those pixels over and replay
+    // the list just for the strip that was uncovered
+    virtual void drawScrolled(
+        uintptr_t key,
+        std::shared_ptr<RecordingCanvas const> const& list,
+        Point const& offset,
+        Rect const& bounds,
+        Rect const& viewport
+    );
+
+    // area being repainted, in window coordinates
+    virtual Rect dirty() const = 0;
+    // what text is measured against, i.e. an HDC for GDI+
+    virtual void* device() const = 0;
+};
@@ -0,0 +1,201 @@
+#include "FrameScheduler.hpp"
+#include <algorithm>
+#include <chrono>
+
+double SteadyClock::now() const {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+double VirtualClock::now() const {
+    return m_now;
+}
+
+void VirtualClock::advance(double ms) {
+    m_now += ms;
+}
+
+FrameScheduler::FrameScheduler(std::unique_ptr<Clock> clock)
+  : m_clock(std::move(clock)) {}
+
+double FrameScheduler::interval() const {
+    return m_maxFps > 0 ? 1000.0 / m_maxFps : 0.0;
+}
+
+void FrameScheduler::schedule() {
+    // whatever comes in during a frame is looked at when it ends
+    if (m_scheduled || m_inFrame || !m_wake) return;
+    m_scheduled = true;
+    m_stats.m_wakes++;
+    auto delay = 0.0;
+    if (m_hasFrame) {
+        delay = m_lastFrame + this->interval() - m_clock->now();
+    }
+    m_wake(delay > 0.0 ? static_cast<unsigned int>(delay + 0.5) : 0u);
+}
+
+void FrameScheduler::wake(Wake wake) {
+    m_wake = wake;
+    if (this->pending()) {
+        this->schedule();
+    }
+}
+
+void FrameScheduler::input(Input input) {
+    m_input = input;
+}
+
+void FrameScheduler::layout(Layout layout) {
+    m_layout = layout;
+}
+
+void FrameScheduler::paint(Paint paint) {
+    m_paint = paint;
+}
+
+void FrameScheduler::invalidate(Rect const& rect) {
+    if (rect.IsEmptyArea()) return;
+    m_stats.m_invalidations++;
+    if (m_damage.IsEmptyArea()) {
+        m_damage = rect;
+    } else {
+        auto x1 = m_damage.X < rect.X ? m_damage.X : rect.X;
+        auto y1 = m_damage.Y < rect.Y ? m_damage.Y : rect.Y;
+        auto x2 = m_damage.X + m_damage.Width > rect.X + rect.Width ?
+            m_damage.X + m_damage.Width : rect.X + rect.Width;
+        auto y2 = m_damage.Y + m_damage.Height > rect.Y + rect.Height ?
+            m_damage.Y + m_damage.Height : rect.Y + rect.Height;
+        m_damage = Rect(x1, y1, x2 - x1, y2 - y1);
+    }
+    this->schedule();
+}
+
+void FrameScheduler::requestInput() {
+    m_stats.m_inputRequests++;
+    m_inputPending = true;
+    this->schedule();
+}
+
+void FrameScheduler::requestLayout() {
+    m_stats.m_layoutRequests++;
+    m_layoutPending = true;
+    this->schedule();
+}
+
+size_t FrameScheduler::animate(Animation animation) {
+    auto id = m_nextAnimation++;
+    m_animations.push_back({ id, animation });
+    this->schedule();
+    return id;
+}
+
+void FrameScheduler::cancel(size_t id) {
+    // only cleared here, since it may be one of the ones running
+    for (auto& animation : m_animations) {
+        if (animation.first == id) {
+            animation.second = nullptr;
+        }
+    }
+}
+
+void FrameScheduler::animate(double now) {
+    // ones started by the animations wait for the next frame
+    auto count = m_animations.size();
+    for (size_t i = 0; i < count; i++) {
+        auto func = m_animations[i].second;
+        if (!func) continue;
+        m_stats.m_animationSteps++;
+        if (!func(now)) {
+            m_animations[i].second = nullptr;
+        }
+    }
+    m_animations.erase(
+        std::remove_if(m_animations.begin(), m_animations.end(), [](auto const& animation) {
+            return !animation.second;
+        }),
+        m_animations.end()
+    );
+}
+
+void FrameScheduler::painted(Rect const& rect) {
+    if (!m_damage.IsEmptyArea() && rect.Contains(m_damage)) {
+        m_damage = Rect();
+    }
+}
+
+void FrameScheduler::laidOut() {
+    m_layoutPending = false;
+}
+
+bool FrameScheduler::tick() {
+    if (!m_scheduled) return false;
+    m_scheduled = false;
+    if (!this->pending()) return false;
+
+    auto now = m_clock->now();
+    if (m_hasFrame && now < m_lastFrame + this->interval()) {
+        // woken up early, which timers are allowed to do
+        this->schedule();
+        return false;
+    }
+    m_hasFrame = true;
+    m_lastFrame = now;
+    m_stats.m_frames++;
+
+    m_inFrame = true;
+    // input can change both layout and paint, so it goes before either
+    if (m_inputPending) {
+        m_inputPending = false;
+        if (m_input) m_input();
+    }
+    if (m_animations.size()) {
+        this->animate(now);
+    }
+    // then layout, so the damage it causes is painted in the same frame
+    if (m_layoutPending) {
+        m_layoutPending = false;
+        if (m_layout) m_layout();
+    }
+    auto damage = m_damage;
+    m_damage = Rect();
+    if (!damage.IsEmptyArea() && m_paint) {
+        m_paint(damage);
+    }
+    m_inFrame = false;
+
+    if (this->pending()) {
+        this->schedule();
+    }
+    return true;
+}
+
+bool FrameScheduler::pending() const {
+    return
+        m_inputPending || m_layoutPending ||
+        !m_damage.IsEmptyArea() || m_animations.size();
+}
+
+Rect const& FrameScheduler::damage() const {
+    return m_damage;
+}
+
+void FrameScheduler::maxFps(int fps) {
+    m_maxFps = fps;
+}
+
+int FrameScheduler::maxFps() const {
+    return m_maxFps;
+}
+
+Clock& FrameScheduler::clock() const {
+    return *m_clock;
+}
+
+FrameScheduler::Stats const& FrameScheduler::stats() const {
+    return m_stats;
+}
+
+void FrameScheduler::resetStats() {
+    m_stats = Stats();
+}
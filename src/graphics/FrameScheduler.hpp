@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Types.hpp"
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Milliseconds since some fixed point
+class Clock {
+public:
+    virtual ~Clock() = default;
+    virtual double now() const = 0;
+};
+
+class SteadyClock : public Clock {
+public:
+    double now() const override;
+};
+
+// Only moves when told to, so frame timing can be stepped through by hand
+class VirtualClock : public Clock {
+protected:
+    double m_now = 0.0;
+
+public:
+    double now() const override;
+    void advance(double ms);
+};
+
+// Collects damage and layout requests and turns them into at most one
+// frame per interval. The scheduler doesn't know about windows; it asks
+// to be woken up through the wake callback, and tick() is expected to
+// be called once that delay has passed
+class FrameScheduler {
+public:
+    // asks for tick() to be called after delay milliseconds
+    using Wake = std::function<void(unsigned int delay)>;
+    using Input = std::function<void()>;
+    using Layout = std::function<void()>;
+    using Paint = std::function<void(Rect const& damage)>;
+    // called with the frame's time, returns whether it wants another frame
+    using Animation = std::function<bool(double now)>;
+
+    struct Stats {
+        size_t m_inputRequests = 0;
+        size_t m_invalidations = 0;
+        size_t m_layoutRequests = 0;
+        size_t m_animationSteps = 0;
+        size_t m_wakes = 0;
+        size_t m_frames = 0;
+    };
+
+    static constexpr int s_defaultMaxFps = 60;
+
+protected:
+    std::unique_ptr<Clock> m_clock;
+    Wake m_wake;
+    Input m_input;
+    Layout m_layout;
+    Paint m_paint;
+    Rect m_damage;
+    std::vector<std::pair<size_t, Animation>> m_animations;
+    size_t m_nextAnimation = 1;
+    bool m_inputPending = false;
+    bool m_layoutPending = false;
+    bool m_scheduled = false;
+    bool m_inFrame = false;
+    bool m_hasFrame = false;
+    double m_lastFrame = 0.0;
+    int m_maxFps = s_defaultMaxFps;
+    Stats m_stats;
+
+    double interval() const;
+    void schedule();
+    void animate(double now);
+
+public:
+    FrameScheduler(std::unique_ptr<Clock> clock = std::make_unique<SteadyClock>());
+
+    void wake(Wake wake);
+    void input(Input input);
+    void layout(Layout layout);
+    void paint(Paint paint);
+
+    void invalidate(Rect const& rect);
+    // coalesced input is dispatched at the start of the next frame
+    void requestInput();
+    void requestLayout();
+    // Runs animation at the start of every frame, after input and before
+    // layout, for as long as it keeps returning true. Returns an id that
+    // stops it early when cancelled
+    size_t animate(Animation animation);
+    void cancel(size_t id);
+    // tells the scheduler an area was painted outside of
+    // a frame, i.e. because the system asked for it
+    void painted(Rect const& rect);
+    // same for layout, which drops the pending layout request
+    void laidOut();
+
+    // Runs the pending layout and paint if the interval has passed,
+    // otherwise asks to be woken up again. Returns whether a frame ran
+    bool tick();
+
+    bool pending() const;
+    Rect const& damage() const;
+
+    // 0 for no cap
+    void maxFps(int fps);
+    int maxFps() const;
+    Clock& clock() const;
+
+    Stats const& stats() const;
+    void resetStats();
+};
@@ -0,0 +1,240 @@
+#include "GdiCanvas.hpp"
+#include <cstdlib>
+
+// what layers and scroll surfaces are drawn into and kept as
+struct BitmapSurface : public LayerCache::Surface {
+    Bitmap m_bitmap;
+
+    BitmapSurface(int width, int height)
+      : m_bitmap(width, height, PixelFormat32bppPARGB) {}
+};
+
+static Bitmap* bitmapOf(LayerCache::Surface* surface) {
+    return &static_cast<BitmapSurface*>(surface)->m_bitmap;
+}
+
+GdiCanvas::GdiCanvas(HDC hdc, PaintPool& pool, LayerCache* layers, Rect const& dirty)
+  : m_hdc(hdc), m_graphics(hdc), m_pool(pool), m_layers(layers), m_dirty(dirty) {
+    InitGraphics(m_graphics);
+}
+
+GdiCanvas::GdiCanvas(Bitmap* bitmap, HDC hdc, PaintPool& pool, Rect const& dirty)
+  : m_hdc(hdc), m_graphics(bitmap), m_pool(pool), m_layers(nullptr),
+    m_dirty(dirty) {
+    InitGraphics(m_graphics);
+    // ClearType needs an opaque background to blend against
+    m_graphics.SetTextRenderingHint(TextRenderingHintAntiAliasGridFit);
+}
+
+Brush const* GdiCanvas::brush(Fill const& fill) {
+    if (fill.m_gradient) {
+        return m_pool.gradient(
+            fill.m_point1, fill.m_point2, fill.m_color1, fill.m_color2
+        );
+    }
+    return m_pool.brush(fill.m_color1);
+}
+
+void GdiCanvas::fillRect(RectF const& rect, Fill const& fill) {
+    m_graphics.FillRectangle(this->brush(fill), rect);
+}
+
+void GdiCanvas::strokeRect(RectF const& rect, Color const& color, REAL width) {
+    m_graphics.DrawRectangle(m_pool.pen(color, width), rect);
+}
+
+void GdiCanvas::fillRoundRect(Rect const& rect, int radius, Fill const& fill) {
+    FillRoundRect(&m_graphics, rect, *this->brush(fill), radius, radius * 2);
+}
+
+void GdiCanvas::strokeRoundRect(Rect const& rect, int radius, Color const& color) {
+    DrawRoundRect(&m_graphics, rect, *m_pool.pen(color), radius, radius * 2);
+}
+
+void GdiCanvas::fillEllipse(RectF const& rect, Fill const& fill) {
+    m_graphics.FillEllipse(this->brush(fill), rect);
+}
+
+void GdiCanvas::strokePath(Path const& path, Color const& color, REAL width) {
+    auto& points = path.points();
+    auto& figures = path.figures();
+    GraphicsPath gpath;
+    for (size_t i = 0; i < figures.size(); i++) {
+        auto end = i + 1 < figures.size() ? figures[i + 1] : points.size();
+        if (end - figures[i] < 2) continue;
+        gpath.StartFigure();
+        gpath.AddLines(&points[figures[i]], static_cast<int>(end - figures[i]));
+    }
+    m_graphics.DrawPath(m_pool.pen(color, width), &gpath);
+}
+
+void GdiCanvas::drawText(
+    std::wstring const& text,
+    std::wstring const& font,
+    int size,
+    int style,
+    Color const& color,
+    RectF const& rect,
+    TextLayout const& layout
+) {
+    auto f = m_pool.font(m_hdc, font, size, style);
+    auto format = m_pool.format(
+        layout.m_alignment, layout.m_lineAlignment,
+        layout.m_trimming, layout.m_flags
+    );
+    auto brush = m_pool.brush(color);
+    if (layout.m_wrap) {
+        m_graphics.DrawString(text.c_str(), -1, f, rect, format, brush);
+    } else {
+        auto state = m_graphics.Save();
+        m_graphics.IntersectClip(rect);
+        m_graphics.DrawString(
+            text.c_str(), -1, f, PointF(rect.X, rect.Y), format, brush
+        );
+        m_graphics.Restore(state);
+    }
+}
+
+void GdiCanvas::save() {
+    m_states.push_back(m_graphics.Save());
+}
+
+void GdiCanvas::restore() {
+    if (m_states.empty()) return;
+    m_graphics.Restore(m_states.back());
+    m_states.pop_back();
+}
+
+void GdiCanvas::clipRect(Rect const& rect) {
+    m_graphics.IntersectClip(rect);
+}
+
+void GdiCanvas::translate(REAL dx, REAL dy) {
+    m_graphics.TranslateTransform(dx, dy);
+}
+
+void GdiCanvas::rotate(REAL degrees) {
+    m_graphics.RotateTransform(degrees);
+}
+
+void GdiCanvas::drawLayer(
+    uintptr_t key,
+    std::shared_ptr<RecordingCanvas const> const& list,
+    Point const& offset,
+    Rect const& bounds
+) {
+    if (
+        !m_layers || bounds.IsEmptyArea() ||
+        LayerCache::bytes(bounds) > m_layers->budget()
+    ) {
+        return this->drawList(list, offset, bounds);
+    }
+    Rect moved(
+        bounds.X + m_listOffset.X + offset.X,
+        bounds.Y + m_listOffset.Y + offset.Y,
+        bounds.Width, bounds.Height
+    );
+    if (!moved.IntersectsWith(this->cull())) {
+        m_culledLists++;
+        return;
+    }
+
+    auto found = m_layers->find(key, list, bounds);
+    if (!found) {
+        auto surface = std::make_unique<BitmapSurface>(bounds.Width, bounds.Height);
+        {
+            GdiCanvas layer(&surface->m_bitmap, m_hdc, m_pool);
+            layer.translate(static_cast<REAL>(-bounds.X), static_cast<REAL>(-bounds.Y));
+            list->replay(layer);
+        }
+        found = m_layers->store(key, list, bounds, std::move(surface));
+    }
+    m_graphics.DrawImage(bitmapOf(found), bounds.X + offset.X, bounds.Y + offset.Y);
+}
+
+void GdiCanvas::drawScrolled(
+    uintptr_t key,
+    std::shared_ptr<RecordingCanvas const> const& list,
+    Point const& offset,
+    Rect const& bounds,
+    Rect const& viewport
+) {
+    // both surfaces have to fit
+    if (
+        !m_layers || viewport.IsEmptyArea() ||
+        LayerCache::bytes(viewport) * 2 > m_layers->budget()
+    ) {
+        return Canvas::drawScrolled(key, list, offset, bounds, viewport);
+    }
+    Rect moved(
+        viewport.X + m_listOffset.X, viewport.Y + m_listOffset.Y,
+        viewport.Width, viewport.Height
+    );
+    if (!moved.IntersectsWith(this->cull())) {
+        m_culledLists++;
+        return;
+    }
+
+    auto width = viewport.Width;
+    auto height = viewport.Height;
+    auto& surface = m_layers->scrollSurface(key, width, height);
+    if (!surface.m_front) {
+        surface.m_front = std::make_unique<BitmapSurface>(width, height);
+        surface.m_back = std::make_unique<BitmapSurface>(width, height);
+    }
+    // where the list goes inside of the surface
+    Point origin(offset.X - viewport.X, offset.Y - viewport.Y);
+    auto dx = origin.X - surface.m_origin.X;
+    auto dy = origin.Y - surface.m_origin.Y;
+    auto scrolled = surface.m_list && (dx || dy);
+    // anything else in the list changing, or the surface being made
+    // anew, means it all has to be painted again
+    auto reusable =
+        surface.m_list == list &&
+        std::abs(dx) < width && std::abs(dy) < height;
+
+    std::vector<Rect> strips;
+    if (!reusable) {
+        strips.push_back(Rect(0, 0, width, height));
+    } else if (dx || dy) {
+        {
+            Graphics shift(bitmapOf(surface.m_back.get()));
+            shift.SetCompositingMode(CompositingModeSourceCopy);
+            shift.DrawImage(bitmapOf(surface.m_front.get()), dx, dy);
+        }
+        std::swap(surface.m_front, surface.m_back);
+        // scrolling diagonally uncovers an L, as two strips
+        // that both go over the corner they share
+        if (dx > 0) strips.push_back(Rect(0, 0, dx, height));
+        if (dx < 0) strips.push_back(Rect(width + dx, 0, -dx, height));
+        if (dy > 0) strips.push_back(Rect(0, 0, width, dy));
+        if (dy < 0) strips.push_back(Rect(0, height + dy, width, -dy));
+    }
+    for (auto& strip : strips) {
+        GdiCanvas layer(bitmapOf(surface.m_front.get()), m_hdc, m_pool, strip);
+        layer.graphics().SetClip(strip);
+        layer.graphics().Clear(Color(0, 0, 0, 0));
+        layer.drawList(list, origin, bounds);
+    }
+    surface.m_list = list;
+    surface.m_origin = origin;
+    if (scrolled) {
+        auto area = static_cast<size_t>(width) * height;
+        auto shifted = reusable ?
+            static_cast<size_t>(width - std::abs(dx)) * (height - std::abs(dy)) : 0;
+        m_layers->scrolled(area - shifted, shifted);
+    }
+    m_graphics.DrawImage(bitmapOf(surface.m_front.get()), viewport.X, viewport.Y);
+}
+
+Rect GdiCanvas::dirty() const {
+    return m_dirty;
+}
+
+void* GdiCanvas::device() const {
+    return m_hdc;
+}
+
+Graphics& GdiCanvas::graphics() {
+    return m_graphics;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Windows.h>
+#include <utils.hpp>
+#include <vector>
+#include "Canvas.hpp"
+#include "PaintPool.hpp"
+#include "LayerCache.hpp"
+
+// Draws straight to an HDC through one Graphics for the whole frame,
+// with brushes, pens and fonts coming from the window's PaintPool
+class GdiCanvas : public Canvas {
+protected:
+    HDC m_hdc;
+    Graphics m_graphics;
+    PaintPool& m_pool;
+    LayerCache* m_layers;
+    Rect m_dirty;
+    std::vector<GraphicsState> m_states;
+
+    Brush const* brush(Fill const& fill);
+
+public:
+    GdiCanvas(HDC hdc, PaintPool& pool, LayerCache* layers, Rect const& dirty);
+    // draws into a layer surface, hdc is only used for fonts and measuring
+    GdiCanvas(
+        Bitmap* bitmap, HDC hdc, PaintPool& pool,
+        Rect const& dirty = RecordingCanvas::everything()
+    );
+
+    void fillRect(RectF const& rect, Fill const& fill) override;
+    void strokeRect(RectF const& rect, Color const& color, REAL width = 1.f) override;
+    void fillRoundRect(Rect const& rect, int radius, Fill const& fill) override;
+    void strokeRoundRect(Rect const& rect, int radius, Color const& color) override;
+    void fillEllipse(RectF const& rect, Fill const& fill) override;
+    void strokePath(Path const& path, Color const& color, REAL width = 1.f) override;
+    void drawText(
+        std::wstring const& text,
+        std::wstring const& font,
+        int size,
+        int style,
+        Color const& color,
+        RectF const& rect,
+        TextLayout const& layout
+    ) override;
+
+    void save() override;
+    void restore() override;
+    void clipRect(Rect const& rect) override;
+    void translate(REAL dx, REAL dy) override;
+    void rotate(REAL degrees) override;
+    void drawLayer(
+        uintptr_t key,
+        std::shared_ptr<RecordingCanvas const> const& list,
+        Point const& offset,
+        Rect const& bounds
+    ) override;
+    void drawScrolled(
+        uintptr_t key,
+        std::shared_ptr<RecordingCanvas const> const& list,
+        Point const& offset,
+        Rect const& bounds,
+        Rect const& viewport
+    ) override;
+
+    Rect dirty() const override;
+    void* device() const override;
+
+    Graphics& graphics();
+};
@@ -0,0 +1,19 @@
+#include "GdiTextMeasurer.hpp"
+#include "../Manager.hpp"
+
+TextSize GdiTextMeasurer::measure(TextQuery const& query, void* device) {
+    auto hdc = static_cast<HDC>(device);
+    Graphics g(hdc);
+    InitGraphics(g);
+    StringFormat format(StringFormatFlagsMeasureTrailingSpaces);
+    Font font(hdc, Manager::get()->loadFont(query.m_font, query.m_size, query.m_style));
+    // a zero extent means unbounded to GDI+; the height is always
+    // left open and callers clamp to the space they actually have
+    RectF layout;
+    if (query.m_width > 0) {
+        layout.Width = static_cast<REAL>(query.m_width);
+    }
+    RectF r;
+    g.MeasureString(query.m_text.c_str(), -1, &font, layout, &format, &r);
+    return { r.Width, r.Height };
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <Windows.h>
+#include <utils.hpp>
+#include "TextCache.hpp"
+
+class GdiTextMeasurer : public TextMeasurer {
+public:
+    TextSize measure(TextQuery const& query, void* device) override;
+};
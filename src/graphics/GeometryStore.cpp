@@ -0,0 +1,116 @@
+#include "GeometryStore.hpp"
+
+void GeometryStore::grow(uint32_t slot) {
+    if (slot < m_flags.size()) return;
+    auto size = static_cast<size_t>(slot) + 1;
+    m_x.resize(size);
+    m_y.resize(size);
+    m_width.resize(size);
+    m_height.resize(size);
+    m_offsetX.resize(size);
+    m_offsetY.resize(size);
+    m_flags.resize(size);
+}
+
+void GeometryStore::attach(uint32_t slot) {
+    this->grow(slot);
+    m_x[slot] = m_y[slot] = 0;
+    m_width[slot] = m_height[slot] = 0;
+    m_offsetX[slot] = m_offsetY[slot] = 0;
+    if (!(m_flags[slot] & Live)) m_live++;
+    m_flags[slot] = Live;
+}
+
+void GeometryStore::detach(uint32_t slot) {
+    if (slot < m_flags.size() && (m_flags[slot] & Live)) {
+        m_flags[slot] = 0;
+        m_live--;
+    }
+}
+
+void GeometryStore::take(GeometryStore& other, uint32_t slot) {
+    if (&other == this) return;
+    this->attach(slot);
+    if (slot < other.m_flags.size() && (other.m_flags[slot] & Live)) {
+        m_x[slot] = other.m_x[slot];
+        m_y[slot] = other.m_y[slot];
+        m_width[slot] = other.m_width[slot];
+        m_height[slot] = other.m_height[slot];
+        m_offsetX[slot] = other.m_offsetX[slot];
+        m_offsetY[slot] = other.m_offsetY[slot];
+        m_flags[slot] = other.m_flags[slot];
+        other.detach(slot);
+    }
+}
+
+int& GeometryStore::x(uint32_t slot) { return m_x[slot]; }
+int& GeometryStore::y(uint32_t slot) { return m_y[slot]; }
+int& GeometryStore::width(uint32_t slot) { return m_width[slot]; }
+int& GeometryStore::height(uint32_t slot) { return m_height[slot]; }
+int& GeometryStore::offsetX(uint32_t slot) { return m_offsetX[slot]; }
+int& GeometryStore::offsetY(uint32_t slot) { return m_offsetY[slot]; }
+int GeometryStore::x(uint32_t slot) const { return m_x[slot]; }
+int GeometryStore::y(uint32_t slot) const { return m_y[slot]; }
+int GeometryStore::width(uint32_t slot) const { return m_width[slot]; }
+int GeometryStore::height(uint32_t slot) const { return m_height[slot]; }
+int GeometryStore::offsetX(uint32_t slot) const { return m_offsetX[slot]; }
+int GeometryStore::offsetY(uint32_t slot) const { return m_offsetY[slot]; }
+
+void GeometryStore::flag(uint32_t slot, uint8_t flag, bool set) {
+    if (set) {
+        m_flags[slot] |= flag;
+    } else {
+        m_flags[slot] &= ~flag;
+    }
+}
+
+bool GeometryStore::flag(uint32_t slot, uint8_t flag) const {
+    return m_flags[slot] & flag;
+}
+
+template<class Test>
+void GeometryStore::scan(uint8_t flags, std::vector<uint32_t>& out, Test test) const {
+    // the tests are written into a byte per slot without branching,
+    // which lets the compiler vectorize the loop, and only then collected
+    auto count = m_flags.size();
+    m_hits.resize(count);
+    auto want = static_cast<uint8_t>(flags | Live);
+    for (size_t i = 0; i < count; i++) {
+        m_hits[i] = ((m_flags[i] & want) == want) & test(i);
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (m_hits[i]) out.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+void GeometryStore::query(Point const& p, uint8_t flags, std::vector<uint32_t>& out) const {
+    auto ox = m_offsetX.data();
+    auto oy = m_offsetY.data();
+    auto w = m_width.data();
+    auto h = m_height.data();
+    this->scan(flags, out, [&](size_t i) -> uint8_t {
+        return
+            (p.X >= ox[i]) & (p.X < ox[i] + w[i]) &
+            (p.Y >= oy[i]) & (p.Y < oy[i] + h[i]);
+    });
+}
+
+void GeometryStore::query(Rect const& rect, uint8_t flags, std::vector<uint32_t>& out) const {
+    auto ox = m_offsetX.data();
+    auto oy = m_offsetY.data();
+    auto w = m_width.data();
+    auto h = m_height.data();
+    this->scan(flags, out, [&](size_t i) -> uint8_t {
+        return
+            (ox[i] < rect.X + rect.Width) & (rect.X < ox[i] + w[i]) &
+            (oy[i] < rect.Y + rect.Height) & (rect.Y < oy[i] + h[i]);
+    });
+}
+
+size_t GeometryStore::size() const {
+    return m_flags.size();
+}
+
+size_t GeometryStore::live() const {
+    return m_live;
+}
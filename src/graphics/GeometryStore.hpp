@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Widget geometry kept as parallel arrays indexed by slot, so passes
+// over every widget are linear scans over a few ints each instead of
+// a walk through scattered widget objects. Each window has one for the
+// widgets in it, so offsets in a store are all in the same coordinates
+class GeometryStore {
+public:
+    enum Flags : uint8_t {
+        Live = 1,
+        Visible = 2,
+        WantsMouse = 4,
+    };
+
+protected:
+    std::vector<int> m_x;
+    std::vector<int> m_y;
+    std::vector<int> m_width;
+    std::vector<int> m_height;
+    // position in window coordinates
+    std::vector<int> m_offsetX;
+    std::vector<int> m_offsetY;
+    std::vector<uint8_t> m_flags;
+    size_t m_live = 0;
+    mutable std::vector<uint8_t> m_hits;
+
+    void grow(uint32_t slot);
+    template<class Test>
+    void scan(uint8_t flags, std::vector<uint32_t>& out, Test test) const;
+
+public:
+    // zeroes the slot and marks it live, growing the arrays if needed
+    void attach(uint32_t slot);
+    void detach(uint32_t slot);
+    // moves the slot's row over from other, for a widget changing windows
+    void take(GeometryStore& other, uint32_t slot);
+
+    int& x(uint32_t slot);
+    int& y(uint32_t slot);
+    int& width(uint32_t slot);
+    int& height(uint32_t slot);
+    int& offsetX(uint32_t slot);
+    int& offsetY(uint32_t slot);
+    int x(uint32_t slot) const;
+    int y(uint32_t slot) const;
+    int width(uint32_t slot) const;
+    int height(uint32_t slot) const;
+    int offsetX(uint32_t slot) const;
+    int offsetY(uint32_t slot) const;
+
+    void flag(uint32_t slot, uint8_t flag, bool set);
+    bool flag(uint32_t slot, uint8_t flag) const;
+
+    // Appends the live slots with all of flags set whose rect in window
+    // coordinates contains p, or intersects rect, in slot order
+    void query(Point const& p, uint8_t flags, std::vector<uint32_t>& out) const;
+    void query(Rect const& rect, uint8_t flags, std::vector<uint32_t>& out) const;
+
+    // number of slots, live or not
+    size_t size() const;
+    size_t live() const;
+};
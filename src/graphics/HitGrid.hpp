@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Types.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Uniform grid over rects for point queries. Items go into every cell
+// their rect touches, so a lookup only has to look at the handful of
+// items sharing the point's cell instead of everything
+template<class T>
+class HitGrid {
+public:
+    static constexpr int s_cellSize = 64;
+
+protected:
+    std::unordered_map<T, Rect> m_items;
+    std::unordered_map<uint64_t, std::vector<T>> m_cells;
+
+    static int cell(int v) {
+        return v >= 0 ? v / s_cellSize : (v - s_cellSize + 1) / s_cellSize;
+    }
+    static uint64_t key(int cx, int cy) {
+        return
+            (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) |
+            static_cast<uint32_t>(cy);
+    }
+    template<class F>
+    static void forCells(Rect const& r, F func) {
+        if (r.IsEmptyArea()) return;
+        auto x2 = cell(r.X + r.Width - 1);
+        auto y2 = cell(r.Y + r.Height - 1);
+        for (auto cx = cell(r.X); cx <= x2; cx++) {
+            for (auto cy = cell(r.Y); cy <= y2; cy++) {
+                func(key(cx, cy));
+            }
+        }
+    }
+
+public:
+    // adds the item or moves it if it's already in
+    void insert(T item, Rect const& rect) {
+        auto it = m_items.find(item);
+        if (it != m_items.end()) {
+            auto& old = it->second;
+            if (
+                old.X == rect.X && old.Y == rect.Y &&
+                old.Width == rect.Width && old.Height == rect.Height
+            ) return;
+            this->remove(item);
+        }
+        m_items.insert({ item, rect });
+        HitGrid::forCells(rect, [&](uint64_t k) {
+            m_cells[k].push_back(item);
+        });
+    }
+
+    void remove(T item) {
+        auto it = m_items.find(item);
+        if (it == m_items.end()) return;
+        HitGrid::forCells(it->second, [&](uint64_t k) {
+            auto cell = m_cells.find(k);
+            if (cell == m_cells.end()) return;
+            auto& items = cell->second;
+            items.erase(std::remove(items.begin(), items.end(), item), items.end());
+            if (items.empty()) m_cells.erase(cell);
+        });
+        m_items.erase(it);
+    }
+
+    bool contains(T item) const {
+        return m_items.count(item);
+    }
+
+    void clear() {
+        m_items.clear();
+        m_cells.clear();
+    }
+
+    size_t size() const {
+        return m_items.size();
+    }
+
+    // appends every item whose rect contains p, in no particular order
+    void query(Point const& p, std::vector<T>& out) const {
+        auto cell = m_cells.find(key(HitGrid::cell(p.X), HitGrid::cell(p.Y)));
+        if (cell == m_cells.end()) return;
+        for (auto& item : cell->second) {
+            auto& r = m_items.at(item);
+            if (
+                p.X >= r.X && p.X < r.X + r.Width &&
+                p.Y >= r.Y && p.Y < r.Y + r.Height
+            ) {
+                out.push_back(item);
+            }
+        }
+    }
+};
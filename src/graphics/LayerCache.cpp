@@ -0,0 +1,138 @@
+#include "LayerCache.hpp"
+
+float LayerCache::Stats::hitRate() const {
+    auto total = m_hits + m_misses;
+    return total ? static_cast<float>(m_hits) / total : 0.f;
+}
+
+float LayerCache::Stats::repaintedPerScroll() const {
+    return m_scrollSteps ? static_cast<float>(m_scrollRepainted) / m_scrollSteps : 0.f;
+}
+
+LayerCache::LayerCache(size_t budget) : m_budget(budget) {}
+
+size_t LayerCache::bytes(Rect const& bounds) {
+    return static_cast<size_t>(bounds.Width) * bounds.Height * 4;
+}
+
+void LayerCache::erase(Layers::iterator it) {
+    m_bytes -= it->m_bytes;
+    m_index.erase(it->m_key);
+    m_layers.erase(it);
+}
+
+void LayerCache::trim() {
+    while (m_bytes > m_budget && m_layers.size()) {
+        this->erase(std::prev(m_layers.end()));
+        m_stats.m_evictions++;
+    }
+}
+
+LayerCache::Surface* LayerCache::find(
+    uintptr_t key,
+    std::shared_ptr<RecordingCanvas const> const& list,
+    Rect const& bounds
+) {
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        auto& layer = *it->second;
+        if (
+            layer.m_list == list &&
+            layer.m_bounds.Width == bounds.Width &&
+            layer.m_bounds.Height == bounds.Height
+        ) {
+            m_stats.m_hits++;
+            m_layers.splice(m_layers.begin(), m_layers, it->second);
+            return layer.m_surface.get();
+        }
+        // stale, it's about to be rendered again anyway
+        this->erase(it->second);
+    }
+    m_stats.m_misses++;
+    return nullptr;
+}
+
+LayerCache::Surface* LayerCache::store(
+    uintptr_t key,
+    std::shared_ptr<RecordingCanvas const> const& list,
+    Rect const& bounds,
+    std::unique_ptr<Surface> surface
+) {
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        this->erase(it->second);
+    }
+    auto size = LayerCache::bytes(bounds);
+    auto ret = surface.get();
+    m_layers.push_front({ key, list, bounds, std::move(surface), size });
+    m_index[key] = m_layers.begin();
+    m_bytes += size;
+    this->trim();
+    return ret;
+}
+
+LayerCache::ScrollSurface& LayerCache::scrollSurface(uintptr_t key, int width, int height) {
+    auto& surface = m_scrollSurfaces[key];
+    if (surface.m_width != width || surface.m_height != height) {
+        m_bytes -= surface.m_bytes;
+        surface.m_list = nullptr;
+        surface.m_front = nullptr;
+        surface.m_back = nullptr;
+        surface.m_width = width;
+        surface.m_height = height;
+        surface.m_bytes = LayerCache::bytes(Rect(0, 0, width, height)) * 2;
+        m_bytes += surface.m_bytes;
+        this->trim();
+    }
+    return surface;
+}
+
+void LayerCache::drop(uintptr_t key) {
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        this->erase(it->second);
+    }
+    auto surface = m_scrollSurfaces.find(key);
+    if (surface != m_scrollSurfaces.end()) {
+        m_bytes -= surface->second.m_bytes;
+        m_scrollSurfaces.erase(surface);
+    }
+}
+
+void LayerCache::clear() {
+    m_layers.clear();
+    m_scrollSurfaces.clear();
+    m_index.clear();
+    m_bytes = 0;
+}
+
+void LayerCache::budget(size_t bytes) {
+    m_budget = bytes;
+    this->trim();
+}
+
+size_t LayerCache::budget() const {
+    return m_budget;
+}
+
+size_t LayerCache::bytes() const {
+    return m_bytes;
+}
+
+size_t LayerCache::size() const {
+    return m_layers.size();
+}
+
+void LayerCache::scrolled(size_t repainted, size_t shifted) {
+    m_stats.m_scrollSteps++;
+    m_stats.m_scrollRepainted += repainted;
+    m_stats.m_scrollShifted += shifted;
+}
+
+LayerCache::Stats const& LayerCache::stats() const {
+    return m_stats;
+}
+
+void LayerCache::resetStats() {
+    m_stats = Stats();
+}
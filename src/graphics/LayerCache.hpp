@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Types.hpp"
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include "RecordingCanvas.hpp"
+
+// Offscreen surfaces for subtrees painted as layers. A layer is only
+// good for as long as it was rendered from the same display list, so
+// re-recording a subtree is all it takes to invalidate its layer. Keys
+// are widget handles, which aren't reused the way addresses are
+class LayerCache {
+public:
+    // backend-specific pixels (i.e. a Bitmap) made and drawn by
+    // whoever draws the layers, the cache only keeps count of them
+    struct Surface {
+        virtual ~Surface() = default;
+    };
+
+    struct Stats {
+        size_t m_hits = 0;
+        size_t m_misses = 0;
+        size_t m_evictions = 0;
+        // times a scrolled surface was drawn at a new offset, and the
+        // pixels that were painted again for it versus shifted over
+        size_t m_scrollSteps = 0;
+        size_t m_scrollRepainted = 0;
+        size_t m_scrollShifted = 0;
+
+        float hitRate() const;
+        float repaintedPerScroll() const;
+    };
+
+    // What's in a scrolled viewport. Shifting it is drawn from front into
+    // back, since GDI+ can't draw a bitmap onto itself, and then swapped
+    struct ScrollSurface {
+        std::shared_ptr<RecordingCanvas const> m_list;
+        // where the list was drawn inside of the surface
+        Point m_origin;
+        std::unique_ptr<Surface> m_front;
+        std::unique_ptr<Surface> m_back;
+        int m_width = 0;
+        int m_height = 0;
+        size_t m_bytes = 0;
+    };
+
+    static constexpr size_t s_defaultBudget = 32 * 1024 * 1024;
+
+protected:
+    struct Layer {
+        uintptr_t m_key;
+        std::shared_ptr<RecordingCanvas const> m_list;
+        Rect m_bounds;
+        std::unique_ptr<Surface> m_surface;
+        size_t m_bytes;
+    };
+    using Layers = std::list<Layer>;
+
+    Layers m_layers;
+    std::unordered_map<uintptr_t, Layers::iterator> m_index;
+    size_t m_budget;
+    size_t m_bytes = 0;
+    // kept apart from the layers, since they go away with their
+    // widget rather than by age, but counted in m_bytes all the same
+    std::unordered_map<uintptr_t, ScrollSurface> m_scrollSurfaces;
+    Stats m_stats;
+
+    void erase(Layers::iterator it);
+    void trim();
+
+public:
+    LayerCache(size_t budget = s_defaultBudget);
+
+    static size_t bytes(Rect const& bounds);
+
+    // the layer for key if it was rendered from list at the same
+    // size, or null; counts towards the hit rate either way
+    Surface* find(
+        uintptr_t key,
+        std::shared_ptr<RecordingCanvas const> const& list,
+        Rect const& bounds
+    );
+    Surface* store(
+        uintptr_t key,
+        std::shared_ptr<RecordingCanvas const> const& list,
+        Rect const& bounds,
+        std::unique_ptr<Surface> surface
+    );
+    // The scroll surface under key, counted as two width by height
+    // surfaces. Whenever the size changes it's emptied, bitmaps and all,
+    // and it's up to the caller to make and fill them in again. Layers
+    // are evicted to make room for it
+    ScrollSurface& scrollSurface(uintptr_t key, int width, int height);
+    // drops both the layer and the scroll surface under key
+    void drop(uintptr_t key);
+    void clear();
+
+    void budget(size_t bytes);
+    size_t budget() const;
+    // memory currently taken up by layers and scroll surfaces
+    size_t bytes() const;
+    size_t size() const;
+
+    // counts a scroll step for the stats
+    void scrolled(size_t repainted, size_t shifted);
+
+    Stats const& stats() const;
+    void resetStats();
+};
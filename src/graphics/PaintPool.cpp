@@ -0,0 +1,128 @@
+#include "PaintPool.hpp"
+#include "../Manager.hpp"
+#include <Style.hpp>
+#include <cstring>
+
+bool PaintPool::GradientKey::operator==(GradientKey const& other) const {
+    return
+        m_x1 == other.m_x1 && m_y1 == other.m_y1 &&
+        m_x2 == other.m_x2 && m_y2 == other.m_y2 &&
+        m_c1 == other.m_c1 && m_c2 == other.m_c2;
+}
+
+size_t PaintPool::GradientKeyHash::operator()(GradientKey const& key) const {
+    size_t h = 5381;
+    for (auto v : { key.m_x1, key.m_y1, key.m_x2, key.m_y2 }) {
+        h = h * 33 + static_cast<size_t>(v);
+    }
+    h = h * 33 + key.m_c1;
+    h = h * 33 + key.m_c2;
+    return h;
+}
+
+SolidBrush const* PaintPool::brush(Color const& color) {
+    auto key = color.GetValue();
+    auto it = m_brushes.find(key);
+    if (it != m_brushes.end()) {
+        m_stats.m_reused++;
+        return it->second.get();
+    }
+    this->makeRoom(m_brushes);
+    m_stats.m_created++;
+    auto brush = new SolidBrush(color);
+    m_brushes[key] = std::unique_ptr<SolidBrush>(brush);
+    return brush;
+}
+
+Pen const* PaintPool::pen(Color const& color, REAL width) {
+    uint32_t bits;
+    std::memcpy(&bits, &width, sizeof bits);
+    auto key = (static_cast<uint64_t>(color.GetValue()) << 32) | bits;
+    auto it = m_pens.find(key);
+    if (it != m_pens.end()) {
+        m_stats.m_reused++;
+        return it->second.get();
+    }
+    this->makeRoom(m_pens);
+    m_stats.m_created++;
+    auto pen = new Pen(color, width);
+    m_pens[key] = std::unique_ptr<Pen>(pen);
+    return pen;
+}
+
+LinearGradientBrush const* PaintPool::gradient(
+    Point const& p1, Point const& p2,
+    Color const& c1, Color const& c2
+) {
+    GradientKey key { p1.X, p1.Y, p2.X, p2.Y, c1.GetValue(), c2.GetValue() };
+    auto it = m_gradients.find(key);
+    if (it != m_gradients.end()) {
+        m_stats.m_reused++;
+        return it->second.get();
+    }
+    this->makeRoom(m_gradients);
+    m_stats.m_created++;
+    auto brush = new LinearGradientBrush(p1, p2, c1, c2);
+    m_gradients[key] = std::unique_ptr<LinearGradientBrush>(brush);
+    return brush;
+}
+
+Font const* PaintPool::font(HDC hdc, std::wstring const& face, int size, int style) {
+    auto key = face + L"_" + std::to_wstring(size) + L"_" + std::to_wstring(style);
+    auto it = m_fonts.find(key);
+    if (it != m_fonts.end()) {
+        m_stats.m_reused++;
+        return it->second.get();
+    }
+    this->makeRoom(m_fonts);
+    m_stats.m_created++;
+    auto font = new Font(hdc, Manager::get()->loadFont(face, size, style));
+    m_fonts[key] = std::unique_ptr<Font>(font);
+    return font;
+}
+
+StringFormat const* PaintPool::format(
+    StringAlignment alignment,
+    StringAlignment lineAlignment,
+    StringTrimming trimming,
+    int flags
+) {
+    auto key =
+        (static_cast<uint64_t>(alignment) << 56) |
+        (static_cast<uint64_t>(lineAlignment) << 48) |
+        (static_cast<uint64_t>(trimming) << 40) |
+        static_cast<uint32_t>(flags);
+    auto it = m_formats.find(key);
+    if (it != m_formats.end()) {
+        m_stats.m_reused++;
+        return it->second.get();
+    }
+    this->makeRoom(m_formats);
+    m_stats.m_created++;
+    auto format = new StringFormat(flags);
+    format->SetAlignment(alignment);
+    format->SetLineAlignment(lineAlignment);
+    format->SetTrimming(trimming);
+    m_formats[key] = std::unique_ptr<StringFormat>(format);
+    return format;
+}
+
+void PaintPool::beginFrame() {
+    if (m_styleGeneration != Style::generation()) {
+        m_styleGeneration = Style::generation();
+        this->clear();
+    }
+    m_stats = Stats();
+}
+
+void PaintPool::clear() {
+    m_brushes.clear();
+    m_pens.clear();
+    m_gradients.clear();
+    m_fonts.clear();
+    m_formats.clear();
+}
+
+PaintPool::Stats const& PaintPool::stats() const {
+    return m_stats;
+}
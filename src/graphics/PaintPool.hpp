@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Windows.h>
+#include <utils.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Brushes, pens, fonts and string formats handed out by the pool are
+// shared between every widget in a window, so they must not be modified
+class PaintPool {
+public:
+    struct Stats {
+        size_t m_created = 0;
+        size_t m_reused = 0;
+    };
+
+    static constexpr size_t s_maxEntries = 256;
+
+protected:
+    struct GradientKey {
+        int m_x1, m_y1, m_x2, m_y2;
+        ARGB m_c1, m_c2;
+        bool operator==(GradientKey const& other) const;
+    };
+    struct GradientKeyHash {
+        size_t operator()(GradientKey const& key) const;
+    };
+
+    std::unordered_map<ARGB, std::unique_ptr<SolidBrush>> m_brushes;
+    std::unordered_map<uint64_t, std::unique_ptr<Pen>> m_pens;
+    std::unordered_map<GradientKey, std::unique_ptr<LinearGradientBrush>, GradientKeyHash> m_gradients;
+    std::unordered_map<std::wstring, std::unique_ptr<Font>> m_fonts;
+    std::unordered_map<uint64_t, std::unique_ptr<StringFormat>> m_formats;
+    size_t m_styleGeneration = 0;
+    Stats m_stats;
+
+    template<class Map>
+    void makeRoom(Map& map) {
+        // entries only pile up when something keyed by position
+        // keeps changing, so just start over in that case
+        if (map.size() >= s_maxEntries) map.clear();
+    }
+
+public:
+    SolidBrush const* brush(Color const& color);
+    Pen const* pen(Color const& color, REAL width = 1.f);
+    LinearGradientBrush const* gradient(
+        Point const& p1, Point const& p2,
+        Color const& c1, Color const& c2
+    );
+    Font const* font(HDC hdc, std::wstring const& face, int size, int style = 0);
+    StringFormat const* format(
+        StringAlignment alignment = StringAlignmentNear,
+        StringAlignment lineAlignment = StringAlignmentNear,
+        StringTrimming trimming = StringTrimmingCharacter,
+        int flags = 0
+    );
+
+    // drops everything if the theme was reloaded since the last frame
+    // and resets the per-frame counters
+    void beginFrame();
+    void clear();
+
+    Stats const& stats() const;
+};
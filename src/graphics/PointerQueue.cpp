@@ -0,0 +1,49 @@
+#include "PointerQueue.hpp"
+
+bool PointerQueue::move(Point const& p, bool down) {
+    m_stats.m_moves++;
+    auto first = !m_hasPending;
+    if (!first) {
+        m_stats.m_coalesced++;
+    }
+    m_pending = p;
+    m_pendingDown = down;
+    m_hasPending = true;
+    return first;
+}
+
+bool PointerQueue::take(Point& p, bool& down) {
+    if (!m_hasPending) return false;
+    m_hasPending = false;
+    if (
+        m_hasResolved &&
+        m_resolved.X == m_pending.X && m_resolved.Y == m_pending.Y &&
+        m_resolvedDown == m_pendingDown
+    ) {
+        m_stats.m_cached++;
+        return false;
+    }
+    m_resolved = m_pending;
+    m_resolvedDown = m_pendingDown;
+    m_hasResolved = true;
+    m_stats.m_dispatched++;
+    p = m_pending;
+    down = m_pendingDown;
+    return true;
+}
+
+void PointerQueue::invalidate() {
+    m_hasResolved = false;
+}
+
+bool PointerQueue::pending() const {
+    return m_hasPending;
+}
+
+PointerQueue::Stats const& PointerQueue::stats() const {
+    return m_stats;
+}
+
+void PointerQueue::resetStats() {
+    m_stats = Stats();
+}
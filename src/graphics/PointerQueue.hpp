@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Types.hpp"
+#include <cstddef>
+
+// Holds on to the latest pointer move until it's dispatched, so that
+// any number of moves between two frames turn into one, and a move to
+// where the pointer already was resolved is dropped altogether
+class PointerQueue {
+public:
+    // every move ends up either dispatched, coalesced into a later
+    // one or dropped as cached, so m_moves is always the sum of those
+    struct Stats {
+        size_t m_moves = 0;
+        size_t m_dispatched = 0;
+        size_t m_coalesced = 0;
+        size_t m_cached = 0;
+    };
+
+protected:
+    Point m_pending;
+    bool m_pendingDown = false;
+    bool m_hasPending = false;
+    Point m_resolved;
+    bool m_resolvedDown = false;
+    bool m_hasResolved = false;
+    Stats m_stats;
+
+public:
+    // Returns whether this is the first move since the last take(),
+    // i.e. whether a dispatch has to be asked for
+    bool move(Point const& p, bool down);
+    // Gets the move to dispatch, if there is one that hasn't
+    // already been resolved at the same position
+    bool take(Point& p, bool& down);
+    // forgets the last resolved position, for when
+    // what's under the pointer may have changed
+    void invalidate();
+
+    bool pending() const;
+
+    Stats const& stats() const;
+    void resetStats();
+};
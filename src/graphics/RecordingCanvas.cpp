@@ -0,0 +1,360 @@
+#include "RecordingCanvas.hpp"
+
+RecordingCanvas::RecordingCanvas(Rect const& dirty, void* device)
+  : m_dirty(dirty), m_device(device) {}
+
+Rect RecordingCanvas::everything() {
+    return Rect(-0x3fffffff, -0x3fffffff, 0x7ffffffe, 0x7ffffffe);
+}
+
+void RecordingCanvas::op(Op op) {
+    m_counts[static_cast<size_t>(op)]++;
+    this->write(op);
+}
+
+uint32_t RecordingCanvas::string(std::wstring const& str) {
+    auto it = m_stringIndex.find(str);
+    if (it != m_stringIndex.end()) {
+        return it->second;
+    }
+    auto index = static_cast<uint32_t>(m_strings.size());
+    m_strings.push_back(str);
+    m_stringIndex.insert({ str, index });
+    return index;
+}
+
+RecordingCanvas::FillData RecordingCanvas::pack(Fill const& fill) {
+    return {
+        fill.m_color1.GetValue(), fill.m_color2.GetValue(),
+        fill.m_point1.X, fill.m_point1.Y,
+        fill.m_point2.X, fill.m_point2.Y,
+        fill.m_gradient
+    };
+}
+
+Fill RecordingCanvas::unpack(FillData const& data) {
+    if (data.m_gradient) {
+        return Fill::linear(
+            Point(data.m_x1, data.m_y1), Point(data.m_x2, data.m_y2),
+            Color(data.m_color1), Color(data.m_color2)
+        );
+    }
+    return Fill(Color(data.m_color1));
+}
+
+void RecordingCanvas::fillRect(RectF const& rect, Fill const& fill) {
+    this->op(Op::FillRect);
+    this->write(rect);
+    this->write(RecordingCanvas::pack(fill));
+}
+
+void RecordingCanvas::strokeRect(RectF const& rect, Color const& color, REAL width) {
+    this->op(Op::StrokeRect);
+    this->write(rect);
+    this->write(color.GetValue());
+    this->write(width);
+}
+
+void RecordingCanvas::fillRoundRect(Rect const& rect, int radius, Fill const& fill) {
+    this->op(Op::FillRoundRect);
+    this->write(rect);
+    this->write(radius);
+    this->write(RecordingCanvas::pack(fill));
+}
+
+void RecordingCanvas::strokeRoundRect(Rect const& rect, int radius, Color const& color) {
+    this->op(Op::StrokeRoundRect);
+    this->write(rect);
+    this->write(radius);
+    this->write(color.GetValue());
+}
+
+void RecordingCanvas::fillEllipse(RectF const& rect, Fill const& fill) {
+    this->op(Op::FillEllipse);
+    this->write(rect);
+    this->write(RecordingCanvas::pack(fill));
+}
+
+void RecordingCanvas::strokePath(Path const& path, Color const& color, REAL width) {
+    this->op(Op::StrokePath);
+    this->write(color.GetValue());
+    this->write(width);
+    auto& figures = path.figures();
+    auto& points = path.points();
+    this->write(static_cast<uint32_t>(figures.size()));
+    for (size_t i = 0; i < figures.size(); i++) {
+        auto end = i + 1 < figures.size() ? figures[i + 1] : points.size();
+        this->write(static_cast<uint32_t>(end - figures[i]));
+        for (auto p = figures[i]; p < end; p++) {
+            this->write(points[p]);
+        }
+    }
+}
+
+void RecordingCanvas::drawText(
+    std::wstring const& text,
+    std::wstring const& font,
+    int size,
+    int style,
+    Color const& color,
+    RectF const& rect,
+    TextLayout const& layout
+) {
+    this->op(Op::DrawText);
+    this->write(this->string(text));
+    this->write(this->string(font));
+    this->write(size);
+    this->write(style);
+    this->write(color.GetValue());
+    this->write(rect);
+    this->write(layout);
+}
+
+void RecordingCanvas::save() {
+    this->op(Op::Save);
+}
+
+void RecordingCanvas::restore() {
+    this->op(Op::Restore);
+}
+
+void RecordingCanvas::clipRect(Rect const& rect) {
+    this->op(Op::ClipRect);
+    this->write(rect);
+}
+
+void RecordingCanvas::translate(REAL dx, REAL dy) {
+    this->op(Op::Translate);
+    this->write(dx);
+    this->write(dy);
+}
+
+void RecordingCanvas::rotate(REAL degrees) {
+    this->op(Op::Rotate);
+    this->write(degrees);
+}
+
+void RecordingCanvas::pushClip(Rect const& rect) {
+    this->op(Op::PushClip);
+    this->write(rect);
+    // still tracked so that children outside the clip
+    // don't make it into the recording at all
+    this->enterClip(rect);
+}
+
+void RecordingCanvas::popClip() {
+    if (m_clips.empty()) return;
+    this->op(Op::PopClip);
+    this->leaveClip();
+}
+
+void RecordingCanvas::drawList(
+    std::shared_ptr<RecordingCanvas const> const& list,
+    Point const& offset,
+    Rect const& bounds
+) {
+    this->op(Op::DrawList);
+    this->write(static_cast<uint32_t>(m_lists.size()));
+    this->write(offset);
+    this->write(bounds);
+    m_lists.push_back(list);
+}
+
+void RecordingCanvas::drawLayer(
+    uintptr_t key,
+    std::shared_ptr<RecordingCanvas const> const& list,
+    Point const& offset,
+    Rect const& bounds
+) {
+    this->op(Op::DrawLayer);
+    this->write(static_cast<uint64_t>(key));
+    this->write(static_cast<uint32_t>(m_lists.size()));
+    this->write(offset);
+    this->write(bounds);
+    m_lists.push_back(list);
+}
+
+void RecordingCanvas::drawScrolled(
+    uintptr_t key,
+    std::shared_ptr<RecordingCanvas const> const& list,
+    Point const& offset,
+    Rect const& bounds,
+    Rect const& viewport
+) {
+    this->op(Op::DrawScrolled);
+    this->write(static_cast<uint64_t>(key));
+    this->write(static_cast<uint32_t>(m_lists.size()));
+    this->write(offset);
+    this->write(bounds);
+    this->write(viewport);
+    m_lists.push_back(list);
+}
+
+Rect RecordingCanvas::dirty() const {
+    return m_dirty;
+}
+
+void* RecordingCanvas::device() const {
+    return m_device;
+}
+
+void RecordingCanvas::replay(Canvas& target) const {
+    size_t at = 0;
+    while (at < m_buffer.size()) {
+        switch (this->read<Op>(at)) {
+            case Op::FillRect: {
+                auto rect = this->read<RectF>(at);
+                auto fill = this->read<FillData>(at);
+                target.fillRect(rect, RecordingCanvas::unpack(fill));
+            } break;
+
+            case Op::StrokeRect: {
+                auto rect = this->read<RectF>(at);
+                auto color = this->read<ARGB>(at);
+                auto width = this->read<REAL>(at);
+                target.strokeRect(rect, Color(color), width);
+            } break;
+
+            case Op::FillRoundRect: {
+                auto rect = this->read<Rect>(at);
+                auto radius = this->read<int>(at);
+                auto fill = this->read<FillData>(at);
+                target.fillRoundRect(rect, radius, RecordingCanvas::unpack(fill));
+            } break;
+
+            case Op::StrokeRoundRect: {
+                auto rect = this->read<Rect>(at);
+                auto radius = this->read<int>(at);
+                auto color = this->read<ARGB>(at);
+                target.strokeRoundRect(rect, radius, Color(color));
+            } break;
+
+            case Op::FillEllipse: {
+                auto rect = this->read<RectF>(at);
+                auto fill = this->read<FillData>(at);
+                target.fillEllipse(rect, RecordingCanvas::unpack(fill));
+            } break;
+
+            case Op::StrokePath: {
+                auto color = this->read<ARGB>(at);
+                auto width = this->read<REAL>(at);
+                auto figures = this->read<uint32_t>(at);
+                Path path;
+                for (uint32_t f = 0; f < figures; f++) {
+                    auto count = this->read<uint32_t>(at);
+                    path.startFigure();
+                    PointF last;
+                    for (uint32_t i = 0; i < count; i++) {
+                        auto p = this->read<PointF>(at);
+                        if (i) path.addLine(last, p);
+                        last = p;
+                    }
+                }
+                target.strokePath(path, Color(color), width);
+            } break;
+
+            case Op::DrawText: {
+                auto text = this->read<uint32_t>(at);
+                auto font = this->read<uint32_t>(at);
+                auto size = this->read<int>(at);
+                auto style = this->read<int>(at);
+                auto color = this->read<ARGB>(at);
+                auto rect = this->read<RectF>(at);
+                auto layout = this->read<TextLayout>(at);
+                target.drawText(
+                    m_strings[text], m_strings[font],
+                    size, style, Color(color), rect, layout
+                );
+            } break;
+
+            case Op::Save: {
+                target.save();
+            } break;
+
+            case Op::Restore: {
+                target.restore();
+            } break;
+
+            case Op::ClipRect: {
+                target.clipRect(this->read<Rect>(at));
+            } break;
+
+            case Op::Translate: {
+                auto dx = this->read<REAL>(at);
+                auto dy = this->read<REAL>(at);
+                target.translate(dx, dy);
+            } break;
+
+            case Op::Rotate: {
+                target.rotate(this->read<REAL>(at));
+            } break;
+
+            case Op::DrawList: {
+                auto index = this->read<uint32_t>(at);
+                auto offset = this->read<Point>(at);
+                auto bounds = this->read<Rect>(at);
+                target.drawList(m_lists[index], offset, bounds);
+            } break;
+
+            case Op::PushClip: {
+                target.pushClip(this->read<Rect>(at));
+            } break;
+
+            case Op::PopClip: {
+                target.popClip();
+            } break;
+
+            case Op::DrawLayer: {
+                auto key = this->read<uint64_t>(at);
+                auto index = this->read<uint32_t>(at);
+                auto offset = this->read<Point>(at);
+                auto bounds = this->read<Rect>(at);
+                target.drawLayer(
+                    static_cast<uintptr_t>(key), m_lists[index], offset, bounds
+                );
+            } break;
+
+            case Op::DrawScrolled: {
+                auto key = this->read<uint64_t>(at);
+                auto index = this->read<uint32_t>(at);
+                auto offset = this->read<Point>(at);
+                auto bounds = this->read<Rect>(at);
+                auto viewport = this->read<Rect>(at);
+                target.drawScrolled(
+                    static_cast<uintptr_t>(key), m_lists[index], offset, bounds, viewport
+                );
+            } break;
+
+            default: return;
+        }
+    }
+}
+
+void RecordingCanvas::clear() {
+    m_buffer.clear();
+    m_strings.clear();
+    m_stringIndex.clear();
+    m_lists.clear();
+    m_clips.clear();
+    m_counts.fill(0);
+}
+
+size_t RecordingCanvas::count(Op op) const {
+    return m_counts[static_cast<size_t>(op)];
+}
+
+size_t RecordingCanvas::count() const {
+    size_t total = 0;
+    for (auto& c : m_counts) {
+        total += c;
+    }
+    return total;
+}
+
+size_t RecordingCanvas::size() const {
+    return m_buffer.size();
+}
+
+std::vector<std::wstring> const& RecordingCanvas::strings() const {
+    return m_strings;
+}
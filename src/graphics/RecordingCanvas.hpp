@@ -0,0 +1,141 @@
+#pragma once
+
+#include "Canvas.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+
+// Captures draw calls into a flat byte buffer instead of drawing them.
+// Every op is a one byte tag followed by its fixed size payload, strings
+// go into a table and are referred to by index. Used to count and time
+// painting without a display, and to replay it onto another canvas
+class RecordingCanvas : public Canvas {
+public:
+    enum class Op : uint8_t {
+        FillRect,
+        StrokeRect,
+        FillRoundRect,
+        StrokeRoundRect,
+        FillEllipse,
+        StrokePath,
+        DrawText,
+        Save,
+        Restore,
+        ClipRect,
+        Translate,
+        Rotate,
+        DrawList,
+        DrawLayer,
+        DrawScrolled,
+        PushClip,
+        PopClip,
+        Count,
+    };
+
+    static constexpr size_t s_opCount = static_cast<size_t>(Op::Count);
+
+protected:
+    // fills are stored by value instead of as Color/Point
+    // so that payloads stay trivially copyable
+    struct FillData {
+        ARGB m_color1;
+        ARGB m_color2;
+        int m_x1, m_y1, m_x2, m_y2;
+        bool m_gradient;
+    };
+
+    std::vector<uint8_t> m_buffer;
+    std::vector<std::wstring> m_strings;
+    std::unordered_map<std::wstring, uint32_t> m_stringIndex;
+    std::vector<std::shared_ptr<RecordingCanvas const>> m_lists;
+    std::array<size_t, s_opCount> m_counts {};
+    Rect m_dirty;
+    void* m_device;
+
+    template<class T>
+    void write(T const& value) {
+        static_assert(std::is_trivially_copyable<T>::value);
+        auto at = m_buffer.size();
+        m_buffer.resize(at + sizeof(T));
+        std::memcpy(m_buffer.data() + at, &value, sizeof(T));
+    }
+    template<class T>
+    T read(size_t& at) const {
+        static_assert(std::is_trivially_copyable<T>::value);
+        T value;
+        std::memcpy(&value, m_buffer.data() + at, sizeof(T));
+        at += sizeof(T);
+        return value;
+    }
+
+    void op(Op op);
+    uint32_t string(std::wstring const& str);
+    static FillData pack(Fill const& fill);
+    static Fill unpack(FillData const& data);
+
+public:
+    // dirty is the area painting is allowed to skip outside of, device
+    // is handed on to anything measuring text while recording
+    RecordingCanvas(Rect const& dirty = RecordingCanvas::everything(), void* device = nullptr);
+
+    static Rect everything();
+
+    void fillRect(RectF const& rect, Fill const& fill) override;
+    void strokeRect(RectF const& rect, Color const& color, REAL width = 1.f) override;
+    void fillRoundRect(Rect const& rect, int radius, Fill const& fill) override;
+    void strokeRoundRect(Rect const& rect, int radius, Color const& color) override;
+    void fillEllipse(RectF const& rect, Fill const& fill) override;
+    void strokePath(Path const& path, Color const& color, REAL width = 1.f) override;
+    void drawText(
+        std::wstring const& text,
+        std::wstring const& font,
+        int size,
+        int style,
+        Color const& color,
+        RectF const& rect,
+        TextLayout const& layout
+    ) override;
+
+    void save() override;
+    void restore() override;
+    void clipRect(Rect const& rect) override;
+    void translate(REAL dx, REAL dy) override;
+    void rotate(REAL degrees) override;
+    void pushClip(Rect const& rect) override;
+    void popClip() override;
+    // other lists are kept by reference, not copied in
+    void drawList(
+        std::shared_ptr<RecordingCanvas const> const& list,
+        Point const& offset,
+        Rect const& bounds
+    ) override;
+    void drawLayer(
+        uintptr_t key,
+        std::shared_ptr<RecordingCanvas const> const& list,
+        Point const& offset,
+        Rect const& bounds
+    ) override;
+    void drawScrolled(
+        uintptr_t key,
+        std::shared_ptr<RecordingCanvas const> const& list,
+        Point const& offset,
+        Rect const& bounds,
+        Rect const& viewport
+    ) override;
+
+    Rect dirty() const override;
+    void* device() const override;
+
+    // draws everything recorded so far onto another canvas
+    void replay(Canvas& target) const;
+    void clear();
+
+    size_t count(Op op) const;
+    // total number of ops recorded
+    size_t count() const;
+    // size of the command buffer in bytes, not counting strings
+    size_t size() const;
+    std::vector<std::wstring> const& strings() const;
+};
@@ -0,0 +1,99 @@
+#include "RoundRectCache.hpp"
+#include <algorithm>
+#include <cmath>
+
+RoundRectCache* RoundRectCache::get() {
+    static auto inst = new RoundRectCache();
+    return inst;
+}
+
+uint64_t RoundRectCache::key(int width, int height, int diameter) {
+    return
+        (static_cast<uint64_t>(static_cast<uint32_t>(width) & 0xffffff) << 40) |
+        (static_cast<uint64_t>(static_cast<uint32_t>(height) & 0xffffff) << 16) |
+        (static_cast<uint64_t>(diameter) & 0xffff);
+}
+
+// follows the same corners as GetRoundRectPath in utils.cpp
+std::vector<PointF> RoundRectCache::flatten(int width, int height, int dia) {
+    if (dia > width)  dia = width;
+    if (dia > height) dia = height;
+
+    auto cw = static_cast<REAL>(dia);
+    auto ch = static_cast<REAL>(dia);
+    auto w = width;
+    auto h = height;
+    if (dia == 20) {
+        cw += 1.f;
+        ch += 1.f;
+        w -= 1;
+        h -= 1;
+    }
+
+    struct Corner {
+        REAL x, y;
+        REAL start;
+    };
+    Corner corners[4] = {
+        { 0.f,                                0.f,                                180.f },
+        { static_cast<REAL>(w - dia - 1),     0.f,                                270.f },
+        { static_cast<REAL>(w - dia - 1),     static_cast<REAL>(h - dia - 1),     0.f },
+        { 0.f,                                static_cast<REAL>(h - dia - 1),     90.f },
+    };
+
+    auto segments = std::min(std::max(dia / 2, 2), 16);
+    std::vector<PointF> points;
+    points.reserve(4 * (segments + 1));
+    const REAL toRad = 3.14159265f / 180.f;
+    for (auto& c : corners) {
+        auto rx = cw / 2.f;
+        auto ry = ch / 2.f;
+        auto cx = c.x + rx;
+        auto cy = c.y + ry;
+        for (int i = 0; i <= segments; i++) {
+            auto a = (c.start + 90.f * i / segments) * toRad;
+            points.push_back({ cx + rx * std::cos(a), cy + ry * std::sin(a) });
+        }
+    }
+    return points;
+}
+
+RoundRectCache::Shape& RoundRectCache::shape(int width, int height, int diameter) {
+    auto k = RoundRectCache::key(width, height, diameter);
+    auto it = m_index.find(k);
+    if (it != m_index.end()) {
+        m_stats.m_hits++;
+        m_shapes.splice(m_shapes.begin(), m_shapes, it->second);
+        return *it->second;
+    }
+    m_stats.m_built++;
+    m_shapes.push_front({
+        width, height, diameter,
+        RoundRectCache::flatten(width, height, diameter),
+        nullptr
+    });
+    m_index[k] = m_shapes.begin();
+    if (m_shapes.size() > s_capacity) {
+        auto& last = m_shapes.back();
+        m_index.erase(RoundRectCache::key(last.m_width, last.m_height, last.m_diameter));
+        m_shapes.pop_back();
+    }
+    return m_shapes.front();
+}
+
+void RoundRectCache::clear() {
+    m_shapes.clear();
+    m_index.clear();
+}
+
+size_t RoundRectCache::size() const {
+    return m_shapes.size();
+}
+
+RoundRectCache::Stats const& RoundRectCache::stats() const {
+    return m_stats;
+}
+
+void RoundRectCache::resetStats() {
+    m_stats = Stats();
+}
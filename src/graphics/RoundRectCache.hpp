@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Types.hpp"
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Rounded rectangle outlines, cached by size and built in local
+// coordinates so one entry serves every rect of the same size
+class RoundRectCache {
+public:
+    // backend-specific geometry (i.e. a GraphicsPath) attached to
+    // an entry by whoever draws it
+    struct Native {
+        virtual ~Native() = default;
+    };
+
+    struct Shape {
+        int m_width;
+        int m_height;
+        int m_diameter;
+        // the outline flattened into a closed polygon, for
+        // rasterizers that don't do arcs themselves
+        std::vector<PointF> m_polygon;
+        std::unique_ptr<Native> m_native;
+    };
+
+    struct Stats {
+        size_t m_built = 0;
+        size_t m_hits = 0;
+    };
+
+    static constexpr size_t s_capacity = 512;
+
+protected:
+    std::list<Shape> m_shapes;
+    std::unordered_map<uint64_t, std::list<Shape>::iterator> m_index;
+    Stats m_stats;
+
+    static uint64_t key(int width, int height, int diameter);
+
+public:
+    static RoundRectCache* get();
+
+    static std::vector<PointF> flatten(int width, int height, int diameter);
+
+    Shape& shape(int width, int height, int diameter);
+
+    void clear();
+    size_t size() const;
+    Stats const& stats() const;
+    void resetStats();
+};
@@ -0,0 +1,139 @@
+#include "TextCache.hpp"
+#include <stdexcept>
+
+TextCache::TextCache(size_t capacity) : m_capacity(capacity) {}
+
+TextCache* TextCache::get() {
+    static auto inst = new TextCache();
+    return inst;
+}
+
+void TextCache::measurer(std::unique_ptr<TextMeasurer> measurer) {
+    m_measurer = std::move(measurer);
+    this->clear();
+}
+
+TextMeasurer* TextCache::measurer() const {
+    return m_measurer.get();
+}
+
+size_t TextCache::hash(TextQuery const& query) {
+    auto h = std::hash<std::wstring>()(query.m_text);
+    auto combine = [&h](size_t v) {
+        h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    };
+    combine(std::hash<std::wstring>()(query.m_font));
+    combine(static_cast<size_t>(query.m_size));
+    combine(static_cast<size_t>(query.m_style));
+    combine(static_cast<size_t>(query.m_wrap));
+    combine(static_cast<size_t>(query.m_width));
+    return h;
+}
+
+bool TextCache::matches(Entry const& entry, TextQuery const& query) {
+    return
+        entry.m_size == query.m_size &&
+        entry.m_style == query.m_style &&
+        entry.m_wrap == query.m_wrap &&
+        entry.m_width == query.m_width &&
+        entry.m_font == query.m_font &&
+        entry.m_text == query.m_text;
+}
+
+void TextCache::trim() {
+    while (m_entries.size() > m_capacity) {
+        auto last = std::prev(m_entries.end());
+        auto range = m_index.equal_range(last->m_hash);
+        for (auto it = range.first; it != range.second; it++) {
+            if (it->second == last) {
+                m_index.erase(it);
+                break;
+            }
+        }
+        m_entries.pop_back();
+        m_stats.m_evictions++;
+    }
+}
+
+TextSize TextCache::lookup(TextQuery const& query, void* device) {
+    auto h = TextCache::hash(query);
+    auto find = [&]() -> Entry* {
+        auto range = m_index.equal_range(h);
+        for (auto it = range.first; it != range.second; it++) {
+            if (TextCache::matches(*it->second, query)) {
+                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                return &*it->second;
+            }
+        }
+        return nullptr;
+    };
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (auto entry = find()) {
+            m_stats.m_hits++;
+            return entry->m_result;
+        }
+        m_stats.m_misses++;
+        if (!m_measurer) {
+            throw std::runtime_error("No text measurer set");
+        }
+    }
+    auto result = m_measurer->measure(query, device);
+    std::lock_guard<std::mutex> lock(m_lock);
+    // another thread may have measured the same text in the meantime
+    if (find()) {
+        return result;
+    }
+    m_entries.push_front({
+        h, query.m_text, query.m_font,
+        query.m_size, query.m_style, query.m_wrap, query.m_width,
+        result
+    });
+    m_index.insert({ h, m_entries.begin() });
+    this->trim();
+    return result;
+}
+
+TextSize TextCache::measure(TextQuery const& query, void* device) {
+    TextQuery unwrapped { query.m_text, query.m_font, query.m_size, query.m_style, false, -1 };
+    auto size = this->lookup(unwrapped, device);
+    // a zero layout width means no wrapping at all
+    if (!query.m_wrap || query.m_width <= 0 || size.m_width <= query.m_width) {
+        return size;
+    }
+    auto width = query.m_width - query.m_width % s_widthBucket;
+    return this->lookup(
+        { query.m_text, query.m_font, query.m_size, query.m_style, true, width },
+        device
+    );
+}
+
+void TextCache::capacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_capacity = capacity;
+    this->trim();
+}
+
+size_t TextCache::capacity() const {
+    return m_capacity;
+}
+
+size_t TextCache::size() const {
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_entries.size();
+}
+
+void TextCache::clear() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_entries.clear();
+    m_index.clear();
+}
+
+TextCache::Stats const& TextCache::stats() const {
+    return m_stats;
+}
+
+void TextCache::resetStats() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_stats = Stats();
+}
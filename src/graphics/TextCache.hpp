@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// Kept free of any Windows types so the cache
+// can be built and tested on other platforms
+
+struct TextSize {
+    float m_width = 0.f;
+    float m_height = 0.f;
+};
+
+struct TextQuery {
+    std::wstring const& m_text;
+    std::wstring const& m_font;
+    int m_size;
+    int m_style;
+    bool m_wrap;
+    // layout width the text is wrapped to, -1 if unconstrained
+    int m_width;
+};
+
+class TextMeasurer {
+public:
+    virtual ~TextMeasurer() = default;
+    // device is whatever the platform measures
+    // against, i.e. an HDC on Windows
+    virtual TextSize measure(TextQuery const& query, void* device) = 0;
+};
+
+class TextCache {
+public:
+    struct Stats {
+        size_t m_hits = 0;
+        size_t m_misses = 0;
+        size_t m_evictions = 0;
+    };
+
+    static constexpr int s_widthBucket = 4;
+
+protected:
+    struct Entry {
+        size_t m_hash;
+        std::wstring m_text;
+        std::wstring m_font;
+        int m_size;
+        int m_style;
+        bool m_wrap;
+        int m_width;
+        TextSize m_result;
+    };
+    using Entries = std::list<Entry>;
+
+    size_t m_capacity;
+    std::unique_ptr<TextMeasurer> m_measurer;
+    Entries m_entries;
+    std::unordered_multimap<size_t, Entries::iterator> m_index;
+    Stats m_stats;
+    // measuring happens outside of this, so threads
+    // missing on different text don't wait on each other
+    mutable std::mutex m_lock;
+
+    static size_t hash(TextQuery const& query);
+    static bool matches(Entry const& entry, TextQuery const& query);
+    void trim();
+    TextSize lookup(TextQuery const& query, void* device);
+
+public:
+    TextCache(size_t capacity = 2048);
+
+    static TextCache* get();
+
+    void measurer(std::unique_ptr<TextMeasurer> measurer);
+    TextMeasurer* measurer() const;
+
+    // Measures text through the cache. Text that fits the available
+    // width on a single pass is shared between all widths; wrapped
+    // text is measured at the available width rounded down to
+    // s_widthBucket, so it never ends up wider than it's allowed to be.
+    // Safe to call from several threads as long as the measurer is
+    TextSize measure(TextQuery const& query, void* device);
+
+    void capacity(size_t capacity);
+    size_t capacity() const;
+    size_t size() const;
+    void clear();
+
+    // not synchronized, meant to be read from the UI thread in between layouts
+    Stats const& stats() const;
+    void resetStats();
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+// Backend-neutral graphics code uses the Gdiplus value types. Outside
+// of Windows these minimal stand-ins with the same shape are used
+// instead, so that code can be built and tested on any platform
+
+#ifdef _WIN32
+
+#include <Windows.h>
+#include <gdiplus.h>
+
+using namespace Gdiplus;
+
+#else
+
+#include <cstdint>
+
+typedef float REAL;
+typedef uint32_t ARGB;
+typedef unsigned char BYTE;
+
+enum StringAlignment {
+    StringAlignmentNear   = 0,
+    StringAlignmentCenter = 1,
+    StringAlignmentFar    = 2,
+};
+
+enum StringTrimming {
+    StringTrimmingNone              = 0,
+    StringTrimmingCharacter         = 1,
+    StringTrimmingWord              = 2,
+    StringTrimmingEllipsisCharacter = 3,
+    StringTrimmingEllipsisWord      = 4,
+    StringTrimmingEllipsisPath      = 5,
+};
+
+class Color {
+protected:
+    ARGB m_value = 0xff000000;
+
+public:
+    Color() = default;
+    Color(ARGB argb) : m_value(argb) {}
+    Color(BYTE r, BYTE g, BYTE b) : Color(255, r, g, b) {}
+    Color(BYTE a, BYTE r, BYTE g, BYTE b)
+      : m_value(
+            (static_cast<ARGB>(a) << 24) | (static_cast<ARGB>(r) << 16) |
+            (static_cast<ARGB>(g) << 8)  |  static_cast<ARGB>(b)
+        ) {}
+
+    BYTE GetA() const { return static_cast<BYTE>(m_value >> 24); }
+    BYTE GetR() const { return static_cast<BYTE>(m_value >> 16); }
+    BYTE GetG() const { return static_cast<BYTE>(m_value >> 8); }
+    BYTE GetB() const { return static_cast<BYTE>(m_value); }
+    ARGB GetValue() const { return m_value; }
+};
+
+class Point {
+public:
+    int X = 0;
+    int Y = 0;
+
+    Point() = default;
+    Point(int x, int y) : X(x), Y(y) {}
+};
+
+class PointF {
+public:
+    REAL X = 0.f;
+    REAL Y = 0.f;
+
+    PointF() = default;
+    PointF(REAL x, REAL y) : X(x), Y(y) {}
+};
+
+class Rect {
+public:
+    int X = 0;
+    int Y = 0;
+    int Width = 0;
+    int Height = 0;
+
+    Rect() = default;
+    Rect(int x, int y, int w, int h) : X(x), Y(y), Width(w), Height(h) {}
+
+    bool IsEmptyArea() const { return Width <= 0 || Height <= 0; }
+    bool IntersectsWith(Rect const& r) const {
+        return
+            X < r.X + r.Width && r.X < X + Width &&
+            Y < r.Y + r.Height && r.Y < Y + Height;
+    }
+    bool Contains(Rect const& r) const {
+        return
+            X <= r.X && r.X + r.Width <= X + Width &&
+            Y <= r.Y && r.Y + r.Height <= Y + Height;
+    }
+};
+
+class RectF {
+public:
+    REAL X = 0.f;
+    REAL Y = 0.f;
+    REAL Width = 0.f;
+    REAL Height = 0.f;
+
+    RectF() = default;
+    RectF(REAL x, REAL y, REAL w, REAL h) : X(x), Y(y), Width(w), Height(h) {}
+};
+
+#endif
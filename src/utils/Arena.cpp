@@ -0,0 +1,131 @@
+#include "Arena.hpp"
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+static thread_local Arena* g_currentArena = nullptr;
+
+// room for the owning arena in front of scoped allocations, kept big
+// enough that the object after it is still suitably aligned
+static constexpr size_t s_scopedHeader = alignof(std::max_align_t);
+static_assert(s_scopedHeader >= sizeof(Arena*));
+
+Arena::Arena(size_t blockSize) : m_blockSize(blockSize) {}
+
+Arena::~Arena() {
+    // owners delete what's left in their arenas first, see
+    // Window::releaseArena, so this is only ever a bug
+    assert(!m_stats.m_liveObjects && "arena destroyed with objects still in it");
+    // leaked rather than freed under whatever is still using it
+    if (m_stats.m_liveObjects) {
+        for (auto& block : m_blocks) {
+            block.m_data.release();
+        }
+    }
+}
+
+void Arena::grow(size_t size) {
+    auto blockSize = size > m_blockSize ? size : m_blockSize;
+    m_blocks.push_back({ std::make_unique<char[]>(blockSize), blockSize });
+    m_used = 0;
+    m_stats.m_blocks++;
+    m_stats.m_bytesReserved += blockSize;
+}
+
+void* Arena::allocate(size_t size, size_t align) {
+    // freed memory has to fit the link to the next one
+    if (size < sizeof(void*)) size = sizeof(void*);
+    auto free = m_free.find(size);
+    if (
+        free != m_free.end() && free->second &&
+        reinterpret_cast<uintptr_t>(free->second) % align == 0
+    ) {
+        auto ptr = free->second;
+        free->second = *static_cast<void**>(ptr);
+        m_stats.m_bytesUsed += size;
+        m_stats.m_objects++;
+        m_stats.m_liveObjects++;
+        m_stats.m_reused++;
+        return ptr;
+    }
+    // blocks come from new[], so their start is aligned to max_align_t
+    auto offset = (m_used + align - 1) & ~(align - 1);
+    if (m_blocks.empty() || offset + size > m_blocks.back().m_size) {
+        this->grow(size);
+        offset = 0;
+    }
+    auto ptr = m_blocks.back().m_data.get() + offset;
+    m_stats.m_bytesUsed += offset + size - m_used;
+    m_used = offset + size;
+    m_stats.m_objects++;
+    m_stats.m_liveObjects++;
+    return ptr;
+}
+
+void Arena::deallocate(void* ptr, size_t size) {
+    assert(m_stats.m_liveObjects && "freeing more than was allocated");
+    m_stats.m_liveObjects--;
+    if (!m_stats.m_liveObjects) {
+        this->reset();
+        return;
+    }
+    if (size < sizeof(void*)) size = sizeof(void*);
+    auto& head = m_free[size];
+    *static_cast<void**>(ptr) = head;
+    head = ptr;
+    m_stats.m_bytesUsed -= size;
+}
+
+void Arena::reset() {
+    if (m_blocks.size() > 1) {
+        m_blocks.erase(m_blocks.begin() + 1, m_blocks.end());
+    }
+    m_used = 0;
+    m_free.clear();
+    m_stats.m_blocks = m_blocks.size();
+    m_stats.m_bytesReserved = m_blocks.empty() ? 0 : m_blocks.front().m_size;
+    m_stats.m_bytesUsed = 0;
+    m_stats.m_liveObjects = 0;
+}
+
+Arena::Stats const& Arena::stats() const {
+    return m_stats;
+}
+
+Arena* Arena::current() {
+    return g_currentArena;
+}
+
+void* Arena::allocateScoped(size_t size) {
+    auto arena = g_currentArena;
+    auto block = arena ?
+        arena->allocate(size + s_scopedHeader) :
+        ::operator new(size + s_scopedHeader);
+    *static_cast<Arena**>(block) = arena;
+    return static_cast<char*>(block) + s_scopedHeader;
+}
+
+void Arena::deallocateScoped(void* ptr, size_t size) {
+    if (!ptr) return;
+    auto block = static_cast<char*>(ptr) - s_scopedHeader;
+    auto arena = *reinterpret_cast<Arena**>(block);
+    if (arena) {
+        arena->deallocate(block, size + s_scopedHeader);
+    } else {
+        ::operator delete(block);
+    }
+}
+
+Arena* Arena::ownerOf(void const* ptr) {
+    if (!ptr) return nullptr;
+    auto block = static_cast<char const*>(ptr) - s_scopedHeader;
+    return *reinterpret_cast<Arena* const*>(block);
+}
+
+ArenaScope::ArenaScope(Arena& arena) : m_previous(g_currentArena) {
+    g_currentArena = &arena;
+}
+
+ArenaScope::~ArenaScope() {
+    g_currentArena = m_previous;
+}
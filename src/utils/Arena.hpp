@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Bump allocator for objects that are created and torn down together,
+// like the widgets of a window. Freed objects are kept on a list by size
+// and their memory is handed to the next object of that size; it goes
+// back all at once when the last object in the arena is freed, or on reset()
+class Arena {
+public:
+    struct Stats {
+        // memory held in blocks versus the part of it handed out
+        size_t m_bytesReserved = 0;
+        size_t m_bytesUsed = 0;
+        size_t m_blocks = 0;
+        size_t m_objects = 0;
+        size_t m_liveObjects = 0;
+        // objects put where a freed one was
+        size_t m_reused = 0;
+    };
+
+    static constexpr size_t s_defaultBlockSize = 64 * 1024;
+
+protected:
+    struct Block {
+        std::unique_ptr<char[]> m_data;
+        size_t m_size;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_blockSize;
+    // how far into the last block has been handed out
+    size_t m_used = 0;
+    // freed memory by size, linked through the memory itself
+    std::unordered_map<size_t, void*> m_free;
+    Stats m_stats;
+
+    void grow(size_t size);
+
+public:
+    Arena(size_t blockSize = s_defaultBlockSize);
+    ~Arena();
+
+    Arena(Arena const&) = delete;
+    Arena& operator=(Arena const&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t));
+    void deallocate(void* ptr, size_t size);
+    // Frees everything at once, keeping the first block around for
+    // reuse. Objects still alive in the arena must not be touched after
+    void reset();
+
+    Stats const& stats() const;
+
+    // The arena the innermost ArenaScope on this thread points
+    // at, or nullptr if there isn't one
+    static Arena* current();
+
+    // For operator new/delete overloads: allocates from current(), or
+    // the heap if there's no arena, remembering which one it came from
+    static void* allocateScoped(size_t size);
+    static void deallocateScoped(void* ptr, size_t size);
+    // the arena that ptr from allocateScoped came from, nullptr for the heap
+    static Arena* ownerOf(void const* ptr);
+};
+
+// Makes objects allocated through Arena::allocateScoped
+// go into arena until the scope ends
+class ArenaScope {
+protected:
+    Arena* m_previous;
+
+public:
+    ArenaScope(Arena& arena);
+    ~ArenaScope();
+
+    ArenaScope(ArenaScope const&) = delete;
+    ArenaScope& operator=(ArenaScope const&) = delete;
+};
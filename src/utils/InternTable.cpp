@@ -0,0 +1,30 @@
+#include "InternTable.hpp"
+
+InternTable* InternTable::get() {
+    static auto inst = new InternTable();
+    return inst;
+}
+
+uint32_t InternTable::intern(std::string const& str) {
+    auto it = m_ids.find(str);
+    if (it != m_ids.end()) return it->second;
+    m_strings.push_back(str);
+    auto id = static_cast<uint32_t>(m_strings.size());
+    m_ids.insert({ str, id });
+    return id;
+}
+
+uint32_t InternTable::find(std::string const& str) const {
+    auto it = m_ids.find(str);
+    return it != m_ids.end() ? it->second : 0;
+}
+
+std::string const& InternTable::string(uint32_t id) const {
+    static std::string const empty;
+    if (!id || id > m_strings.size()) return empty;
+    return m_strings[id - 1];
+}
+
+size_t InternTable::size() const {
+    return m_strings.size();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+// Maps strings to small ids that stay the same for the lifetime of the
+// program, so hashing and comparing them later is just an integer.
+// Id 0 is never given out and means "not interned"
+class InternTable {
+protected:
+    std::unordered_map<std::string, uint32_t> m_ids;
+    // a deque so the strings don't move as more are added
+    std::deque<std::string> m_strings;
+
+public:
+    static InternTable* get();
+
+    uint32_t intern(std::string const& str);
+    // like intern, but doesn't add strings it hasn't seen
+    uint32_t find(std::string const& str) const;
+    std::string const& string(uint32_t id) const;
+    size_t size() const;
+};
@@ -0,0 +1,59 @@
+#include "PrefixSum.hpp"
+
+void PrefixSum::assign(size_t count, int value) {
+    m_values.assign(count, value);
+    m_tree.assign(count + 1, 0);
+    // every node adds itself to its parent, which is built in O(n)
+    for (size_t i = 1; i <= count; i++) {
+        m_tree[i] += value;
+        auto parent = i + (i & (~i + 1));
+        if (parent <= count) {
+            m_tree[parent] += m_tree[i];
+        }
+    }
+}
+
+size_t PrefixSum::size() const {
+    return m_values.size();
+}
+
+int PrefixSum::get(size_t index) const {
+    return m_values[index];
+}
+
+void PrefixSum::set(size_t index, int value) {
+    auto diff = static_cast<int64_t>(value) - m_values[index];
+    if (!diff) return;
+    m_values[index] = value;
+    for (auto i = index + 1; i < m_tree.size(); i += i & (~i + 1)) {
+        m_tree[i] += diff;
+    }
+}
+
+int64_t PrefixSum::sum(size_t index) const {
+    int64_t total = 0;
+    for (auto i = index; i > 0; i -= i & (~i + 1)) {
+        total += m_tree[i];
+    }
+    return total;
+}
+
+int64_t PrefixSum::total() const {
+    return this->sum(m_values.size());
+}
+
+size_t PrefixSum::find(int64_t offset) const {
+    if (offset < 0) return 0;
+    size_t step = 1;
+    while (step * 2 <= m_values.size()) {
+        step *= 2;
+    }
+    size_t pos = 0;
+    for (; step; step /= 2) {
+        if (pos + step <= m_values.size() && m_tree[pos + step] <= offset) {
+            pos += step;
+            offset -= m_tree[pos];
+        }
+    }
+    return pos;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Running totals over a sequence of values, kept as a Fenwick tree so
+// that changing a value and finding which one an offset falls in are
+// both O(log n) instead of going through everything before it
+class PrefixSum {
+protected:
+    // 1-based, m_tree[i] covers the (i & -i) values ending at i
+    std::vector<int64_t> m_tree;
+    std::vector<int> m_values;
+
+public:
+    void assign(size_t count, int value);
+    size_t size() const;
+
+    int get(size_t index) const;
+    void set(size_t index, int value);
+
+    // sum of the values before index
+    int64_t sum(size_t index) const;
+    int64_t total() const;
+    // the index whose span contains offset, or size() if it's past the end
+    size_t find(int64_t offset) const;
+};
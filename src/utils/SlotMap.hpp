@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+// Index and generation packed into 32 bits. The default one is null,
+// since generations start from 1
+class SlotHandle {
+protected:
+    uint32_t m_value = 0;
+
+public:
+    SlotHandle() = default;
+    explicit SlotHandle(uint32_t value) : m_value(value) {}
+
+    uint32_t value() const {
+        return m_value;
+    }
+    explicit operator bool() const {
+        return m_value != 0;
+    }
+    bool operator==(SlotHandle const& other) const {
+        return m_value == other.m_value;
+    }
+    bool operator!=(SlotHandle const& other) const {
+        return m_value != other.m_value;
+    }
+};
+
+namespace std {
+    template<>
+    struct hash<SlotHandle> {
+        size_t operator()(SlotHandle const& handle) const {
+            return hash<uint32_t>()(handle.value());
+        }
+    };
+}
+
+// Values stored in reused slots, handed out as handles that carry the
+// slot's generation. Releasing a slot bumps its generation, so handles
+// to it that are still around stop resolving instead of pointing at
+// whatever took the slot next. The handle's low IndexBits are the slot
+// index and the GenerationBits above them the generation, which can be
+// narrowed for IDs that have to fit in less than 32 bits. Handles with
+// the index bits all set are never given out, so they make sentinels
+template<class T, unsigned IndexBits = 20, unsigned GenerationBits = 32 - IndexBits>
+class SlotMap {
+public:
+    static_assert(IndexBits > 0 && GenerationBits > 0 && IndexBits + GenerationBits <= 32);
+    static constexpr uint32_t s_indexMask = (1u << IndexBits) - 1;
+    static constexpr uint32_t s_maxGeneration = (~0u) >> (32 - GenerationBits);
+    static constexpr size_t s_capacity = s_indexMask;
+
+protected:
+    struct Slot {
+        std::optional<T> m_value;
+        uint32_t m_generation = 1;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_free;
+    size_t m_size = 0;
+
+    static SlotHandle pack(uint32_t index, uint32_t generation) {
+        return SlotHandle((generation << IndexBits) | index);
+    }
+
+    Slot const* slot(SlotHandle handle) const {
+        auto index = handle.value() & s_indexMask;
+        auto generation = handle.value() >> IndexBits;
+        if (index >= m_slots.size()) return nullptr;
+        auto& slot = m_slots[index];
+        if (!slot.m_value || slot.m_generation != generation) return nullptr;
+        return &slot;
+    }
+
+public:
+    // Returns a null handle if every slot is taken
+    SlotHandle insert(T value) {
+        uint32_t index;
+        if (!m_free.empty()) {
+            index = m_free.back();
+            m_free.pop_back();
+        } else {
+            if (m_slots.size() >= s_capacity) return SlotHandle();
+            index = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+        auto& slot = m_slots[index];
+        slot.m_value.emplace(std::move(value));
+        m_size++;
+        return pack(index, slot.m_generation);
+    }
+
+    // Returns false for handles that are stale or null
+    bool erase(SlotHandle handle) {
+        if (!this->slot(handle)) return false;
+        auto index = handle.value() & s_indexMask;
+        auto& slot = m_slots[index];
+        slot.m_value.reset();
+        // generation 0 would make index 0 a null handle
+        slot.m_generation = slot.m_generation == s_maxGeneration ? 1 : slot.m_generation + 1;
+        m_free.push_back(index);
+        m_size--;
+        return true;
+    }
+
+    T* get(SlotHandle handle) {
+        auto slot = this->slot(handle);
+        return slot ? const_cast<T*>(&*slot->m_value) : nullptr;
+    }
+
+    T const* get(SlotHandle handle) const {
+        auto slot = this->slot(handle);
+        return slot ? &*slot->m_value : nullptr;
+    }
+
+    bool contains(SlotHandle handle) const {
+        return this->slot(handle) != nullptr;
+    }
+
+    void clear() {
+        for (uint32_t i = 0; i < m_slots.size(); i++) {
+            if (m_slots[i].m_value) {
+                this->erase(pack(i, m_slots[i].m_generation));
+            }
+        }
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+    // calls func with every value in the map, in slot order
+    template<class Func>
+    void forEach(Func&& func) {
+        for (auto& slot : m_slots) {
+            if (slot.m_value) func(*slot.m_value);
+        }
+    }
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+// Non-owning view over contiguous elements, for handing out a
+// container's contents without copying them
+template<class T>
+class Span {
+protected:
+    T* m_data = nullptr;
+    size_t m_size = 0;
+
+public:
+    using iterator = T*;
+    using reverse_iterator = std::reverse_iterator<T*>;
+
+    Span() = default;
+    Span(T* data, size_t size) : m_data(data), m_size(size) {}
+    template<class U, class A>
+    Span(std::vector<U, A> const& vec) : m_data(vec.data()), m_size(vec.size()) {}
+    template<class U, class A>
+    Span(std::vector<U, A>& vec) : m_data(vec.data()), m_size(vec.size()) {}
+
+    iterator begin() const { return m_data; }
+    iterator end() const { return m_data + m_size; }
+    reverse_iterator rbegin() const { return reverse_iterator(this->end()); }
+    reverse_iterator rend() const { return reverse_iterator(this->begin()); }
+
+    T& operator[](size_t index) const { return m_data[index]; }
+    T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return !m_size; }
+};
+
+// Lets a range-based for go over a container back to front without copying it
+template<class C>
+class Reversed {
+protected:
+    C& m_range;
+
+public:
+    Reversed(C& range) : m_range(range) {}
+
+    auto begin() const { return m_range.rbegin(); }
+    auto end() const { return m_range.rend(); }
+};
+
+template<class C>
+Reversed<C> reversed(C& range) {
+    return Reversed<C>(range);
+}
@@ -0,0 +1,119 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <utility>
+
+ThreadPool::ThreadPool(size_t threads) {
+    this->start(threads);
+}
+
+ThreadPool::~ThreadPool() {
+    this->stop();
+}
+
+ThreadPool* ThreadPool::get() {
+    static auto inst = new ThreadPool(std::max(std::thread::hardware_concurrency(), 1u));
+    return inst;
+}
+
+void ThreadPool::start(size_t threads) {
+    m_stopping = false;
+    for (size_t i = 1; i < threads; i++) {
+        m_threads.emplace_back([this]() -> void { this->work(); });
+    }
+}
+
+void ThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+size_t ThreadPool::threads() const {
+    return m_threads.size() + 1;
+}
+
+void ThreadPool::threads(size_t threads) {
+    threads = std::max<size_t>(threads, 1);
+    if (threads == this->threads()) return;
+    this->stop();
+    this->start(threads);
+}
+
+void ThreadPool::work() {
+    size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_wake.wait(lock, [&]() -> bool {
+                return m_stopping || m_generation != seen;
+            });
+            if (m_stopping) return;
+            seen = m_generation;
+        }
+        this->drain(true);
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (--m_running == 0) {
+            m_done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::drain(bool worker) {
+    for (;;) {
+        auto i = m_next++;
+        if (i >= m_count) return;
+        try {
+            (*m_job)(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (!m_error) m_error = std::current_exception();
+        }
+        if (worker) m_offloaded++;
+    }
+}
+
+void ThreadPool::run(size_t count, std::function<void(size_t)> const& job) {
+    if (!count) return;
+    m_stats.m_batches++;
+    m_stats.m_jobs += count;
+    // not worth waking anyone up for
+    if (m_threads.empty() || count == 1) {
+        for (size_t i = 0; i < count; i++) {
+            job(i);
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_job = &job;
+        m_count = count;
+        m_next = 0;
+        m_offloaded = 0;
+        m_error = nullptr;
+        m_running = m_threads.size();
+        m_generation++;
+    }
+    m_wake.notify_all();
+    this->drain(false);
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_done.wait(lock, [this]() -> bool { return m_running == 0; });
+    m_job = nullptr;
+    m_stats.m_offloaded += m_offloaded;
+    if (m_error) {
+        std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+}
+
+ThreadPool::Stats const& ThreadPool::stats() const {
+    return m_stats;
+}
+
+void ThreadPool::resetStats() {
+    m_stats = Stats();
+}
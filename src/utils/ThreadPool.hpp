@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads for splitting a batch of independent jobs. The
+// thread that runs a batch works on it too and returns once every
+// job is done, so nothing outlives the call. Batches don't nest
+class ThreadPool {
+public:
+    struct Stats {
+        size_t m_batches = 0;
+        size_t m_jobs = 0;
+        // jobs run by the workers rather than the calling thread
+        size_t m_offloaded = 0;
+    };
+
+protected:
+    std::vector<std::thread> m_threads;
+    std::mutex m_lock;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::function<void(size_t)> const* m_job = nullptr;
+    size_t m_count = 0;
+    std::atomic<size_t> m_next { 0 };
+    std::atomic<size_t> m_offloaded { 0 };
+    // workers that haven't finished the current batch
+    size_t m_running = 0;
+    size_t m_generation = 0;
+    bool m_stopping = false;
+    std::exception_ptr m_error;
+    Stats m_stats;
+
+    void work();
+    void drain(bool worker);
+    void start(size_t threads);
+    void stop();
+
+public:
+    // threads counts the calling thread, so 1 means no workers
+    ThreadPool(size_t threads);
+    ~ThreadPool();
+
+    // as many threads as the machine has cores
+    static ThreadPool* get();
+
+    size_t threads() const;
+    void threads(size_t threads);
+
+    // Calls job with every index in [0, count) and returns when
+    // they've all run, rethrowing the first exception one threw
+    void run(size_t count, std::function<void(size_t)> const& job);
+
+    Stats const& stats() const;
+    void resetStats();
+};
@@ -1,4 +1,5 @@
 #include "utils.hpp"
+#include <RoundRectCache.hpp>
 
 // https://stackoverflow.com/questions/67052759/c-gdi-how-to-draw-rectangle-with-border-radius
 void GetRoundRectPath(GraphicsPath *pPath, Rect r, int dia) {
@@ -39,28 +40,47 @@ void GetRoundRectPath(GraphicsPath *pPath, Rect r, int dia) {
     pPath->CloseFigure();
 }
 
-void DrawRoundRect(Graphics* pGraphics, Rect r, Color const& color, int radius, int width) {
+struct GdiRoundRectPath : public RoundRectCache::Native {
+    GraphicsPath m_path;
+};
+
+static GraphicsPath const* GetCachedRoundRectPath(int width, int height, int dia) {
+    auto& shape = RoundRectCache::get()->shape(width, height, dia);
+    if (!shape.m_native) {
+        auto native = new GdiRoundRectPath();
+        GetRoundRectPath(&native->m_path, Rect(0, 0, width, height), dia);
+        shape.m_native.reset(native);
+    }
+    return &static_cast<GdiRoundRectPath*>(shape.m_native.get())->m_path;
+}
+
+void DrawRoundRect(Graphics* pGraphics, Rect r, Pen const& pen, int radius, int width) {
     int dia = 2*radius;
 
     int oldPageUnit = pGraphics->SetPageUnit(UnitPixel);
 
-    Pen pen(color, 1);    
-    pen.SetAlignment(PenAlignmentCenter);
-
-    GraphicsPath path;
-    GetRoundRectPath(&path, r, dia);
+    auto path = GetCachedRoundRectPath(r.Width, r.Height, dia);
+    pGraphics->TranslateTransform(static_cast<REAL>(r.X), static_cast<REAL>(r.Y));
+    pGraphics->DrawPath(&pen, path);
+    pGraphics->TranslateTransform(static_cast<REAL>(-r.X), static_cast<REAL>(-r.Y));
 
-    pGraphics->DrawPath(&pen, &path);
     pGraphics->SetPageUnit((Unit)oldPageUnit);
 }
 
+void DrawRoundRect(Graphics* pGraphics, Rect r, Color const& color, int radius, int width) {
+    Pen pen(color, 1);    
+    pen.SetAlignment(PenAlignmentCenter);
+    return DrawRoundRect(pGraphics, r, pen, radius, width);
+}
+
 void FillRoundRect(Graphics* pGraphics, Rect r, Brush const& brush, int radius, int width) {
     int dia = 2 * radius;
     int oldPageUnit = pGraphics->SetPageUnit(UnitPixel);
 
-    GraphicsPath path;
-    GetRoundRectPath(&path, r, dia);
-    pGraphics->FillPath(&brush, &path);
+    auto path = GetCachedRoundRectPath(r.Width, r.Height, dia);
+    pGraphics->TranslateTransform(static_cast<REAL>(r.X), static_cast<REAL>(r.Y));
+    pGraphics->FillPath(&brush, path);
+    pGraphics->TranslateTransform(static_cast<REAL>(-r.X), static_cast<REAL>(-r.Y));
 
     pGraphics->SetPageUnit((Unit)oldPageUnit);
 }
@@ -143,6 +163,24 @@ RECT toRECT(Rect const& r) {
     };
 }
 
+Rect toRect(RECT const& r) {
+    return {
+        r.left,
+        r.top,
+        r.right - r.left,
+        r.bottom - r.top,
+    };
+}
+
+// like Rect::Union, but empty rects don't drag the result towards the origin
+Rect unionRect(Rect const& a, Rect const& b) {
+    if (a.IsEmptyArea()) return b;
+    if (b.IsEmptyArea()) return a;
+    Rect r;
+    Rect::Union(r, a, b);
+    return r;
+}
+
 Point toPoint(POINT const& p) {
     return { p.x, p.y };
 }
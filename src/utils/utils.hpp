@@ -10,7 +10,10 @@
 using namespace Gdiplus;
 
 void GetRoundRectPath(GraphicsPath *pPath, Rect r, int dia);
+// The outlines come from RoundRectCache and are drawn with the graphics
+// translated to the rect's corner, so brushes work in local coordinates
 void DrawRoundRect(Graphics* pGraphics, Rect r, Color const& color, int radius, int width);
+void DrawRoundRect(Graphics* pGraphics, Rect r, Pen const& pen, int radius, int width);
 void FillRoundRect(Graphics* pGraphics, Rect r, Color const& color, int radius, int width);
 void FillRoundRect(Graphics* pGraphics, Rect r, Brush const& brush, int radius, int width);
 
@@ -33,6 +36,8 @@ std::wostream& operator<<(std::wostream&, RectF);
 std::wstring toWString(std::string const& str);
 RectF toRectF(Rect const& r);
 RECT toRECT(Rect const& r);
+Rect toRect(RECT const& r);
+Rect unionRect(Rect const& a, Rect const& b);
 Point toPoint(POINT const& p);
 PointF toPointF(Rect const& p);
 
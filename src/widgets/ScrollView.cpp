@@ -0,0 +1,271 @@
+#include "ScrollView.hpp"
+#include <Window.hpp>
+#include <cmath>
+
+int ScrollView::s_wheelStep = 60_px;
+int ScrollView::s_dragThreshold = 6_px;
+int ScrollView::s_barWidth = 4_px;
+double ScrollView::s_smoothing = 40.0;
+
+ScrollView::ScrollView(Widget* content) {
+    m_typeName = "ScrollView";
+    this->clipChildren();
+    this->autoResize();
+    this->content(content);
+    this->show();
+}
+
+ScrollView::ScrollView() : ScrollView(new VerticalLayout()) {}
+
+ScrollView::~ScrollView() {
+    this->stopAnimation();
+}
+
+Widget* ScrollView::content() const {
+    return m_content;
+}
+
+Widget* ScrollView::content(Widget* other, bool releaseOld) {
+    auto old = m_content;
+    if (m_content) {
+        this->remove(m_content, releaseOld);
+    }
+    m_content = other;
+    if (other) {
+        m_content->autoResize();
+        m_content->show();
+        this->add(m_content);
+    }
+    this->scrollTo(0, 0, true);
+    return old;
+}
+
+void ScrollView::add(Widget* child) {
+    if (child == m_content) {
+        Widget::add(child);
+    } else {
+        if (m_content) m_content->add(child);
+    }
+}
+
+void ScrollView::remove(Widget* child, bool release) {
+    if (child == m_content) {
+        Widget::remove(child, release);
+    } else {
+        if (m_content) m_content->remove(child, release);
+    }
+}
+
+void ScrollView::clear() {
+    if (m_content) m_content->clear();
+}
+
+void ScrollView::direction(bool horizontal, bool vertical) {
+    m_horizontal = horizontal;
+    m_vertical = vertical;
+    this->clampTarget();
+    this->scrollTo(m_targetX, m_targetY, true);
+}
+
+// how far what's in widget sticks out from origin, stopping at
+// widgets that clip their children since nothing past them shows
+static void reach(Widget* widget, Point const& origin, Size& size) {
+    for (auto& child : widget->getChildren()) {
+        if (!child->visible()) continue;
+        auto r = child->rect();
+        size.Width = std::max(size.Width, r.X + r.Width - origin.X);
+        size.Height = std::max(size.Height, r.Y + r.Height - origin.Y);
+        if (!child->clipsChildren()) {
+            reach(child, origin, size);
+        }
+    }
+}
+
+Size ScrollView::extent() const {
+    if (!m_content) return Size();
+    if (m_extentDirty) {
+        auto r = m_content->rect();
+        m_extent = Size(r.Width, r.Height);
+        reach(m_content, Point(r.X, r.Y), m_extent);
+        m_extentDirty = false;
+    }
+    return m_extent;
+}
+
+void ScrollView::clampTarget() {
+    auto extent = this->extent();
+    m_targetX = m_horizontal ?
+        std::clamp(m_targetX, 0, std::max(extent.Width - this->width(), 0)) : 0;
+    m_targetY = m_vertical ?
+        std::clamp(m_targetY, 0, std::max(extent.Height - this->height(), 0)) : 0;
+}
+
+Point ScrollView::scroll() const {
+    return Point(
+        static_cast<int>(std::lround(m_scrollX)),
+        static_cast<int>(std::lround(m_scrollY))
+    );
+}
+
+void ScrollView::scrollTo(int x, int y, bool immediately) {
+    m_targetX = x;
+    m_targetY = y;
+    this->clampTarget();
+    if (immediately || !m_window) {
+        this->stopAnimation();
+        m_scrollX = m_targetX;
+        m_scrollY = m_targetY;
+        this->invalidateLayout();
+        this->update();
+        return;
+    }
+    if (m_animation) return;
+    auto& scheduler = m_window->scheduler();
+    m_lastFrame = scheduler.clock().now();
+    m_animation = scheduler.animate([this](double now) -> bool {
+        return this->step(now);
+    });
+}
+
+void ScrollView::scrollBy(int dx, int dy, bool immediately) {
+    this->scrollTo(m_targetX + dx, m_targetY + dy, immediately);
+}
+
+bool ScrollView::step(double now) {
+    // a long stall shouldn't turn into a jump
+    auto elapsed = std::min(now - m_lastFrame, 100.0);
+    m_lastFrame = now;
+    auto t = 1.0 - std::exp(-elapsed / s_smoothing);
+    m_scrollX += (m_targetX - m_scrollX) * t;
+    m_scrollY += (m_targetY - m_scrollY) * t;
+    auto done =
+        std::abs(m_targetX - m_scrollX) < 0.5 &&
+        std::abs(m_targetY - m_scrollY) < 0.5;
+    if (done) {
+        m_scrollX = m_targetX;
+        m_scrollY = m_targetY;
+        m_animation = 0;
+    }
+    // the content is moved as part of layout, which only lays out
+    // this and its parents since the content itself is still clean
+    this->invalidateLayout();
+    return !done;
+}
+
+void ScrollView::stopAnimation() {
+    if (m_animation && m_window) {
+        m_window->scheduler().cancel(m_animation);
+    }
+    m_animation = 0;
+}
+
+bool ScrollView::wantsMouse() const {
+    return true;
+}
+
+bool ScrollView::handlesChildMouse() const {
+    // drags can start anywhere on the content
+    return true;
+}
+
+bool ScrollView::mouseWheel(int delta) {
+    auto x = m_targetX;
+    auto y = m_targetY;
+    auto step = -delta * s_wheelStep / WHEEL_DELTA;
+    if (m_vertical) {
+        this->scrollBy(0, step);
+    } else {
+        this->scrollBy(step, 0);
+    }
+    // at either end the wheel is left for whatever's around this
+    return x != m_targetX || y != m_targetY;
+}
+
+void ScrollView::mouseDown(int x, int y) {
+    m_dragStart = { x, y };
+    m_dragScroll = { m_targetX, m_targetY };
+    m_dragging = false;
+}
+
+void ScrollView::mouseMove(int x, int y) {
+    if (!m_mousedown) {
+        if (m_dragging) {
+            m_dragging = false;
+            this->releaseMouse();
+        }
+        return;
+    }
+    auto dx = m_horizontal ? x - m_dragStart.x : 0;
+    auto dy = m_vertical ? y - m_dragStart.y : 0;
+    if (!m_dragging) {
+        if (std::abs(dx) + std::abs(dy) < s_dragThreshold) return;
+        m_dragging = true;
+        // whatever the press started on isn't getting clicked now
+        m_window->cancelPress(this);
+        this->captureMouse();
+    }
+    // moves come in at most once a frame, so this is already paced
+    this->scrollTo(m_dragScroll.x - dx, m_dragScroll.y - dy, true);
+}
+
+void ScrollView::mouseUp(int x, int y) {
+    if (m_dragging) {
+        m_dragging = false;
+        this->releaseMouse();
+        return;
+    }
+    Widget::mouseUp(x, y);
+}
+
+void ScrollView::collectText(std::vector<TextQuery>& queries, SIZE available) {
+    if (!m_content) return;
+    if (!m_autoresize) {
+        available = { this->width(), this->height() };
+    }
+    Widget::collectChildText(m_content, queries, available);
+}
+
+void ScrollView::updateSize(HDC hdc, SIZE available) {
+    // anything in the content that changed size went through here
+    m_extentDirty = true;
+    if (m_autoresize) {
+        this->storeSize(available.cx, available.cy);
+    }
+    if (m_content && m_content->visible()) {
+        m_content->measure(hdc, { this->width(), this->height() });
+    }
+}
+
+void ScrollView::updateLayout() {
+    if (!m_content) return;
+    auto scroll = this->scroll();
+    m_content->move(-scroll.X, -scroll.Y);
+}
+
+void ScrollView::paint(Canvas& canvas) {
+    auto r = this->rect();
+    if (m_content && m_content->visible()) {
+        Point moved;
+        Rect bounds;
+        auto& list = Widget::record(m_content, canvas, moved, bounds);
+        canvas.drawScrolled(m_handle.value(), list, moved, bounds, r);
+    }
+    auto extent = this->extent();
+    auto scroll = this->scroll();
+    if (m_vertical && extent.Height > r.Height) {
+        auto size = std::max(r.Height * r.Height / extent.Height, s_barWidth * 2);
+        auto pos = (r.Height - size) * scroll.Y / (extent.Height - r.Height);
+        canvas.fillRoundRect(
+            Rect(r.X + r.Width - s_barWidth, r.Y + pos, s_barWidth, size),
+            s_barWidth / 2, Style::separator()
+        );
+    }
+    if (m_horizontal && extent.Width > r.Width) {
+        auto size = std::max(r.Width * r.Width / extent.Width, s_barWidth * 2);
+        auto pos = (r.Width - size) * scroll.X / (extent.Width - r.Width);
+        canvas.fillRoundRect(
+            Rect(r.X + pos, r.Y + r.Height - s_barWidth, size, s_barWidth),
+            s_barWidth / 2, Style::separator()
+        );
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Widget.hpp>
+#include <Layout.hpp>
+
+// Scrolls a content widget around inside of itself. The canvas keeps
+// what's in view on a surface, so a scroll step shifts the pixels that
+// are already there and only paints the strip coming into view. Wheel
+// scrolling eases towards where it's headed over the next few frames,
+// and dragging the content follows the pointer once per frame. The
+// content is sized to the view, anything that doesn't fit in it has to
+// be its children sticking out
+class ScrollView : public Widget {
+public:
+    static int s_wheelStep;
+    static int s_dragThreshold;
+    static int s_barWidth;
+    // how fast the easing closes in, as a time constant in milliseconds
+    static double s_smoothing;
+
+protected:
+    Widget* m_content = nullptr;
+    bool m_horizontal = false;
+    bool m_vertical = true;
+    // where the content is scrolled to, and where it's headed
+    double m_scrollX = 0.0;
+    double m_scrollY = 0.0;
+    int m_targetX = 0;
+    int m_targetY = 0;
+    size_t m_animation = 0;
+    double m_lastFrame = 0.0;
+    bool m_dragging = false;
+    POINT m_dragStart;
+    POINT m_dragScroll;
+    // how big the content and everything in it is, worked out
+    // again on demand after the content has been measured
+    mutable Size m_extent;
+    mutable bool m_extentDirty = true;
+
+    Size extent() const;
+    void clampTarget();
+    bool step(double now);
+    void stopAnimation();
+    void collectText(std::vector<TextQuery>& queries, SIZE available) override;
+
+public:
+    ScrollView(Widget* content);
+    ScrollView();
+    ~ScrollView();
+
+    Widget* content() const;
+    Widget* content(Widget* other, bool releaseOld = true);
+    void direction(bool horizontal, bool vertical);
+
+    Point scroll() const;
+    // eased over unless immediately is set
+    void scrollTo(int x, int y, bool immediately = false);
+    void scrollBy(int dx, int dy, bool immediately = false);
+
+    bool wantsMouse() const override;
+    bool handlesChildMouse() const override;
+    bool mouseWheel(int delta) override;
+    void mouseDown(int x, int y) override;
+    void mouseMove(int x, int y) override;
+    void mouseUp(int x, int y) override;
+
+    void add(Widget* child) override;
+    void remove(Widget* child, bool release = true) override;
+    void clear() override;
+
+    void updateSize(HDC, SIZE) override;
+    void updateLayout() override;
+    void paint(Canvas&) override;
+};
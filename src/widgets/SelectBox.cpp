@@ -18,19 +18,25 @@ SelectBox::SelectBox() : SelectBox({}) {}
 
 void SelectBox::drawWidth(int mw) {
     m_drawWidth = mw;
+    m_measureString = std::wstring(m_drawWidth, 'w');
+    this->invalidateLayout();
     this->update();
 }
 
+std::wstring const* SelectBox::sizingText() const {
+    return &m_measureString;
+}
+
 void SelectBox::updateSize(HDC hdc, SIZE available) {
     if (m_autoresize) {
-        auto r = this->measureText(hdc, std::wstring(m_drawWidth, 'w'), available, StringFormat());
+        auto r = this->measureText(hdc, m_measureString, available);
         this->resize(static_cast<int>(r.Width) + Button::s_sidePad * 2, static_cast<int>(r.Height) + Button::s_topPad * 2);
         m_autoresize = true;
     }
     Widget::updateSize(hdc, available);
 }
 
-void SelectBox::paint(HDC hdc, PAINTSTRUCT* ps) {
+void SelectBox::paint(Canvas& canvas) {
 
 }
 
@@ -8,6 +8,9 @@ protected:
     std::vector<std::string> m_options;
     size_t m_selected = 0;
     int m_drawWidth = 0;
+    std::wstring m_measureString = L"";
+
+    std::wstring const* sizingText() const override;
 
 public:
     SelectBox(std::initializer_list<std::string> const&);
@@ -17,7 +20,7 @@ public:
     void drawWidth(int mw);
     
     void updateSize(HDC hdc, SIZE) override;
-    void paint(HDC hdc, PAINTSTRUCT* ps) override;
+    void paint(Canvas& canvas) override;
 
     bool wantsMouse() const override;
     HCURSOR cursor() const;
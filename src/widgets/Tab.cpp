@@ -55,10 +55,7 @@ void Separator::updateSize(HDC hdc, SIZE size) {
     }
 }
 
-void Separator::paint(HDC hdc, PAINTSTRUCT* ps) {
-    Graphics g(hdc);
-    InitGraphics(g);
-
+void Separator::paint(Canvas& canvas) {
     auto r = this->rect();
     r.Y += r.Height / 2 - m_drawSize / 2;
     r.Height = m_drawSize;
@@ -66,23 +63,26 @@ void Separator::paint(HDC hdc, PAINTSTRUCT* ps) {
     r.Width -= 2 * (m_pad ? Tab::s_pad : 0);
     auto rf = toRectF(r);
     if (rf.Height == 1) rf.Height /= 2;
-    g.FillRectangle(&SolidBrush(Style::separator()), rf);
+    canvas.fillRect(rf, Style::separator());
 
-    Widget::paint(hdc, ps);
+    Widget::paint(canvas);
 }
 
 void Separator::pad(bool p) {
     m_pad = p;
+    this->invalidateLayout();
     this->update();
 }
 
 void Separator::size(int s) {
     m_size = s;
+    this->invalidateLayout();
     this->update();
 }
 
 void Separator::drawSize(int s) {
     m_drawSize = s;
+    this->invalidateLayout();
     this->update();
 }
 
@@ -98,6 +98,10 @@ Tab::Tab(size_t id, std::string const& text, Tab::Type type) : m_id(id) {
 
 Tab::Tab(std::string const& text, Tab::Type type) : Tab(0, text, type) {}
 
+std::wstring const* Tab::sizingText() const {
+    return nullptr;
+}
+
 void Tab::updateSize(HDC hdc, SIZE size) {
     Widget::updateSize(hdc, size);
     if (m_autoresize) {
@@ -140,7 +144,7 @@ void Tab::makeButton(bool b) {
     this->update();
 }
 
-void Tab::paint(HDC hdc, PAINTSTRUCT* ps) {
+void Tab::paint(Canvas& canvas) {
     auto fullRect = this->rect();
     auto r = fullRect;
     r.X += Tab::s_pad;
@@ -157,54 +161,33 @@ void Tab::paint(HDC hdc, PAINTSTRUCT* ps) {
     ar.X = r.Width + s_pad / 2;
     ar.Width = s_height;
     
-    Graphics g(hdc);
-    InitGraphics(g);
-
     if (m_selected) {
-        SolidBrush bgBrush(Style::selectedTab());
-        g.FillRectangle(
-            &bgBrush,
-            toRectF(fullRect)
-        );
+        canvas.fillRect(toRectF(fullRect), Style::selectedTab());
     }
     if (m_hovered) {
-        SolidBrush hoverBrush(Style::hover());
-        g.FillRectangle(
-            &hoverBrush,
-            toRectF(fullRect)
-        );
+        canvas.fillRect(toRectF(fullRect), Style::hover());
     }
 
-    Graphics gt(hdc);
-
-    InitGraphics(gt);
-    Region reg(tr);
-    gt.SetClip(&reg);
-    StringFormat f;
-    f.SetLineAlignment(StringAlignmentCenter);
-    f.SetTrimming(StringTrimmingNone);
-    f.SetFormatFlags(StringFormatFlagsNoFitBlackBox);
-    Font font(hdc, Manager::get()->loadFont(m_font, m_fontSize, m_style));
-    SolidBrush brush(color::alpha(m_color, m_hovered || m_selected ? 255 : 125));
-    FontFamily family;
-    font.GetFamily(&family);
-    gt.DrawString(
-        m_text.c_str(), -1,
-        &font,
+    canvas.save();
+    canvas.clipRect(tr);
+    canvas.drawText(
+        m_text, m_font, m_fontSize, m_style,
+        color::alpha(m_color, m_hovered || m_selected ? 255 : 125),
         RectF {
             static_cast<float>(tr.X),
             static_cast<float>(tr.Y + 1.5_pxf),
             0.f,
             static_cast<float>(tr.Height)
         },
-        &f, &brush
+        {
+            StringAlignmentNear, StringAlignmentCenter,
+            StringTrimmingNone, StringFormatFlagsNoFitBlackBox
+        }
     );
+    canvas.restore();
     
     switch (m_type) {
         case Type::Diamond: {
-            SolidBrush diamondBrush(
-                color::alpha(Style::text(), 80)
-            );
             auto dh = static_cast<int>(sqrtf(
                 powf(static_cast<float>(Tab::s_dot), 2) * 2.f)
             );
@@ -212,61 +195,57 @@ void Tab::paint(HDC hdc, PAINTSTRUCT* ps) {
                 r.X + Tab::s_dot / 2.f,
                 r.Y + (s_height - dh) / 2.f
             );
-            g.TranslateTransform(center.X, center.Y);
-            g.RotateTransform(45.f);
-            g.FillRectangle(
-                &diamondBrush,
-                Rect { 0, 0, s_dot, s_dot }
+            canvas.save();
+            canvas.translate(center.X, center.Y);
+            canvas.rotate(45.f);
+            canvas.fillRect(
+                toRectF(Rect { 0, 0, s_dot, s_dot }),
+                color::alpha(Style::text(), 80)
             );
-            g.RotateTransform(-45.f);
-            g.TranslateTransform(-center.X, -center.Y);
+            canvas.restore();
         } break;
 
         case Type::Plus: {
-            Pen pen(color::alpha(Style::text(), 80), m_fontSize / 8.f);
-            GraphicsPath path;
-            auto pad = (s_height - s_arrow) / 2;
-            path.AddLine(
+            Path path;
+            path.addLine(
                 r.X + Tab::s_dot / 2, r.Y + (s_height - Tab::s_dot) / 2,
                 r.X + Tab::s_dot / 2, r.Y + (s_height + Tab::s_dot) / 2
             );
-            path.StartFigure();
-            path.AddLine(
+            path.startFigure();
+            path.addLine(
                 r.X, r.Y + s_height / 2,
                 r.X + Tab::s_dot, r.Y + s_height / 2
             );
-            g.DrawPath(&pen, &path);
+            canvas.strokePath(path, color::alpha(Style::text(), 80), m_fontSize / 8.f);
         } break;
 
         default: {
-            SolidBrush dotBrush(m_dotColor);
-            g.FillEllipse(
-                &dotBrush,
-                Rect {
+            canvas.fillEllipse(
+                toRectF(Rect {
                     r.X,
                     r.Y + (s_height - Tab::s_dot) / 2,
                     Tab::s_dot, Tab::s_dot
-                }
+                }),
+                m_dotColor
             );
         } break;
     }
 
-    if (m_arrow && (m_hovered || m_selected) && m_width > s_pad * 2 + s_dot + s_arrow * 2) {
-        Pen pen(Style::text(), m_fontSize / 8.f);
-        GraphicsPath path;
+    if (m_arrow && (m_hovered || m_selected) && this->width() > s_pad * 2 + s_dot + s_arrow * 2) {
+        Path path;
         auto pad = (s_height - s_arrow) / 2;
-        path.AddLine(
+        path.addLine(
             ar.X, ar.Y + pad,
             ar.X + s_arrow / 2, ar.Y + s_height / 2
         );
-        path.AddLine(
+        path.addLine(
             ar.X + s_arrow / 2, ar.Y + s_height / 2,
             ar.X, ar.Y + s_height - pad
         );
-        g.DrawPath(&pen, &path);
+        canvas.strokePath(path, Style::text(), m_fontSize / 8.f);
     }
 
-    Widget::paint(hdc, ps);
+    Widget::paint(canvas);
 }
 
 bool Tab::wantsMouse() const {
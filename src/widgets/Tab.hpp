@@ -49,12 +49,15 @@ protected:
 
     friend class Tabs;
 
+    // tabs are as wide as they're allowed to be, whatever the text
+    std::wstring const* sizingText() const override;
+
 public:
     Tab(size_t id, std::string const& text, Type type = Type::Dot);
     Tab(std::string const& text, Type type = Type::Dot);
 
     void updateSize(HDC hdc, SIZE) override;
-    void paint(HDC hdc, PAINTSTRUCT* ps) override;
+    void paint(Canvas& canvas) override;
 
     bool wantsMouse() const override;
     HCURSOR cursor() const;
@@ -77,7 +80,7 @@ public:
     Separator(bool pad = true, int size = 20_px, int drawSize = 2_px);
 
     void updateSize(HDC hdc, SIZE) override;
-    void paint(HDC hdc, PAINTSTRUCT* ps) override;
+    void paint(Canvas& canvas) override;
 
     void pad(bool = true);
     void size(int);
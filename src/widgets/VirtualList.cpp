@@ -0,0 +1,216 @@
+#include "VirtualList.hpp"
+
+int VirtualList::s_wheelStep = 60_px;
+
+VirtualList::VirtualList(size_t count, RowFactory factory, int estimatedRowHeight) {
+    m_typeName = "VirtualList";
+    m_factory = factory;
+    m_estimate = estimatedRowHeight;
+    m_heights.assign(count, m_estimate);
+    this->clipChildren();
+    this->autoResize();
+    this->show();
+}
+
+Widget* VirtualList::build(size_t index, Widget* recycled) {
+    m_stats.m_built++;
+    auto widget = m_factory(index, recycled);
+    if (widget != recycled) {
+        if (recycled) {
+            Widget::remove(recycled);
+        }
+        if (widget) {
+            m_stats.m_created++;
+            Widget::add(widget);
+        }
+    } else if (widget) {
+        m_stats.m_recycled++;
+    }
+    if (widget) {
+        widget->show();
+    }
+    return widget;
+}
+
+void VirtualList::recycle(Widget* widget) {
+    if (!widget) return;
+    widget->hide();
+    m_pool.push_back(widget);
+}
+
+void VirtualList::updateRows() {
+    auto count = m_heights.size();
+    auto first = m_heights.find(m_scroll);
+    auto last = std::min(m_heights.find(m_scroll + this->height()) + 1, count);
+    first = first > m_overscan ? first - m_overscan : 0;
+    last = std::min(last + m_overscan, count);
+    first = std::min(first, last);
+
+    for (auto& row : m_rows) {
+        if (row.m_index < first || row.m_index >= last) {
+            this->recycle(row.m_widget);
+        }
+    }
+    m_nextRows.clear();
+    for (auto i = first; i < last; i++) {
+        if (i >= m_first && i < m_first + m_rows.size()) {
+            m_nextRows.push_back(m_rows[i - m_first]);
+        } else {
+            Widget* recycled = nullptr;
+            if (m_pool.size()) {
+                recycled = m_pool.back();
+                m_pool.pop_back();
+            }
+            m_nextRows.push_back({ i, this->build(i, recycled) });
+        }
+    }
+    m_rows.swap(m_nextRows);
+    m_first = first;
+}
+
+int VirtualList::maxScroll() const {
+    return std::max(this->contentHeight() - this->height(), 0);
+}
+
+void VirtualList::count(size_t count) {
+    // whatever the rows showed may have moved, so they're all built again
+    for (auto& row : m_rows) {
+        this->recycle(row.m_widget);
+    }
+    m_rows.clear();
+    m_first = 0;
+    m_heights.assign(count, m_estimate);
+    m_scroll = std::min(m_scroll, this->maxScroll());
+    this->invalidateLayout();
+    this->update();
+}
+
+size_t VirtualList::count() const {
+    return m_heights.size();
+}
+
+void VirtualList::overscan(size_t rows) {
+    m_overscan = rows;
+    this->invalidateLayout();
+    this->update();
+}
+
+void VirtualList::refresh(size_t index) {
+    if (index < m_first || index >= m_first + m_rows.size()) return;
+    auto& row = m_rows[index - m_first];
+    row.m_widget = this->build(index, row.m_widget);
+    this->invalidateLayout();
+    this->update();
+}
+
+void VirtualList::refresh() {
+    for (auto& row : m_rows) {
+        row.m_widget = this->build(row.m_index, row.m_widget);
+    }
+    this->invalidateLayout();
+    this->update();
+}
+
+int VirtualList::scroll() const {
+    return m_scroll;
+}
+
+void VirtualList::scrollTo(int offset) {
+    offset = std::clamp(offset, 0, this->maxScroll());
+    if (offset == m_scroll) return;
+    m_scroll = offset;
+    this->invalidateLayout();
+    this->update();
+}
+
+void VirtualList::scrollToRow(size_t row) {
+    this->scrollTo(static_cast<int>(m_heights.sum(std::min(row, m_heights.size()))));
+}
+
+int VirtualList::contentHeight() const {
+    return static_cast<int>(m_heights.total());
+}
+
+VirtualList::Stats const& VirtualList::stats() const {
+    return m_stats;
+}
+
+bool VirtualList::wantsMouse() const {
+    return true;
+}
+
+bool VirtualList::mouseWheel(int delta) {
+    auto old = m_scroll;
+    this->scrollTo(m_scroll - delta * s_wheelStep / WHEEL_DELTA);
+    // at either end the wheel is left for whatever's around the list
+    return m_scroll != old;
+}
+
+void VirtualList::remove(Widget* child, bool release) {
+    for (auto& row : m_rows) {
+        if (row.m_widget == child) {
+            row.m_widget = nullptr;
+        }
+    }
+    m_pool.erase(std::remove(m_pool.begin(), m_pool.end(), child), m_pool.end());
+    Widget::remove(child, release);
+}
+
+void VirtualList::clear() {
+    m_rows.clear();
+    m_pool.clear();
+    m_first = 0;
+    Widget::clear();
+}
+
+void VirtualList::collectText(std::vector<TextQuery>& queries, SIZE available) {
+    // only the rows already in view, the ones scrolled in while
+    // measuring are built and measured on the spot
+    if (!m_autoresize) {
+        available = { this->width(), this->height() };
+    }
+    for (auto& row : m_rows) {
+        if (!row.m_widget) continue;
+        Widget::collectChildText(row.m_widget, queries, available);
+    }
+}
+
+void VirtualList::updateSize(HDC hdc, SIZE available) {
+    if (m_autoresize) {
+        this->storeSize(available.cx, available.cy);
+    }
+    // rows shown for the first time can turn out to be taller or shorter
+    // than estimated, which changes what's in view. Whatever row is at
+    // the top stays put while that settles, so the list doesn't jump
+    auto anchor = m_heights.find(m_scroll);
+    auto anchorOffset = anchor < m_heights.size() ? m_scroll - m_heights.sum(anchor) : 0;
+    for (int pass = 0; pass < 2; pass++) {
+        this->updateRows();
+        auto changed = false;
+        for (auto& row : m_rows) {
+            if (!row.m_widget) continue;
+            row.m_widget->measure(hdc, { this->width(), this->height() });
+            Widget::assignSize(row.m_widget, this->width(), row.m_widget->height());
+            if (row.m_widget->height() != m_heights.get(row.m_index)) {
+                m_heights.set(row.m_index, row.m_widget->height());
+                changed = true;
+            }
+        }
+        if (!changed) break;
+        if (anchor < m_heights.size()) {
+            m_scroll = static_cast<int>(m_heights.sum(anchor) + anchorOffset);
+        }
+        m_scroll = std::clamp(m_scroll, 0, this->maxScroll());
+    }
+}
+
+void VirtualList::updateLayout() {
+    if (m_rows.empty()) return;
+    auto pos = static_cast<int>(m_heights.sum(m_first)) - m_scroll;
+    for (auto& row : m_rows) {
+        if (row.m_widget) {
+            row.m_widget->move(0, pos);
+        }
+        pos += m_heights.get(row.m_index);
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Widget.hpp>
+#include <PrefixSum.hpp>
+
+// A scrolling list that only has widgets for the rows in view, plus a
+// few on either side. Rows scrolled out of view are hidden and handed
+// back to the factory to be filled in for whichever row comes into
+// view next. Rows can be of any height: until a row has been shown
+// it's assumed to be the estimated height, and the heights are kept
+// in a prefix sum so finding the rows at a scroll offset is O(log n)
+class VirtualList : public Widget {
+public:
+    // Returns the widget for a row. recycled is a widget that was used
+    // for another row, or null if there's none to spare. Returning it
+    // after filling it in reuses it; returning a new one releases it
+    using RowFactory = std::function<Widget*(size_t row, Widget* recycled)>;
+
+    struct Stats {
+        // calls to the factory, and how many of those made a new widget
+        size_t m_built = 0;
+        size_t m_created = 0;
+        size_t m_recycled = 0;
+    };
+
+    static int s_wheelStep;
+
+protected:
+    struct Row {
+        size_t m_index;
+        Widget* m_widget;
+    };
+
+    RowFactory m_factory;
+    PrefixSum m_heights;
+    int m_estimate;
+    int m_scroll = 0;
+    size_t m_overscan = 4;
+    // the rows in view, in order starting from m_first
+    std::vector<Row> m_rows;
+    std::vector<Row> m_nextRows;
+    size_t m_first = 0;
+    // hidden widgets waiting to be given another row
+    std::vector<Widget*> m_pool;
+    Stats m_stats;
+
+    Widget* build(size_t index, Widget* recycled);
+    void recycle(Widget* widget);
+    void updateRows();
+    int maxScroll() const;
+    void collectText(std::vector<TextQuery>& queries, SIZE available) override;
+
+public:
+    VirtualList(size_t count, RowFactory factory, int estimatedRowHeight = 32_px);
+
+    // rows keep their measured heights only while the count stays the same
+    void count(size_t count);
+    size_t count() const;
+    void overscan(size_t rows);
+    // builds the row again if it's in view
+    void refresh(size_t row);
+    void refresh();
+
+    int scroll() const;
+    void scrollTo(int offset);
+    void scrollToRow(size_t row);
+    int contentHeight() const;
+
+    Stats const& stats() const;
+
+    bool wantsMouse() const override;
+    bool mouseWheel(int delta) override;
+
+    void remove(Widget* child, bool release = true) override;
+    void clear() override;
+    void updateSize(HDC, SIZE) override;
+    void updateLayout() override;
+};
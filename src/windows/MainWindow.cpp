@@ -10,9 +10,13 @@
 #include "CreateContextWindow.hpp"
 
 MainWindow::~MainWindow() {
+    // the page arena is a member, so it goes before ~Window
+    // would get round to deleting the page with the rest
+    this->releasePage();
 }
 
 MainWindow::MainWindow() : Window("Geode App v" GEODEAPP_VERSION, 600_px, 500_px) {
+    ArenaScope scope(m_arena);
     auto layout = new VerticalLayout();
 
     auto bottomPad = new PadWidget(Tab::s_pad, new HorizontalLayout());
@@ -32,37 +36,91 @@ MainWindow::MainWindow() : Window("Geode App v" GEODEAPP_VERSION, 600_px, 500_px
     layout->add(new Separator(false, 0_px, 1_px));
     layout->add(new Pad(true));
 
-    auto contentLayout = new VerticalLayout();
-    contentLayout->pad(Tab::s_pad);
-    auto contentPad = new PadWidget(Tab::s_pad, contentLayout);
+    m_page = new PadWidget(Tab::s_pad);
+    layout->add(m_page);
 
-    auto checkbox = new Checkbox(
-        "Gay checkbox (homosexual)",
-        Manager::get()->theme() == Theme::Default::Light
-    );
-    checkbox->callback([](auto b) -> void {
-        Manager::get()->setTheme(b->checked() ? Theme::Default::Light : Theme::Default::Dark);
+    layout->add(new Separator(false, 0_px, 1_px));
+
+    m_tabs = new Tabs(new HorizontalLayout());
+    m_tabs->onSelect([this](size_t id) -> void {
+        this->onTab(id);
     });
-    contentPad->add(checkbox);
+    layout->add(m_tabs);
+
+    layout->invert();
+    this->add(layout);
 
-    auto input = new Input();
-    input->placeHolder("Cock and balls...");
-    contentPad->add(input);
+    this->createTabs();
+}
+
+void MainWindow::createTabs() {
+    this->addPage("home"_id, "Home", [](VerticalLayout* page) -> void {
+        auto checkbox = new Checkbox(
+            "Gay checkbox (homosexual)",
+            Manager::get()->theme() == Theme::Default::Light
+        );
+        checkbox->callback([](auto b) -> void {
+            Manager::get()->setTheme(b->checked() ? Theme::Default::Light : Theme::Default::Dark);
+        });
+        page->add(checkbox);
 
-    auto bigInput = new Input();
-    bigInput->drawSize(30, 5);
-    bigInput->limit(15);
-    bigInput->placeHolder("BIGGA INPUDA");
-    contentPad->add(bigInput);
+        auto input = new Input();
+        input->placeHolder("Cock and balls...");
+        page->add(input);
 
-    auto testButton = new Button("Open Test Window");
-    testButton->callback([](auto b) -> void {
-        new TestWindow();
+        auto bigInput = new Input();
+        bigInput->drawSize(30, 5);
+        bigInput->limit(15);
+        bigInput->placeHolder("BIGGA INPUDA");
+        page->add(bigInput);
     });
-    contentPad->add(testButton);
 
-    layout->add(contentPad);
+    this->addPage("tools"_id, "Tools", [](VerticalLayout* page) -> void {
+        auto testButton = new Button("Open Test Window");
+        testButton->callback([](auto b) -> void {
+            new TestWindow();
+        });
+        page->add(testButton);
+    });
+}
 
-    layout->invert();
-    this->add(layout);
+void MainWindow::addPage(size_t id, std::string const& title, PageFunc build) {
+    m_pages[id] = std::move(build);
+    // the first tab selects itself, which builds its page
+    m_tabs->add(new Tab(id, title));
+}
+
+void MainWindow::onTab(size_t id) {
+    if (id == m_pageID || !m_pages.count(id)) return;
+    this->releasePage();
+    // kept between pages, so with the last page's widgets gone
+    // the next one is built into the same memory
+    if (!m_pageArena) {
+        m_pageArena = std::make_unique<Arena>();
+    }
+    VerticalLayout* page;
+    {
+        ArenaScope scope(*m_pageArena);
+        page = new VerticalLayout();
+        page->pad(Tab::s_pad);
+        m_pages.at(id)(page);
+    }
+    m_pageID = id;
+    m_page->widget(page);
+}
+
+void MainWindow::releasePage() {
+    if (!m_pageArena) return;
+    m_page->widget(nullptr);
+    // and whatever the page made that didn't end up in it
+    Window::releaseArena(*m_pageArena);
+    m_pageID = 0;
+}
+
+size_t MainWindow::page() const {
+    return m_pageID;
+}
+
+Arena const* MainWindow::pageArena() const {
+    return m_pageArena.get();
 }
@@ -2,20 +2,32 @@
 
 #include "Window.hpp"
 #include <Layout.hpp>
+#include <Tab.hpp>
 
 class MainWindow : public Window {
+public:
+    using PageFunc = std::function<void(VerticalLayout*)>;
+
 protected:
-    std::unordered_map<size_t, VerticalLayout*> m_pages;
+    std::unordered_map<size_t, PageFunc> m_pages;
+    Tabs* m_tabs;
     PadWidget* m_page;
+    // the page on show is built in an arena of its own when its tab
+    // is selected, and torn down with it when another one is
+    size_t m_pageID = 0;
+    std::unique_ptr<Arena> m_pageArena;
 
     void onTab(size_t id);
+    void releasePage();
     void createTabs();
-    template<size_t ID>
-    void createTab(VerticalLayout*);
-    template<size_t ID>
-    void createTab();
 
 public:
     MainWindow();
     virtual ~MainWindow();
+
+    // adds a tab whose page build fills in whenever it's selected
+    void addPage(size_t id, std::string const& title, PageFunc build);
+    size_t page() const;
+    // the arena the page on show was built in, if there is one
+    Arena const* pageArena() const;
 };
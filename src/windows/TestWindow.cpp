@@ -4,6 +4,7 @@
 #include <RectWidget.hpp>
 
 TestWindow::TestWindow() : Window("Test Window") {
+    ArenaScope scope(m_arena);
     auto label = new Label("Hello World longer text and stuff yeahh");
     label->move(40_px, 40_px);
     label->font("Comic Sans MS");
@@ -29,6 +30,7 @@ TestWindow::TestWindow() : Window("Test Window") {
     rect->add(label2);
 
     rect->move(150, 160);
+    rect->cacheLayer();
     
     auto btn = new Button("Acquire Estrogen");
     btn->move(80_px, 100_px);
@@ -7,6 +7,8 @@
 
 static std::unordered_map<HWND, Window*> g_windows;
 
+static constexpr UINT WM_FRAME = WM_APP + 1;
+
 typedef enum _WINDOWCOMPOSITIONATTRIB
 {
 	WCA_UNDEFINED = 0,
@@ -73,6 +75,10 @@ typedef BOOL (WINAPI *pfnGetWindowCompositionAttribute)(HWND, WINDOWCOMPOSITIONA
 typedef BOOL (WINAPI *pfnSetWindowCompositionAttribute)(HWND, WINDOWCOMPOSITIONATTRIBDATA*);
 
 Window::Window(std::string const& title, bool hasParent, int width, int height) {
+    // from here on the window's geometry is in its own store
+    m_root = true;
+    m_geometry.take(Widget::detached(), m_slot);
+
     WNDCLASSEXA wcex;
 
     m_classID = Manager::get()->acquireWindowClassID();
@@ -119,11 +125,31 @@ Window::Window(std::string const& title, bool hasParent, int width, int height)
 
     m_hwnd = hwnd;
     m_typeName = "Window";
-    m_width = width;
-    m_height = height;
+    this->storeSize(width, height);
 
     g_windows[hwnd] = this;
 
+    m_scheduler.input([this]() -> void {
+        this->flushPointer();
+    });
+    m_scheduler.layout([this]() -> void {
+        auto hdc = GetDC(m_hwnd);
+        this->runLayout(hdc);
+        ReleaseDC(m_hwnd, hdc);
+    });
+    m_scheduler.paint([this](Rect const& damage) -> void {
+        auto rc = toRECT(damage);
+        InvalidateRect(m_hwnd, &rc, false);
+        UpdateWindow(m_hwnd);
+    });
+    m_scheduler.wake([this](unsigned int delay) -> void {
+        if (delay) {
+            SetTimer(m_hwnd, s_frameTimerID, delay, nullptr);
+        } else {
+            PostMessage(m_hwnd, WM_FRAME, 0, 0);
+        }
+    });
+
     this->show();
     this->center();
 }
@@ -132,6 +158,26 @@ Window::Window(std::string const& title, int width, int height) :
     Window(title, false, width, height) {}
 
 Window::~Window() {
+    // children have to go while the hit index they unregister
+    // themselves from is still around
+    for (auto& child : m_children) {
+        delete child;
+    }
+    m_children.clear();
+    Window::releaseArena(m_arena);
+    // widgets taken out of the tree and kept would be left with a
+    // store that's gone, they end up not in a window instead
+    if (m_geometry.live() > 1) {
+        std::vector<Widget*> kept;
+        Widget::handles().forEach([&](Widget* widget) -> void {
+            if (widget->m_window == this && !widget->m_root) {
+                kept.push_back(widget);
+            }
+        });
+        for (auto& widget : kept) {
+            widget->setWindow(nullptr);
+        }
+    }
     g_windows.erase(m_hwnd);
     DestroyWindow(m_hwnd);
     auto className = "GeodeAppWindow" + std::to_string(m_classID);
@@ -151,24 +197,24 @@ void Window::move(int x, int y) {
 }
 
 UINT Window::timer(int time, std::function<void()> proc, bool repeat) {
-    auto id = 1u;
-    while (m_timerIDs.count(id)) id++;
-    m_timerIDs.insert({ id, { proc, time, repeat } });
-    SetTimer(m_hwnd, id, time, nullptr);
-    return id;
+    auto id = m_timers.insert({ proc, time, repeat });
+    if (!id) {
+        throw std::runtime_error("Out of timer IDs");
+    }
+    SetTimer(m_hwnd, id.value(), time, nullptr);
+    return id.value();
 }
 
 void Window::releaseTimer(UINT id) {
-    if (m_timerIDs.count(id)) {
+    if (m_timers.erase(SlotHandle(id))) {
         KillTimer(m_hwnd, id);
-        m_timerIDs.erase(id);
     }
 }
 
 void Window::resetTimer(UINT id) {
-    if (m_timerIDs.count(id)) {
+    if (auto timer = m_timers.get(SlotHandle(id))) {
         KillTimer(m_hwnd, id);
-        SetTimer(m_hwnd, id, m_timerIDs.at(id).m_time, nullptr);
+        SetTimer(m_hwnd, id, timer->m_time, nullptr);
     }
 }
 
@@ -177,7 +223,13 @@ HWND Window::getHWND() const {
 }
 
 void Window::updateWindow(RECT rc) {
-    InvalidateRect(m_hwnd, &rc, false);
+    // damage that lands inside the area currently being
+    // painted will be picked up by this frame anyway
+    if (m_painting) {
+        auto r = toRect(rc);
+        if (m_paintRect.Contains(r)) return;
+    }
+    m_scheduler.invalidate(toRect(rc));
 }
 
 void Window::updateWindow() {
@@ -186,6 +238,10 @@ void Window::updateWindow() {
     this->updateWindow(rc);
 }
 
+void Window::update() {
+    this->updateWindow();
+}
+
 void Window::updateAll() {
     for (auto [_, wnd] : g_windows) {
         wnd->updateWindow();
@@ -201,8 +257,8 @@ void Window::add(Widget* child) {
 void Window::center() {
     if (m_window) {
         this->move(
-            m_window->x() + (m_window->width() - m_width) / 2,
-            m_window->y() + (m_window->height() - m_height) / 2
+            m_window->x() + (m_window->width() - this->width()) / 2,
+            m_window->y() + (m_window->height() - this->height()) / 2
         );
     } else {
         RECT rc;
@@ -218,13 +274,550 @@ bool Window::isFullscreen() const {
     return m_fullscreen;
 }
 
-void Window::paint(HDC hdc, PAINTSTRUCT* ps) {
-    Graphics g(hdc);
-    g.FillRectangle(
-        &SolidBrush(Style::BG()),
-        0, 0, m_width, m_height
+Window::FrameStats const& Window::frameStats() const {
+    return m_frameStats;
+}
+
+float Window::FrameStats::replayRatio() const {
+    auto total = m_recorded + m_replayed;
+    return total ? static_cast<float>(m_replayed) / total : 0.f;
+}
+
+void* Window::operator new(size_t size) {
+    return ::operator new(size);
+}
+
+void Window::operator delete(void* ptr, size_t size) {
+    ::operator delete(ptr);
+}
+
+Arena& Window::arena() {
+    return m_arena;
+}
+
+PointerQueue::Stats const& Window::pointerStats() const {
+    return m_pointer.stats();
+}
+
+PaintPool& Window::paintPool() {
+    return m_paintPool;
+}
+
+LayerCache& Window::layerCache() {
+    return m_layerCache;
+}
+
+FrameScheduler& Window::scheduler() {
+    return m_scheduler;
+}
+
+void Window::refreshHitIndex() {
+    for (auto& w : m_hitDirty) {
+        // the bits invalidateHit keeps up to date, rather than
+        // going through every widget's virtual wantsMouse()
+        auto hittable =
+            w->m_window == this &&
+            m_geometry.flag(w->m_slot, GeometryStore::WantsMouse);
+        auto p = w;
+        for (; hittable && p && !p->m_root; p = p->m_parent) {
+            hittable = m_geometry.flag(p->m_slot, GeometryStore::Visible);
+        }
+        if (hittable && p == this) {
+            m_hitIndex.insert(w, w->rect());
+        } else {
+            m_hitIndex.remove(w);
+        }
+    }
+    m_hitDirty.clear();
+}
+
+void Window::forgetWidget(Widget* widget) {
+    // whatever it was painted into offscreen goes with it, rather than
+    // sitting in the budget until it's the oldest
+    m_layerCache.drop(widget->m_handle.value());
+    m_hitIndex.remove(widget);
+    m_hitDirty.erase(widget);
+    m_hits.erase(std::remove(m_hits.begin(), m_hits.end(), widget), m_hits.end());
+    m_hoverSet.erase(
+        std::remove(m_hoverSet.begin(), m_hoverSet.end(), widget),
+        m_hoverSet.end()
+    );
+    this->focusChainRemove(widget);
+    this->unindexWidget(widget);
+}
+
+void Window::releaseArena(Arena& arena) {
+    if (!arena.stats().m_liveObjects) return;
+    // windows aren't allocated with a header to look at
+    std::vector<SlotHandle> owned;
+    Widget::handles().forEach([&](Widget* widget) -> void {
+        if (!widget->m_root && Arena::ownerOf(widget) == &arena) {
+            owned.push_back(widget->m_handle);
+        }
+    });
+    for (auto& handle : owned) {
+        // gone already if it was under one deleted before it
+        auto widget = Widget::fromHandle(handle);
+        if (!widget) continue;
+        if (widget->m_parent) {
+            widget->m_parent->remove(widget, true);
+        } else {
+            delete widget;
+        }
+    }
+}
+
+bool Window::attached(Widget* widget) const {
+    auto w = widget;
+    while (w->m_parent && w != this) {
+        w = w->m_parent;
+    }
+    return w == this && widget->m_window == this;
+}
+
+void Window::indexSubtree(Widget* subtree, bool children) {
+    if (!this->attached(subtree)) return;
+    this->addToIndex(subtree, children);
+}
+
+void Window::addToIndex(Widget* widget, bool children) {
+    auto handle = widget->handle();
+    if (widget->m_nameID) {
+        m_byName[widget->m_nameID].insert(handle);
+    }
+    if (widget->m_id) {
+        m_byID[widget->m_id].insert(handle);
+    }
+    widget->m_typeID = InternTable::get()->intern(widget->type());
+    m_byType[widget->m_typeID].insert(handle);
+    if (children) {
+        for (auto& child : widget->m_children) {
+            this->addToIndex(child, true);
+        }
+    }
+}
+
+void Window::unindexSubtree(Widget* subtree) {
+    this->unindexWidget(subtree);
+    for (auto& child : subtree->m_children) {
+        this->unindexSubtree(child);
+    }
+}
+
+void Window::unindexWidget(Widget* widget) {
+    auto handle = widget->handle();
+    auto name = m_byName.find(widget->m_nameID);
+    if (name != m_byName.end()) {
+        name->second.erase(handle);
+        if (name->second.empty()) m_byName.erase(name);
+    }
+    auto id = m_byID.find(widget->m_id);
+    if (id != m_byID.end()) {
+        id->second.erase(handle);
+        if (id->second.empty()) m_byID.erase(id);
+    }
+    auto type = m_byType.find(widget->m_typeID);
+    if (type != m_byType.end()) {
+        type->second.erase(handle);
+        if (type->second.empty()) m_byType.erase(type);
+    }
+}
+
+Widget* Window::findByName(std::string const& name) const {
+    auto found = m_byName.find(InternTable::get()->find(name));
+    if (found == m_byName.end()) return nullptr;
+    return Widget::fromHandle(*found->second.begin());
+}
+
+Widget* Window::findByID(int id) const {
+    auto found = m_byID.find(id);
+    if (found == m_byID.end()) return nullptr;
+    return Widget::fromHandle(*found->second.begin());
+}
+
+std::vector<Widget*> Window::findAllByName(std::string const& name) const {
+    std::vector<Widget*> res;
+    auto found = m_byName.find(InternTable::get()->find(name));
+    if (found == m_byName.end()) return res;
+    for (auto& handle : found->second) {
+        res.push_back(Widget::fromHandle(handle));
+    }
+    return res;
+}
+
+std::vector<Widget*> Window::findAllByID(int id) const {
+    std::vector<Widget*> res;
+    auto found = m_byID.find(id);
+    if (found == m_byID.end()) return res;
+    for (auto& handle : found->second) {
+        res.push_back(Widget::fromHandle(handle));
+    }
+    return res;
+}
+
+std::vector<Widget*> Window::findByType(std::string const& type) const {
+    std::vector<Widget*> res;
+    auto found = m_byType.find(InternTable::get()->find(type));
+    if (found == m_byType.end()) return res;
+    for (auto& handle : found->second) {
+        res.push_back(Widget::fromHandle(handle));
+    }
+    return res;
+}
+
+Widget* Window::lastInFocusChain(Widget* subtree) {
+    auto& children = subtree->m_children;
+    for (auto it = children.rbegin(); it != children.rend(); it++) {
+        if (auto last = Window::lastInFocusChain(*it)) {
+            return last;
+        }
+    }
+    return subtree->m_inFocusChain ? subtree : nullptr;
+}
+
+Widget* Window::focusChainBefore(Widget* widget) const {
+    // widgets are mostly added last, so siblings are searched from the end
+    for (auto w = widget; w->m_parent && w != this; w = w->m_parent) {
+        auto& siblings = w->m_parent->m_children;
+        auto it = std::find(siblings.rbegin(), siblings.rend(), w);
+        for (it++; it != siblings.rend(); it++) {
+            if (auto last = Window::lastInFocusChain(*it)) {
+                return last;
+            }
+        }
+        if (w->m_parent->m_inFocusChain) {
+            return w->m_parent;
+        }
+    }
+    return nullptr;
+}
+
+void Window::focusChainInsert(Widget* subtree) {
+    auto attached = subtree->m_window == this;
+    auto w = subtree;
+    for (; attached && w->m_parent && w != this; w = w->m_parent) {
+        attached = w->visible();
+    }
+    if (!attached || w != this) return;
+
+    auto prev = this->focusChainBefore(subtree);
+    auto next = prev ? prev->m_focusNext : m_focusFirst;
+    auto last = this->focusChainLink(subtree, prev);
+    if (last == prev) return;
+    last->m_focusNext = next;
+    if (next) {
+        next->m_focusPrev = last;
+    } else {
+        m_focusLast = last;
+    }
+}
+
+Widget* Window::focusChainLink(Widget* widget, Widget* prev) {
+    if (!widget->visible()) return prev;
+    if (!widget->m_inFocusChain && widget->wantsMouse()) {
+        widget->m_inFocusChain = true;
+        widget->m_focusPrev = prev;
+        if (prev) {
+            prev->m_focusNext = widget;
+        } else {
+            m_focusFirst = widget;
+        }
+        prev = widget;
+        m_focusCount++;
+    }
+    for (auto& child : widget->m_children) {
+        prev = this->focusChainLink(child, prev);
+    }
+    return prev;
+}
+
+void Window::focusChainRemove(Widget* subtree) {
+    if (subtree->m_inFocusChain) {
+        auto prev = subtree->m_focusPrev;
+        auto next = subtree->m_focusNext;
+        (prev ? prev->m_focusNext : m_focusFirst) = next;
+        (next ? next->m_focusPrev : m_focusLast) = prev;
+        subtree->m_focusPrev = nullptr;
+        subtree->m_focusNext = nullptr;
+        subtree->m_inFocusChain = false;
+        m_focusCount--;
+        if (m_tabFocused == subtree) {
+            subtree->m_tabbed = false;
+            m_tabFocused = nullptr;
+        }
+    }
+    for (auto& child : subtree->m_children) {
+        this->focusChainRemove(child);
+    }
+}
+
+void Window::focusNext(bool backwards) {
+    auto next = m_tabFocused ?
+        (backwards ? m_tabFocused->m_focusPrev : m_tabFocused->m_focusNext) :
+        nullptr;
+    if (!next) {
+        next = backwards ? m_focusLast : m_focusFirst;
+    }
+    if (next == m_tabFocused) return;
+    if (m_tabFocused) {
+        m_tabFocused->tabLeave();
+    }
+    m_tabFocused = next;
+    if (m_tabFocused) {
+        m_tabFocused->tabEnter();
+    }
+}
+
+Widget* Window::tabFocused() const {
+    return m_tabFocused;
+}
+
+size_t Window::focusChainSize() const {
+    return m_focusCount;
+}
+
+// whether widget is outside of an ancestor that clips it at p
+static bool clippedAt(Widget* widget, Point const& p) {
+    for (auto w = widget->getParent(); w; w = w->getParent()) {
+        if (w->clipsChildren() && !w->rect().Contains(p)) return true;
+    }
+    return false;
+}
+
+std::vector<Widget*> const& Window::hitTest(Point const& p) {
+    this->refreshHitIndex();
+    m_hits.clear();
+    m_hitIndex.query(p, m_hits);
+    m_hits.erase(
+        std::remove_if(m_hits.begin(), m_hits.end(), [&p](Widget* widget) {
+            return clippedAt(widget, p);
+        }),
+        m_hits.end()
     );
-    Widget::paint(hdc, ps);
+    std::sort(m_hits.begin(), m_hits.end(), &Widget::paintsBefore);
+    return m_hits;
+}
+
+void Window::cancelPress(Widget* subtree) {
+    auto inside = [subtree](Widget* widget) -> bool {
+        for (auto w = widget->m_parent; w; w = w->m_parent) {
+            if (w == subtree) return true;
+        }
+        return false;
+    };
+    for (auto& w : m_hoverSet) {
+        if (w->m_mousedown && inside(w)) {
+            w->m_mousedown = false;
+            w->update();
+        }
+    }
+    auto capturing = this->capturingWidget();
+    if (capturing && inside(capturing)) {
+        m_capturingWidget = SlotHandle();
+    }
+}
+
+static bool handlesMouseAt(Widget* widget, Point const& p) {
+    return widget->wantsMouse() && widget->rect().Contains(p);
+}
+
+Widget* Window::hover(Point const& p, bool down) {
+    auto& hits = this->hitTest(p);
+    auto target = hits.empty() ? nullptr : hits.back();
+    // what's hovered is the target and the ancestors of it under the pointer
+    m_nextHoverSet.clear();
+    for (auto w = target; w && w != this; w = w->m_parent) {
+        if (handlesMouseAt(w, p)) {
+            m_nextHoverSet.push_back(w);
+        }
+    }
+    for (auto& w : m_hoverSet) {
+        auto still = std::find(m_nextHoverSet.begin(), m_nextHoverSet.end(), w);
+        if (still == m_nextHoverSet.end() && w->m_hovered) {
+            w->m_hovered = false;
+            w->m_mousedown = false;
+            w->leave();
+        }
+    }
+    m_hoverSet.swap(m_nextHoverSet);
+    for (auto& w : m_hoverSet) {
+        if (!w->m_hovered) {
+            w->m_hovered = true;
+            w->m_mousedown = down;
+            w->enter();
+        }
+    }
+    if (target) {
+        Event event(Event::Type::MouseMove);
+        event.m_target = target;
+        event.m_point = p;
+        event.m_down = down;
+        this->dispatch(event);
+    }
+    return target;
+}
+
+bool Window::dispatch(Event& event) {
+    if (m_eventPaths.size() <= m_dispatchDepth) {
+        m_eventPaths.emplace_back();
+    }
+    auto& path = m_eventPaths[m_dispatchDepth];
+    path.clear();
+    for (auto w = event.m_target; w; w = w->m_parent) {
+        path.push_back(w);
+        if (w == this) break;
+    }
+    if (path.empty() || path.back() != this) return false;
+    m_eventStats.m_dispatched++;
+    m_eventStats.m_visited += path.size();
+    // handlers are free to dispatch events of their own
+    m_dispatchDepth++;
+    auto delivered = this->dispatchAlong(path, event);
+    m_dispatchDepth--;
+    return delivered;
+}
+
+bool Window::dispatchAlong(std::vector<Widget*> const& path, Event& event) {
+    event.m_phase = Event::Phase::Capture;
+    for (size_t i = path.size() - 1; i > 0; i--) {
+        path[i]->runListeners(event, true);
+        if (event.m_stopped) {
+            m_eventStats.m_stopped++;
+            return false;
+        }
+    }
+
+    event.m_phase = Event::Phase::Target;
+    auto target = path.front();
+    target->runListeners(event, true);
+    target->runListeners(event, false);
+    target->handleEvent(event);
+
+    event.m_phase = Event::Phase::Bubble;
+    auto bubbleDefault = event.isMouse() && !event.m_captured;
+    // the wheel goes up until something scrolls with it, clicks and
+    // moves only to the containers that asked for their children's
+    auto wheel = event.m_type == Event::Type::MouseWheel;
+    for (size_t i = 1; i < path.size() && !event.m_stopped; i++) {
+        auto w = path[i];
+        w->runListeners(event, false);
+        if (
+            bubbleDefault && w != this &&
+            (wheel || w->handlesChildMouse()) &&
+            handlesMouseAt(w, event.m_point)
+        ) {
+            w->handleEvent(event);
+        }
+    }
+    if (event.m_stopped) {
+        m_eventStats.m_stopped++;
+        return false;
+    }
+    return true;
+}
+
+Window::EventStats const& Window::eventStats() const {
+    return m_eventStats;
+}
+
+Widget* Window::hoveredWidget() const {
+    return Widget::fromHandle(m_hoveredWidget);
+}
+
+Widget* Window::capturingWidget() const {
+    return Widget::fromHandle(m_capturingWidget);
+}
+
+Widget* Window::keyboardWidget() const {
+    return Widget::fromHandle(m_keyboardWidget);
+}
+
+void Window::queuePointer(Point const& p, bool down) {
+    if (m_pointer.move(p, down)) {
+        m_scheduler.requestInput();
+    }
+}
+
+void Window::flushPointer() {
+    // something may have moved under the pointer
+    if (!m_hitDirty.empty()) {
+        m_pointer.invalidate();
+    }
+    Point p;
+    bool down;
+    if (!m_pointer.take(p, down)) return;
+    if (auto capturing = this->capturingWidget()) {
+        m_hoveredWidget = m_capturingWidget;
+        Event event(Event::Type::MouseMove);
+        event.m_target = capturing;
+        event.m_point = p;
+        event.m_down = down;
+        event.m_captured = true;
+        this->dispatch(event);
+    } else {
+        auto hovered = this->hover(p, down);
+        m_hoveredWidget = hovered ? hovered->handle() : SlotHandle();
+    }
+}
+
+void Window::dispatchClick(Point const& p, bool down, int clickCount) {
+    Event event(
+        clickCount > 1 ? Event::Type::MouseDoubleClick :
+        down ? Event::Type::MouseDown : Event::Type::MouseUp
+    );
+    event.m_point = p;
+    event.m_down = down;
+    if (auto capturing = this->capturingWidget()) {
+        event.m_target = capturing;
+        event.m_captured = true;
+    } else {
+        auto& hits = this->hitTest(p);
+        if (hits.empty()) return;
+        event.m_target = hits.back();
+    }
+    this->dispatch(event);
+}
+
+void Window::runLayout(HDC hdc) {
+    m_layingOut = true;
+    this->measure(hdc, { this->width(), this->height() });
+    this->arrange();
+    m_layingOut = false;
+}
+
+void Window::renderFrame(HDC hdc, Canvas& canvas) {
+    m_painting = true;
+    m_paintRect = canvas.dirty();
+    m_frameStats = FrameStats();
+    m_occluders.clear();
+    m_paintPool.beginFrame();
+    m_scheduler.painted(m_paintRect);
+    this->runLayout(hdc);
+    m_scheduler.laidOut();
+    #ifndef NDEBUG
+    this->validateOffsets();
+    #endif
+    this->updateBounds();
+    this->paint(canvas);
+    m_frameStats.m_culled += canvas.culledLists();
+    m_frameStats.m_paintObjectsCreated = m_paintPool.stats().m_created;
+    m_painting = false;
+}
+
+void Window::paint(Canvas& canvas) {
+    auto dirty = canvas.dirty();
+    auto covered = std::any_of(
+        m_children.begin(), m_children.end(),
+        [&](Widget* child) -> bool {
+            return child->visible() && child->opaque() && child->rect().Contains(dirty);
+        }
+    );
+    if (covered) {
+        m_frameStats.m_occluded++;
+    } else {
+        canvas.fillRect(toRectF(dirty), Style::BG());
+    }
+    Widget::paint(canvas);
 }
 
 const int EXTEND_TOP = 40;
@@ -311,10 +904,12 @@ LRESULT Window::proc(UINT msg, WPARAM wp, LPARAM lp) {
             }
 
             MapWindowPoints(nullptr, m_hwnd, &p, 1);
-            if (Widget::s_capturingWidget) return hit;
-            if (this->propagateCaptureMouse(toPoint(p))) return hit;
-            Widget::s_hoveredWidget = this->propagateMouseEvent(toPoint(p), m_mousedown, 0);
-            if (Widget::s_keyboardWidget) return hit;
+            if (this->capturingWidget()) return hit;
+            // over a widget WM_MOUSEMOVE follows and does the hovering,
+            // otherwise this is the only place to see the pointer leave
+            if (!this->hitTest(toPoint(p)).empty()) return hit;
+            this->queuePointer(toPoint(p), m_mousedown);
+            if (this->keyboardWidget()) return hit;
 
             if (hit == HTCLIENT) hit = HTCAPTION;
             
@@ -337,8 +932,11 @@ LRESULT Window::proc(UINT msg, WPARAM wp, LPARAM lp) {
             auto hdc = BeginPaint(m_hwnd, &ps);
             HDC ndc;
             auto hpb = BeginBufferedPaint(hdc, &ps.rcPaint, BPBF_COMPATIBLEBITMAP, nullptr, &ndc);
-            this->updateSize(ndc, { m_width, m_height });
-            this->paint(ndc, &ps);
+            {
+                // the canvas' Graphics has to go before the buffer is ended
+                GdiCanvas canvas(ndc, m_paintPool, &m_layerCache, toRect(ps.rcPaint));
+                this->renderFrame(ndc, canvas);
+            }
             EndBufferedPaint(hpb, true);
             EndPaint(m_hwnd, &ps);
             return 0;
@@ -346,57 +944,57 @@ LRESULT Window::proc(UINT msg, WPARAM wp, LPARAM lp) {
 
         case WM_LBUTTONDOWN: {
             Point p(GET_X_LPARAM(lp), GET_Y_LPARAM(lp));
+            // clicks have to land on what the pointer is known to be over
+            this->flushPointer();
             m_mousedown = true;
-            if (Widget::s_capturingWidget) {
-                Widget::s_capturingWidget->m_mousedown = true;
-                Widget::s_capturingWidget->mouseDown(p.X, p.Y);
-            } else {
-                this->propagateMouseEvent(p, true, 1);
-            }
-            if (!Widget::s_hoveredWidget && Widget::s_keyboardWidget) {
-                Widget::s_keyboardWidget->releaseKeyboard();
-                Widget::s_keyboardWidget = nullptr;
+            this->dispatchClick(p, true, 1);
+            if (!this->hoveredWidget()) {
+                if (auto keyboard = this->keyboardWidget()) {
+                    keyboard->releaseKeyboard();
+                }
             }
         } break;
 
         case WM_LBUTTONUP: {
             Point p(GET_X_LPARAM(lp), GET_Y_LPARAM(lp));
+            this->flushPointer();
             m_mousedown = false;
-            if (Widget::s_capturingWidget) {
-                Widget::s_capturingWidget->m_mousedown = false;
-                Widget::s_capturingWidget->mouseUp(p.X, p.Y);
-            } else {
-                this->propagateMouseEvent(p, false, 1);
-            }
+            this->dispatchClick(p, false, 1);
         } break;
 
         case WM_MOUSEMOVE: {
             Point p(GET_X_LPARAM(lp), GET_Y_LPARAM(lp));
             m_mousedown = wp & MK_LBUTTON;
-            if (Widget::s_capturingWidget) {
-                Widget::s_hoveredWidget = Widget::s_capturingWidget;
-                Widget::s_capturingWidget->m_mousedown = m_mousedown;
-                Widget::s_capturingWidget->mouseMove(p.X, p.Y);
-            } else {
-                Widget::s_hoveredWidget = this->propagateMouseEvent(p, m_mousedown, 0);
+            this->queuePointer(p, m_mousedown);
+        } break;
+
+        case WM_MOUSEWHEEL: {
+            // unlike the other mouse messages this one's in screen coordinates
+            POINT pt = { GET_X_LPARAM(lp), GET_Y_LPARAM(lp) };
+            ScreenToClient(m_hwnd, &pt);
+            Point p(pt.x, pt.y);
+            this->flushPointer();
+            auto& hits = this->hitTest(p);
+            if (hits.size()) {
+                Event event(Event::Type::MouseWheel);
+                event.m_target = hits.back();
+                event.m_point = p;
+                event.m_delta = GET_WHEEL_DELTA_WPARAM(wp);
+                this->dispatch(event);
             }
+            return 0;
         } break;
 
         case WM_LBUTTONDBLCLK: {
             Point p(GET_X_LPARAM(lp), GET_Y_LPARAM(lp));
+            this->flushPointer();
             m_mousedown = true;
-            if (Widget::s_capturingWidget) {
-                Widget::s_capturingWidget->m_mousedown = true;
-                Widget::s_capturingWidget->mouseDown(p.X, p.Y);
-                Widget::s_capturingWidget->mouseDoubleClick(p.X, p.Y);
-            } else {
-                this->propagateMouseEvent(p, true, 2);
-            }
+            this->dispatchClick(p, true, 2);
         } break;
 
         case WM_SETCURSOR: {
-            if (Widget::s_hoveredWidget) {
-                auto cursor = Widget::s_hoveredWidget->cursor();
+            if (auto hovered = this->hoveredWidget()) {
+                auto cursor = hovered->cursor();
                 if (cursor) {
                     SetCursor(cursor);
                     return 0;
@@ -405,46 +1003,41 @@ LRESULT Window::proc(UINT msg, WPARAM wp, LPARAM lp) {
         } break;
 
         case WM_KEYDOWN: {
-            if (Widget::s_keyboardWidget) {
+            if (auto keyboard = this->keyboardWidget()) {
                 if (wp == VK_ESCAPE) {
-                    Widget::s_keyboardWidget = nullptr;
+                    keyboard->releaseKeyboard();
                 } else {
-                    Widget::s_keyboardWidget->keyDown(wp, (lp >> 16) & 0x00ff);
+                    Event event(Event::Type::KeyDown);
+                    event.m_target = keyboard;
+                    event.m_key = wp;
+                    event.m_scanCode = (lp >> 16) & 0x00ff;
+                    this->dispatch(event);
                     return 0;
                 }
             }
             if (wp == VK_TAB) {
-                // todo: fix this mess
-                int index = 0;
-                if (!this->propagateTabEvent(index, m_tabIndex)) {
-                    m_tabIndex = 0;
-                }
-                if (GetKeyState(VK_SHIFT) & 0x8000) {
-                    if (m_tabIndex > 0) {
-                        m_tabIndex--;
-                    }
-                } else {
-                    m_tabIndex++;
-                }
+                this->focusNext(GetKeyState(VK_SHIFT) & 0x8000);
                 return 0;
             }
         } break;
 
         case WM_KEYUP: {
-            if (Widget::s_keyboardWidget) {
-                Widget::s_keyboardWidget->keyUp(wp, LOBYTE(HIWORD(lp)));
+            if (auto keyboard = this->keyboardWidget()) {
+                Event event(Event::Type::KeyUp);
+                event.m_target = keyboard;
+                event.m_key = wp;
+                event.m_scanCode = LOBYTE(HIWORD(lp));
+                this->dispatch(event);
             }
         } break;
 
         case WM_MOVE: {
-            m_x = LOWORD(lp);
-            m_y = HIWORD(lp);
+            this->storePosition(LOWORD(lp), HIWORD(lp));
         } break;
 
         case WM_SIZE: {
             m_fullscreen = wp == SIZE_MAXIMIZED;
-            m_width = LOWORD(lp);
-            m_height = HIWORD(lp);
+            this->storeSize(LOWORD(lp), HIWORD(lp));
         } break;
 
         case WM_SETFOCUS: {
@@ -455,14 +1048,21 @@ LRESULT Window::proc(UINT msg, WPARAM wp, LPARAM lp) {
             this->propagateFocusEvent(false);
         } break;
 
+        case WM_FRAME: {
+            m_scheduler.tick();
+        } break;
+
         case WM_TIMER: {
             auto id = static_cast<UINT>(wp);
-            if (m_timerIDs.count(id)) {
-                auto timer = m_timerIDs.at(id);
+            if (id == s_frameTimerID) {
+                KillTimer(m_hwnd, id);
+                m_scheduler.tick();
+            } else if (auto found = m_timers.get(SlotHandle(id))) {
+                // copied since the timer may be released while it runs
+                auto timer = *found;
                 timer.m_func();
                 if (!timer.m_repeat) {
-                    KillTimer(m_hwnd, id);
-                    m_timerIDs.erase(id);
+                    this->releaseTimer(id);
                 }
             }
         } break;
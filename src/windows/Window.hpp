@@ -4,8 +4,42 @@
 #include <string>
 #include <unordered_map>
 #include <Widget.hpp>
+#include <PaintPool.hpp>
+#include <GdiCanvas.hpp>
+#include <FrameScheduler.hpp>
+#include <HitGrid.hpp>
+#include <PointerQueue.hpp>
+#include <GeometryStore.hpp>
+#include <unordered_set>
+#include <deque>
 
 class Window : public Widget {
+public:
+    struct EventStats {
+        size_t m_dispatched = 0;
+        // widgets the events went through, listeners or not
+        size_t m_visited = 0;
+        size_t m_stopped = 0;
+    };
+
+    struct FrameStats {
+        size_t m_painted = 0;
+        size_t m_skipped = 0;
+        // outside of a clipping parent, or hidden by an opaque sibling
+        size_t m_culled = 0;
+        size_t m_occluded = 0;
+        size_t m_measured = 0;
+        // texts measured ahead on the thread pool
+        size_t m_prefetched = 0;
+        size_t m_paintObjectsCreated = 0;
+        // widgets that painted from scratch into a new display list
+        // versus ones that replayed the list from an earlier frame
+        size_t m_recorded = 0;
+        size_t m_replayed = 0;
+
+        float replayRatio() const;
+    };
+
 protected:
     struct TimerFunc {
         std::function<void()> m_func;
@@ -17,8 +51,88 @@ protected:
     HWND m_hwnd = nullptr;
     std::string m_title;
     bool m_fullscreen = false;
-    int m_tabIndex = 0;
-    std::unordered_map<UINT, TimerFunc> m_timerIDs;
+    // focusable widgets in tree order, linked through the widgets
+    Widget* m_focusFirst = nullptr;
+    Widget* m_focusLast = nullptr;
+    Widget* m_tabFocused = nullptr;
+    size_t m_focusCount = 0;
+    // timer IDs are handles into this
+    SlotMap<TimerFunc> m_timers;
+    bool m_painting = false;
+    bool m_layingOut = false;
+    Rect m_paintRect;
+    FrameStats m_frameStats;
+    // opaque children of the widgets being painted, used as a stack
+    // by Widget::paint so that frames don't allocate them anew
+    std::vector<std::pair<size_t, Rect>> m_occluders;
+    PaintPool m_paintPool;
+    LayerCache m_layerCache;
+    FrameScheduler m_scheduler;
+    // for the widgets the window builds itself
+    Arena m_arena;
+    // where the geometry of the window and the widgets in it is kept
+    GeometryStore m_geometry;
+    // rects of the widgets that want the mouse, in window coordinates
+    HitGrid<Widget*> m_hitIndex;
+    // widgets whose entry in m_hitIndex may be out of date
+    std::unordered_set<Widget*> m_hitDirty;
+    std::vector<Widget*> m_hits;
+    std::vector<Widget*> m_hoverSet;
+    std::vector<Widget*> m_nextHoverSet;
+    // handles rather than pointers so they can't outlive the widgets
+    SlotHandle m_hoveredWidget;
+    SlotHandle m_capturingWidget;
+    SlotHandle m_keyboardWidget;
+    // target first, window last. One per nested dispatch, in a deque
+    // so that the ones in use stay put when another is added
+    std::deque<std::vector<Widget*>> m_eventPaths;
+    size_t m_dispatchDepth = 0;
+    EventStats m_eventStats;
+    // widgets by interned name, id and interned type
+    std::unordered_map<uint32_t, std::unordered_set<SlotHandle>> m_byName;
+    std::unordered_map<int, std::unordered_set<SlotHandle>> m_byID;
+    std::unordered_map<uint32_t, std::unordered_set<SlotHandle>> m_byType;
+    PointerQueue m_pointer;
+
+    // a handle with all index bits set, which the timer map never gives out
+    static constexpr UINT s_frameTimerID = SlotMap<TimerFunc>::s_indexMask;
+
+    void runLayout(HDC hdc);
+    // lays out and paints the dirty part of canvas, which is what
+    // WM_PAINT does with a canvas over the buffered paint DC
+    void renderFrame(HDC hdc, Canvas& canvas);
+    void refreshHitIndex();
+    // called by widgets as they're deleted
+    void forgetWidget(Widget* widget);
+    // Deletes the widgets still alive in arena, wherever they ended up,
+    // so that it can go without leaking them or freeing them in use
+    static void releaseArena(Arena& arena);
+    // updates hover state for p and returns the topmost widget under it
+    Widget* hover(Point const& p, bool down);
+    void dispatchClick(Point const& p, bool down, int clickCount);
+    bool dispatchAlong(std::vector<Widget*> const& path, Event& event);
+    // queues a move to be dispatched with the next frame
+    void queuePointer(Point const& p, bool down);
+    // dispatches the queued move, if any, right away
+    void flushPointer();
+    // adds the focusable widgets in the subtree to the focus
+    // chain, if the subtree is shown and attached to this window
+    void focusChainInsert(Widget* subtree);
+    // links the focusable widgets of the subtree in right after prev,
+    // in tree order, and returns the last one linked (prev if none were)
+    Widget* focusChainLink(Widget* widget, Widget* prev);
+    void focusChainRemove(Widget* subtree);
+    // the chain member right before widget in tree order
+    Widget* focusChainBefore(Widget* widget) const;
+    static Widget* lastInFocusChain(Widget* subtree);
+    // whether widget is in this window's tree
+    bool attached(Widget* widget) const;
+    void indexSubtree(Widget* subtree, bool children);
+    void addToIndex(Widget* widget, bool children);
+    void unindexSubtree(Widget* subtree);
+    void unindexWidget(Widget* widget);
+
+    friend class Widget;
 
 public:
     Window(std::string const& title, bool hasParent, int width = 600_px, int height = 400_px);
@@ -26,10 +140,16 @@ public:
     Window() = delete;
     virtual ~Window();
 
+    // windows outlive whatever scope they're opened
+    // from, so they never go into an arena
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     void add(Widget* child) override;
     void updateWindow(RECT rc);
     void updateWindow();
-    void paint(HDC, PAINTSTRUCT*) override;
+    void update() override;
+    void paint(Canvas&) override;
     void show(bool v = true) override;
     void move(int x, int y) override;
     UINT timer(int time, std::function<void()> func, bool repeat);
@@ -41,6 +161,44 @@ public:
     void center();
     void setTitle(std::string const&);
     bool isFullscreen() const;
+    FrameStats const& frameStats() const;
+    PaintPool& paintPool();
+    LayerCache& layerCache();
+    FrameScheduler& scheduler();
+    PointerQueue::Stats const& pointerStats() const;
+    Arena& arena();
+
+    // moves the tab focus along the focus chain, wrapping around
+    void focusNext(bool backwards = false);
+    Widget* tabFocused() const;
+    size_t focusChainSize() const;
+
+    // widgets that want the mouse under p, bottom to top
+    std::vector<Widget*> const& hitTest(Point const& p);
+    // Lets go of the widgets inside of subtree that the pointer went
+    // down on, without clicking them. For containers that take over a
+    // press as a drag once it starts moving
+    void cancelPress(Widget* subtree);
+
+    // Sends event down to event.m_target and back up again, which only
+    // touches the target's ancestors. Uncaptured mouse events are also
+    // handled on the way up by the widgets under the pointer that want
+    // the mouse and their children's, or any of them for the wheel.
+    // Returns false if stopped
+    bool dispatch(Event& event);
+    EventStats const& eventStats() const;
+
+    Widget* hoveredWidget() const;
+    Widget* capturingWidget() const;
+    Widget* keyboardWidget() const;
+
+    // Lookups in the window's tree. Names and ids aren't required to be
+    // unique, if more than one widget has it any of them may be returned
+    Widget* findByName(std::string const& name) const;
+    Widget* findByID(int id) const;
+    std::vector<Widget*> findAllByName(std::string const& name) const;
+    std::vector<Widget*> findAllByID(int id) const;
+    std::vector<Widget*> findByType(std::string const& type) const;
 
     HWND getHWND() const;
 
@@ -0,0 +1,90 @@
+#include "Check.hpp"
+#include <Arena.hpp>
+
+struct Node {
+    int m_value[6] = {};
+
+    static void* operator new(size_t size) {
+        return Arena::allocateScoped(size);
+    }
+    static void operator delete(void* ptr, size_t size) {
+        Arena::deallocateScoped(ptr, size);
+    }
+};
+
+static void testFreedMemoryIsReused() {
+    Arena arena;
+    std::vector<Node*> nodes;
+    {
+        ArenaScope scope(arena);
+        for (int i = 0; i < 100; i++) {
+            nodes.push_back(new Node());
+        }
+    }
+    auto reserved = arena.stats().m_bytesReserved;
+    auto used = arena.stats().m_bytesUsed;
+    CHECK_EQ(arena.stats().m_liveObjects, 100u);
+
+    // rebuilding part of the tree goes where the old nodes were
+    for (int i = 0; i < 50; i++) {
+        delete nodes[i];
+    }
+    CHECK(arena.stats().m_bytesUsed < used);
+    {
+        ArenaScope scope(arena);
+        for (int i = 0; i < 50; i++) {
+            nodes[i] = new Node();
+        }
+    }
+    CHECK_EQ(arena.stats().m_reused, 50u);
+    CHECK_EQ(arena.stats().m_bytesUsed, used);
+    CHECK_EQ(arena.stats().m_bytesReserved, reserved);
+
+    // the last one going frees everything but the first block
+    for (auto& node : nodes) {
+        delete node;
+    }
+    CHECK_EQ(arena.stats().m_liveObjects, 0u);
+    CHECK_EQ(arena.stats().m_bytesUsed, 0u);
+    CHECK_EQ(arena.stats().m_blocks, 1u);
+}
+
+static void testOutsideOfAScopeUsesTheHeap() {
+    Arena arena;
+    auto node = new Node();
+    CHECK(Arena::current() == nullptr);
+    CHECK_EQ(arena.stats().m_objects, 0u);
+    CHECK(Arena::ownerOf(node) == nullptr);
+    delete node;
+
+    // and inside of one, each object knows where it came from
+    Node* scoped;
+    {
+        ArenaScope scope(arena);
+        scoped = new Node();
+    }
+    CHECK(Arena::ownerOf(scoped) == &arena);
+    delete scoped;
+}
+
+static void benchmarkChurn() {
+    constexpr int count = 100000;
+    Arena arena;
+    std::vector<Node*> nodes(count);
+    report("build and free 100,000 nodes in an arena", timeMs([&] {
+        ArenaScope scope(arena);
+        for (int round = 0; round < 2; round++) {
+            for (auto& node : nodes) node = new Node();
+            for (auto& node : nodes) delete node;
+        }
+    }));
+    CHECK_EQ(arena.stats().m_objects, static_cast<size_t>(count) * 2);
+    std::printf("%-48s %10zu blocks\n", "arena held", arena.stats().m_blocks);
+}
+
+int main() {
+    testFreedMemoryIsReused();
+    testOutsideOfAScopeUsesTheHeap();
+    benchmarkChurn();
+    return finish();
+}
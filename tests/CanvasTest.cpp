@@ -0,0 +1,197 @@
+#include "Check.hpp"
+#include <RecordingCanvas.hpp>
+
+// Counts what reaches it and keeps track of the translation, but uses
+// the base Canvas for lists so they get replayed and culled like on
+// a real backend
+class CountingCanvas : public Canvas {
+public:
+    size_t m_shapes = 0;
+    size_t m_texts = 0;
+    size_t m_clips = 0;
+    PointF m_translation;
+    std::vector<PointF> m_saved;
+    // top left corner of every shape, with the translation applied
+    std::vector<PointF> m_corners;
+    Rect m_dirty;
+
+    CountingCanvas(Rect const& dirty = RecordingCanvas::everything())
+      : m_dirty(dirty) {}
+
+    void shape(REAL x, REAL y) {
+        m_shapes++;
+        m_corners.push_back(PointF(x + m_translation.X, y + m_translation.Y));
+    }
+
+    void fillRect(RectF const& rect, Fill const&) override {
+        this->shape(rect.X, rect.Y);
+    }
+    void strokeRect(RectF const& rect, Color const&, REAL) override {
+        this->shape(rect.X, rect.Y);
+    }
+    void fillRoundRect(Rect const& rect, int, Fill const&) override {
+        this->shape(static_cast<REAL>(rect.X), static_cast<REAL>(rect.Y));
+    }
+    void strokeRoundRect(Rect const& rect, int, Color const&) override {
+        this->shape(static_cast<REAL>(rect.X), static_cast<REAL>(rect.Y));
+    }
+    void fillEllipse(RectF const& rect, Fill const&) override {
+        this->shape(rect.X, rect.Y);
+    }
+    void strokePath(Path const& path, Color const&, REAL) override {
+        this->shape(path.points().front().X, path.points().front().Y);
+    }
+    void drawText(
+        std::wstring const&, std::wstring const&, int, int,
+        Color const&, RectF const&, TextLayout const&
+    ) override {
+        m_texts++;
+    }
+
+    void save() override {
+        m_saved.push_back(m_translation);
+    }
+    void restore() override {
+        m_translation = m_saved.back();
+        m_saved.pop_back();
+    }
+    void clipRect(Rect const&) override {
+        m_clips++;
+    }
+    void translate(REAL dx, REAL dy) override {
+        m_translation.X += dx;
+        m_translation.Y += dy;
+    }
+    void rotate(REAL) override {}
+
+    Rect dirty() const override {
+        return m_dirty;
+    }
+    void* device() const override {
+        return nullptr;
+    }
+};
+
+// roughly what Button::paint records
+static void paintButton(Canvas& canvas, Rect const& rect) {
+    canvas.fillRoundRect(rect, 4, Fill::linear(
+        Point(0, 0), Point(0, rect.Height),
+        Color(255, 60, 60, 60), Color(255, 40, 40, 40)
+    ));
+    canvas.strokeRoundRect(rect, 4, Color(255, 90, 90, 90));
+    canvas.drawText(
+        L"Launch", L"Segoe UI", 18, 0, Color(255, 255, 255, 255),
+        RectF(
+            static_cast<REAL>(rect.X), static_cast<REAL>(rect.Y),
+            static_cast<REAL>(rect.Width), static_cast<REAL>(rect.Height)
+        ),
+        TextLayout()
+    );
+}
+
+static void testRecordAndReplay() {
+    RecordingCanvas recording;
+    paintButton(recording, Rect(10, 10, 100, 30));
+    recording.save();
+    recording.translate(5.f, 5.f);
+    recording.fillRect(RectF(0.f, 0.f, 10.f, 10.f), Fill(Color(255, 0, 0)));
+    recording.restore();
+    Path path;
+    path.addLine(0.f, 0.f, 10.f, 10.f);
+    path.addLine(10.f, 10.f, 20.f, 0.f);
+    recording.strokePath(path, Color(255, 0, 0));
+
+    CHECK_EQ(recording.count(RecordingCanvas::Op::FillRoundRect), 1u);
+    CHECK_EQ(recording.count(RecordingCanvas::Op::DrawText), 1u);
+    CHECK_EQ(recording.count(), 8u);
+    // both strings are stored once and referred to by index
+    CHECK_EQ(recording.strings().size(), 2u);
+
+    CountingCanvas target;
+    recording.replay(target);
+    CHECK_EQ(target.m_shapes, 4u);
+    CHECK_EQ(target.m_texts, 1u);
+    CHECK(target.m_saved.empty());
+    CHECK_EQ(target.m_corners[2].X, 5.f);
+
+    // replaying into another recording gives back the same ops
+    RecordingCanvas copy;
+    recording.replay(copy);
+    CHECK_EQ(copy.count(), recording.count());
+    CHECK_EQ(copy.size(), recording.size());
+}
+
+static void testListsAreTranslatedAndCulled() {
+    auto button = std::make_shared<RecordingCanvas>();
+    paintButton(*button, Rect(0, 0, 100, 30));
+    Rect bounds(0, 0, 100, 30);
+
+    RecordingCanvas page;
+    for (int i = 0; i < 10; i++) {
+        page.drawList(button, Point(0, i * 40), bounds);
+    }
+    CHECK_EQ(page.count(RecordingCanvas::Op::DrawList), 10u);
+
+    // only the rows at 0, 40 and 80 touch the dirty area
+    CountingCanvas target(Rect(0, 0, 200, 100));
+    page.replay(target);
+    CHECK_EQ(target.m_texts, 3u);
+    CHECK_EQ(target.culledLists(), 7u);
+    CHECK_EQ(target.m_corners.back().Y, 80.f);
+
+    // nested lists are culled with the offsets of everything above them
+    auto column = std::make_shared<RecordingCanvas>();
+    column->drawList(button, Point(0, 0), bounds);
+    column->drawList(button, Point(0, 200), bounds);
+    CountingCanvas nested(Rect(0, 0, 200, 100));
+    nested.drawList(column, Point(0, 50), Rect(0, 0, 100, 230));
+    CHECK_EQ(nested.m_texts, 1u);
+    CHECK_EQ(nested.culledLists(), 1u);
+}
+
+static void testScrolledListsAreClipped() {
+    auto button = std::make_shared<RecordingCanvas>();
+    paintButton(*button, Rect(0, 0, 100, 30));
+    auto content = std::make_shared<RecordingCanvas>();
+    for (int i = 0; i < 100; i++) {
+        content->drawList(button, Point(0, i * 40), Rect(0, 0, 100, 30));
+    }
+    RecordingCanvas window;
+    window.drawScrolled(1, content, Point(0, -400), Rect(0, 0, 100, 4000), Rect(0, 0, 100, 200));
+    CHECK_EQ(window.count(RecordingCanvas::Op::DrawScrolled), 1u);
+
+    // the base canvas has no surface to shift, it just replays the list
+    // with the viewport pushed as a clip, so rows 10 to 14 are drawn
+    CountingCanvas target;
+    window.replay(target);
+    CHECK_EQ(target.m_clips, 1u);
+    CHECK_EQ(target.m_texts, 5u);
+    CHECK_EQ(target.culledLists(), 95u);
+    CHECK(target.m_saved.empty());
+}
+
+static void benchmarkRecording() {
+    constexpr int buttons = 10000;
+    RecordingCanvas recording;
+    report("record 10,000 buttons", timeMs([&] {
+        for (int i = 0; i < buttons; i++) {
+            paintButton(recording, Rect(0, i * 40, 100, 30));
+        }
+    }));
+    CHECK_EQ(recording.count(), static_cast<size_t>(buttons) * 3);
+    std::printf("%-48s %10zu bytes\n", "command buffer", recording.size());
+
+    CountingCanvas target;
+    report("replay 10,000 buttons", timeMs([&] {
+        recording.replay(target);
+    }));
+    CHECK_EQ(target.m_shapes, static_cast<size_t>(buttons) * 2);
+}
+
+int main() {
+    testRecordAndReplay();
+    testListsAreTranslatedAndCulled();
+    testScrolledListsAreClipped();
+    benchmarkRecording();
+    return finish();
+}
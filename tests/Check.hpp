@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+// Just enough of a test framework for the tests here. A failed check
+// is printed and makes finish() return non-zero, without stopping
+// the test so that every broken check shows up in one run
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures()++; \
+    } \
+} while (false)
+
+// for comparing counts, printing both values when they differ
+#define CHECK_EQ(a, b) do { \
+    auto a_ = (a); auto b_ = (b); \
+    if (!(a_ == b_)) { \
+        std::printf( \
+            "%s:%d: check failed: %s == %s (%lld vs %lld)\n", __FILE__, __LINE__, \
+            #a, #b, static_cast<long long>(a_), static_cast<long long>(b_) \
+        ); \
+        failures()++; \
+    } \
+} while (false)
+
+// runs func and returns how long it took in milliseconds
+template<class Func>
+double timeMs(Func&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    std::chrono::duration<double, std::milli> took =
+        std::chrono::steady_clock::now() - start;
+    return took.count();
+}
+
+inline void report(const char* what, double ms) {
+    std::printf("%-48s %10.3f ms\n", what, ms);
+}
+
+inline int finish() {
+    if (failures()) {
+        std::printf("%d check(s) failed\n", failures());
+        return 1;
+    }
+    return 0;
+}
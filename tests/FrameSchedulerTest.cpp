@@ -0,0 +1,114 @@
+#include "Check.hpp"
+#include <FrameScheduler.hpp>
+
+// A scheduler on a virtual clock, with the callbacks counting
+// what they're asked to do instead of touching a window
+struct Harness {
+    VirtualClock* m_clock = new VirtualClock();
+    FrameScheduler m_scheduler { std::unique_ptr<Clock>(m_clock) };
+    std::vector<unsigned int> m_wakes;
+    size_t m_layouts = 0;
+    size_t m_paints = 0;
+    Rect m_painted;
+
+    Harness() {
+        m_scheduler.layout([this]() -> void {
+            m_layouts++;
+        });
+        m_scheduler.paint([this](Rect const& damage) -> void {
+            m_paints++;
+            m_painted = damage;
+        });
+        m_scheduler.wake([this](unsigned int delay) -> void {
+            m_wakes.push_back(delay);
+        });
+    }
+};
+
+static void testUpdatesCoalesceIntoOneFrame() {
+    Harness h;
+    constexpr int updates = 100;
+    for (int i = 0; i < updates; i++) {
+        h.m_scheduler.invalidate(Rect(i, 0, 10, 10));
+        h.m_scheduler.requestLayout();
+    }
+    CHECK_EQ(h.m_wakes.size(), 1u);
+    CHECK_EQ(h.m_wakes.front(), 0u);
+    CHECK_EQ(h.m_scheduler.stats().m_invalidations, static_cast<size_t>(updates));
+
+    CHECK(h.m_scheduler.tick());
+    CHECK_EQ(h.m_scheduler.stats().m_frames, 1u);
+    CHECK_EQ(h.m_layouts, 1u);
+    CHECK_EQ(h.m_paints, 1u);
+    // the damage of every update, in one rect
+    CHECK_EQ(h.m_painted.X, 0);
+    CHECK_EQ(h.m_painted.Width, updates - 1 + 10);
+
+    // nothing left, so there's no frame after it
+    CHECK(!h.m_scheduler.pending());
+    CHECK(!h.m_scheduler.tick());
+    CHECK_EQ(h.m_wakes.size(), 1u);
+}
+
+static void testFramesAreCappedToTheInterval() {
+    Harness h;
+    h.m_scheduler.maxFps(50);
+    h.m_scheduler.invalidate(Rect(0, 0, 10, 10));
+    CHECK(h.m_scheduler.tick());
+
+    // updates right after a frame wait out the rest of the interval
+    h.m_clock->advance(5.0);
+    for (int i = 0; i < 10; i++) {
+        h.m_scheduler.invalidate(Rect(0, 0, 10, 10));
+    }
+    CHECK_EQ(h.m_wakes.size(), 2u);
+    CHECK_EQ(h.m_wakes.back(), 15u);
+
+    // a timer firing early is asked to wait again
+    h.m_clock->advance(10.0);
+    CHECK(!h.m_scheduler.tick());
+    CHECK_EQ(h.m_wakes.size(), 3u);
+    CHECK_EQ(h.m_wakes.back(), 5u);
+
+    h.m_clock->advance(5.0);
+    CHECK(h.m_scheduler.tick());
+    CHECK_EQ(h.m_paints, 2u);
+    CHECK_EQ(h.m_scheduler.stats().m_frames, 2u);
+}
+
+static void testLayoutRunOutsideOfAFrame() {
+    Harness h;
+    h.m_scheduler.requestLayout();
+    // what WM_PAINT does when the system asks for a paint first
+    h.m_scheduler.laidOut();
+    CHECK(!h.m_scheduler.pending());
+    CHECK(!h.m_scheduler.tick());
+    CHECK_EQ(h.m_layouts, 0u);
+    CHECK_EQ(h.m_scheduler.stats().m_frames, 0u);
+}
+
+static void testAnimationsRunOncePerFrame() {
+    Harness h;
+    h.m_scheduler.maxFps(0);
+    int steps = 0;
+    h.m_scheduler.animate([&](double) -> bool {
+        return ++steps < 3;
+    });
+    auto cancelled = h.m_scheduler.animate([&](double) -> bool {
+        return true;
+    });
+    h.m_scheduler.cancel(cancelled);
+    while (h.m_scheduler.tick()) {}
+    CHECK_EQ(steps, 3);
+    CHECK_EQ(h.m_scheduler.stats().m_frames, 3u);
+    CHECK_EQ(h.m_scheduler.stats().m_animationSteps, 3u);
+    CHECK(!h.m_scheduler.pending());
+}
+
+int main() {
+    testUpdatesCoalesceIntoOneFrame();
+    testFramesAreCappedToTheInterval();
+    testLayoutRunOutsideOfAFrame();
+    testAnimationsRunOncePerFrame();
+    return finish();
+}
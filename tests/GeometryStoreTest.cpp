@@ -0,0 +1,167 @@
+#include "Check.hpp"
+#include <GeometryStore.hpp>
+#include <memory>
+#include <random>
+
+static void testQueriesMatchTheRects() {
+    GeometryStore store;
+    // a 10x10 grid of 10 pixel cells, every other one wanting the mouse
+    for (uint32_t i = 0; i < 100; i++) {
+        store.attach(i);
+        store.offsetX(i) = static_cast<int>(i % 10) * 10;
+        store.offsetY(i) = static_cast<int>(i / 10) * 10;
+        store.width(i) = 10;
+        store.height(i) = 10;
+        store.flag(i, GeometryStore::Visible, true);
+        store.flag(i, GeometryStore::WantsMouse, i % 2 == 0);
+    }
+    CHECK_EQ(store.live(), 100u);
+
+    std::vector<uint32_t> out;
+    store.query(Point(25, 35), GeometryStore::Visible, out);
+    CHECK(out.size() == 1 && out[0] == 32);
+    out.clear();
+    store.query(Point(35, 35), GeometryStore::Visible | GeometryStore::WantsMouse, out);
+    CHECK(out.empty());
+
+    // the rect covers cells 1-2 across and 0-1 down, half of which want it
+    out.clear();
+    store.query(Rect(15, 5, 10, 10), GeometryStore::Visible | GeometryStore::WantsMouse, out);
+    CHECK(out.size() == 2 && out[0] == 2 && out[1] == 12);
+
+    // hidden or detached slots aren't found
+    store.flag(2, GeometryStore::Visible, false);
+    store.detach(12);
+    out.clear();
+    store.query(Rect(15, 5, 10, 10), GeometryStore::Visible | GeometryStore::WantsMouse, out);
+    CHECK(out.empty());
+    CHECK_EQ(store.live(), 99u);
+}
+
+static void testRowsMoveBetweenStores() {
+    // what a widget going into a window does
+    GeometryStore detached;
+    GeometryStore window;
+    detached.attach(7);
+    detached.width(7) = 40;
+    detached.offsetX(7) = 3;
+    detached.flag(7, GeometryStore::Visible, true);
+
+    window.take(detached, 7);
+    CHECK_EQ(window.width(7), 40);
+    CHECK_EQ(window.offsetX(7), 3);
+    CHECK(window.flag(7, GeometryStore::Visible));
+    CHECK_EQ(window.live(), 1u);
+    CHECK_EQ(detached.live(), 0u);
+    std::vector<uint32_t> out;
+    detached.query(Point(5, 0), 0, out);
+    CHECK(out.empty());
+
+    // and a slot that was never anywhere starts out zeroed
+    window.take(detached, 3);
+    CHECK_EQ(window.width(3), 0);
+    CHECK_EQ(window.live(), 2u);
+}
+
+// what a widget looks like to a walk over the tree, the geometry
+// among everything else it holds and one allocation per node
+struct Node {
+    int m_x = 0;
+    int m_y = 0;
+    int m_width = 0;
+    int m_height = 0;
+    int m_offsetX = 0;
+    int m_offsetY = 0;
+    bool m_visible = true;
+    bool m_wantsMouse = false;
+    Node* m_parent = nullptr;
+    std::vector<Node*> m_children;
+    char m_rest[320] = {};
+};
+
+static void walk(Node* node, Rect const& rect, std::vector<Node*>& out) {
+    auto hit =
+        node->m_visible && node->m_wantsMouse &&
+        node->m_offsetX < rect.X + rect.Width && rect.X < node->m_offsetX + node->m_width &&
+        node->m_offsetY < rect.Y + rect.Height && rect.Y < node->m_offsetY + node->m_height;
+    if (hit) out.push_back(node);
+    for (auto& child : node->m_children) {
+        walk(child, rect, out);
+    }
+}
+
+static void benchmarkBoundsQueries() {
+    // 20,000 nodes under random parents, in a 2000x2000 window
+    constexpr uint32_t count = 20000;
+    constexpr int queries = 1000;
+    std::mt19937 random(1);
+    std::vector<std::unique_ptr<Node>> nodes;
+    GeometryStore store;
+    for (uint32_t i = 0; i < count; i++) {
+        auto node = std::make_unique<Node>();
+        if (i) {
+            node->m_parent = nodes[random() % i].get();
+            node->m_parent->m_children.push_back(node.get());
+            node->m_x = static_cast<int>(random() % 100);
+            node->m_y = static_cast<int>(random() % 100);
+            node->m_offsetX = (node->m_parent->m_offsetX + node->m_x) % 1900;
+            node->m_offsetY = (node->m_parent->m_offsetY + node->m_y) % 1900;
+        }
+        node->m_width = 20 + static_cast<int>(random() % 80);
+        node->m_height = 20 + static_cast<int>(random() % 40);
+        node->m_visible = random() % 10 != 0;
+        node->m_wantsMouse = random() % 3 == 0;
+
+        store.attach(i);
+        store.x(i) = node->m_x;
+        store.y(i) = node->m_y;
+        store.width(i) = node->m_width;
+        store.height(i) = node->m_height;
+        store.offsetX(i) = node->m_offsetX;
+        store.offsetY(i) = node->m_offsetY;
+        store.flag(i, GeometryStore::Visible, node->m_visible);
+        store.flag(i, GeometryStore::WantsMouse, node->m_wantsMouse);
+        nodes.push_back(std::move(node));
+    }
+
+    std::vector<Rect> rects;
+    for (int i = 0; i < queries; i++) {
+        rects.emplace_back(
+            static_cast<int>(random() % 1800), static_cast<int>(random() % 1800), 200, 200
+        );
+    }
+
+    size_t walked = 0;
+    std::vector<Node*> found;
+    auto aos = timeMs([&] {
+        for (auto& rect : rects) {
+            found.clear();
+            walk(nodes.front().get(), rect, found);
+            walked += found.size();
+        }
+    });
+    size_t scanned = 0;
+    std::vector<uint32_t> slots;
+    auto soa = timeMs([&] {
+        for (auto& rect : rects) {
+            slots.clear();
+            store.query(rect, GeometryStore::Visible | GeometryStore::WantsMouse, slots);
+            scanned += slots.size();
+        }
+    });
+    // both find the same nodes, the walk in tree order and the scan in slot order
+    CHECK_EQ(walked, scanned);
+    CHECK(scanned > 0);
+
+    report("1,000 bounds queries, 20,000 nodes, tree walk", aos);
+    report("1,000 bounds queries, 20,000 nodes, GeometryStore", soa);
+    std::printf("%-48s %10zu bytes\n", "node in the tree", sizeof(Node));
+    std::printf("%-48s %10zu bytes\n", "row in the store", 6 * sizeof(int) + sizeof(uint8_t));
+}
+
+int main() {
+    testQueriesMatchTheRects();
+    testRowsMoveBetweenStores();
+    benchmarkBoundsQueries();
+    return finish();
+}
@@ -0,0 +1,169 @@
+#include "Check.hpp"
+#include <HitGrid.hpp>
+#include <random>
+
+// what the grid should agree with, right and bottom edges outside
+static bool inside(Rect const& r, Point const& p) {
+    return p.X >= r.X && p.X < r.X + r.Width && p.Y >= r.Y && p.Y < r.Y + r.Height;
+}
+
+static std::vector<int> sorted(HitGrid<int> const& grid, Point const& p) {
+    std::vector<int> out;
+    grid.query(p, out);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+static void testPointQueries() {
+    HitGrid<int> grid;
+    grid.insert(1, Rect(0, 0, 100, 100));
+    grid.insert(2, Rect(50, 50, 100, 100));
+    grid.insert(3, Rect(200, 0, 10, 10));
+    CHECK_EQ(grid.size(), 3u);
+
+    CHECK(sorted(grid, Point(10, 10)) == std::vector<int>({ 1 }));
+    CHECK(sorted(grid, Point(75, 75)) == std::vector<int>({ 1, 2 }));
+    CHECK(sorted(grid, Point(149, 149)) == std::vector<int>({ 2 }));
+    CHECK(sorted(grid, Point(205, 5)) == std::vector<int>({ 3 }));
+    // right and bottom edges are outside the rect
+    CHECK(sorted(grid, Point(100, 10)).empty());
+    CHECK(sorted(grid, Point(150, 149)).empty());
+    CHECK(sorted(grid, Point(210, 5)).empty());
+    // nothing at all in the point's cell
+    CHECK(sorted(grid, Point(1000, 1000)).empty());
+}
+
+static void testCellEdges() {
+    // rects ending exactly on a cell boundary, and on either side of zero
+    constexpr auto size = HitGrid<int>::s_cellSize;
+    HitGrid<int> grid;
+    grid.insert(1, Rect(0, 0, size, size));
+    grid.insert(2, Rect(size, 0, 1, 1));
+    grid.insert(3, Rect(-10, -10, 20, 20));
+    grid.insert(4, Rect(-size - 5, 0, 10, 10));
+
+    CHECK(sorted(grid, Point(size - 1, size - 1)) == std::vector<int>({ 1 }));
+    CHECK(sorted(grid, Point(size, 0)) == std::vector<int>({ 2 }));
+    CHECK(sorted(grid, Point(-1, -1)) == std::vector<int>({ 3 }));
+    CHECK(sorted(grid, Point(5, 5)) == std::vector<int>({ 1, 3 }));
+    CHECK(sorted(grid, Point(-size - 1, 5)) == std::vector<int>({ 4 }));
+    CHECK(sorted(grid, Point(-size + 5, 5)).empty());
+
+    // empty rects are kept track of but never found
+    grid.insert(5, Rect(10, 10, 0, 20));
+    CHECK(grid.contains(5));
+    CHECK(sorted(grid, Point(10, 15)) == std::vector<int>({ 1 }));
+}
+
+static void testMoveAndRemove() {
+    HitGrid<int> grid;
+    grid.insert(1, Rect(0, 0, 10, 10));
+    // moving takes the item out of the cells it was in
+    grid.insert(1, Rect(300, 300, 10, 10));
+    CHECK_EQ(grid.size(), 1u);
+    CHECK(sorted(grid, Point(5, 5)).empty());
+    CHECK(sorted(grid, Point(305, 305)) == std::vector<int>({ 1 }));
+    // inserting it again where it is changes nothing
+    grid.insert(1, Rect(300, 300, 10, 10));
+    CHECK(sorted(grid, Point(305, 305)) == std::vector<int>({ 1 }));
+
+    grid.insert(2, Rect(300, 300, 200, 200));
+    grid.remove(1);
+    CHECK(!grid.contains(1));
+    CHECK(sorted(grid, Point(305, 305)) == std::vector<int>({ 2 }));
+    // removing what isn't there is fine
+    grid.remove(1);
+    grid.remove(7);
+    CHECK_EQ(grid.size(), 1u);
+
+    grid.clear();
+    CHECK_EQ(grid.size(), 0u);
+    CHECK(sorted(grid, Point(305, 305)).empty());
+}
+
+static void testMatchesLinearScan() {
+    // random rects, some moved and some removed, against checking them all
+    std::mt19937 random(1);
+    std::vector<Rect> rects(2000);
+    std::vector<bool> live(rects.size(), true);
+    HitGrid<int> grid;
+    auto place = [&](int i) {
+        rects[i] = Rect(
+            static_cast<int>(random() % 1200) - 100, static_cast<int>(random() % 1200) - 100,
+            static_cast<int>(random() % 150), static_cast<int>(random() % 150)
+        );
+        grid.insert(i, rects[i]);
+    };
+    for (int i = 0; i < static_cast<int>(rects.size()); i++) place(i);
+    for (int i = 0; i < 500; i++) place(static_cast<int>(random() % rects.size()));
+    for (int i = 0; i < 300; i++) {
+        auto item = static_cast<int>(random() % rects.size());
+        live[item] = false;
+        grid.remove(item);
+    }
+
+    int mismatches = 0;
+    for (int i = 0; i < 2000; i++) {
+        Point p(static_cast<int>(random() % 1200) - 100, static_cast<int>(random() % 1200) - 100);
+        std::vector<int> expected;
+        for (int j = 0; j < static_cast<int>(rects.size()); j++) {
+            if (live[j] && inside(rects[j], p)) expected.push_back(j);
+        }
+        if (sorted(grid, p) != expected) mismatches++;
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+static void benchmarkPointQueries() {
+    // 10,000 widget-sized rects over a 4000x4000 window
+    constexpr int items = 10000;
+    constexpr int queries = 20000;
+    std::mt19937 random(2);
+    std::vector<Rect> rects;
+    HitGrid<int> grid;
+    auto build = timeMs([&] {
+        for (int i = 0; i < items; i++) {
+            rects.emplace_back(
+                static_cast<int>(random() % 4000), static_cast<int>(random() % 4000),
+                20 + static_cast<int>(random() % 100), 20 + static_cast<int>(random() % 40)
+            );
+            grid.insert(i, rects.back());
+        }
+    });
+    std::vector<Point> points;
+    for (int i = 0; i < queries; i++) {
+        points.emplace_back(static_cast<int>(random() % 4000), static_cast<int>(random() % 4000));
+    }
+
+    size_t gridHits = 0;
+    std::vector<int> out;
+    auto gridMs = timeMs([&] {
+        for (auto& p : points) {
+            out.clear();
+            grid.query(p, out);
+            gridHits += out.size();
+        }
+    });
+    size_t scanHits = 0;
+    auto scanMs = timeMs([&] {
+        for (auto& p : points) {
+            for (auto& r : rects) {
+                if (inside(r, p)) scanHits++;
+            }
+        }
+    });
+    CHECK_EQ(gridHits, scanHits);
+
+    report("insert 10,000 rects", build);
+    report("20,000 point queries, 10,000 rects, HitGrid", gridMs);
+    report("20,000 point queries, 10,000 rects, scan", scanMs);
+}
+
+int main() {
+    testPointQueries();
+    testCellEdges();
+    testMoveAndRemove();
+    testMatchesLinearScan();
+    benchmarkPointQueries();
+    return finish();
+}
@@ -0,0 +1,125 @@
+#include "Check.hpp"
+#include <LayerCache.hpp>
+
+// stands in for a bitmap, counting how many are around
+struct CountedSurface : public LayerCache::Surface {
+    static int s_live;
+
+    CountedSurface() { s_live++; }
+    ~CountedSurface() { s_live--; }
+};
+int CountedSurface::s_live = 0;
+
+static std::shared_ptr<RecordingCanvas const> list() {
+    auto list = std::make_shared<RecordingCanvas>();
+    list->fillRect(RectF(0.f, 0.f, 10.f, 10.f), Fill(Color(255, 0, 0)));
+    return list;
+}
+
+// what GdiCanvas::drawLayer does with the cache
+static bool draw(LayerCache& cache, uintptr_t key, std::shared_ptr<RecordingCanvas const> const& list, Rect const& bounds) {
+    if (cache.find(key, list, bounds)) return true;
+    cache.store(key, list, bounds, std::make_unique<CountedSurface>());
+    return false;
+}
+
+static void testHitsAndMisses() {
+    LayerCache cache;
+    auto a = list();
+    Rect bounds(0, 0, 100, 100);
+    CHECK(!draw(cache, 1, a, bounds));
+    CHECK(draw(cache, 1, a, bounds));
+    CHECK(draw(cache, 1, a, bounds));
+    CHECK_EQ(cache.stats().m_hits, 2u);
+    CHECK_EQ(cache.stats().m_misses, 1u);
+    CHECK_EQ(cache.bytes(), LayerCache::bytes(bounds));
+
+    // re-recorded, so the layer is stale and replaced rather than added
+    auto b = list();
+    CHECK(!draw(cache, 1, b, bounds));
+    // and so is one at a new size
+    CHECK(!draw(cache, 1, b, Rect(0, 0, 100, 50)));
+    CHECK_EQ(cache.size(), 1u);
+    CHECK_EQ(cache.bytes(), LayerCache::bytes(Rect(0, 0, 100, 50)));
+    CHECK_EQ(CountedSurface::s_live, 1);
+    // moving doesn't matter, only the size does
+    CHECK(draw(cache, 1, b, Rect(30, 30, 100, 50)));
+    CHECK(cache.stats().hitRate() > 0.3f);
+}
+
+static void testBudgetEvictsTheOldest() {
+    // room for three 100x100 layers
+    Rect bounds(0, 0, 100, 100);
+    LayerCache cache(LayerCache::bytes(bounds) * 3);
+    auto l = list();
+    for (uintptr_t key = 1; key <= 3; key++) {
+        draw(cache, key, l, bounds);
+    }
+    // 1 was used last, so 2 is the oldest when 4 comes in
+    CHECK(draw(cache, 1, l, bounds));
+    draw(cache, 4, l, bounds);
+    CHECK_EQ(cache.stats().m_evictions, 1u);
+    CHECK_EQ(cache.size(), 3u);
+    CHECK(cache.bytes() <= cache.budget());
+    CHECK(draw(cache, 1, l, bounds));
+    CHECK(!draw(cache, 2, l, bounds));
+
+    // a lower budget evicts right away
+    cache.budget(LayerCache::bytes(bounds));
+    CHECK_EQ(cache.size(), 1u);
+    CHECK_EQ(CountedSurface::s_live, 1);
+}
+
+static void testScrollSurfacesCountTowardsTheBudget() {
+    Rect bounds(0, 0, 100, 100);
+    LayerCache cache(LayerCache::bytes(bounds) * 4);
+    auto l = list();
+    draw(cache, 1, l, bounds);
+    draw(cache, 2, l, bounds);
+
+    // two surfaces' worth, which leaves room for both layers
+    auto& surface = cache.scrollSurface(3, 100, 100);
+    CHECK(!surface.m_front);
+    surface.m_front = std::make_unique<CountedSurface>();
+    surface.m_back = std::make_unique<CountedSurface>();
+    CHECK_EQ(cache.bytes(), LayerCache::bytes(bounds) * 4);
+    CHECK_EQ(cache.size(), 2u);
+
+    // the same size is the same surface, a new one pushes a layer out
+    CHECK(cache.scrollSurface(3, 100, 100).m_front);
+    auto& bigger = cache.scrollSurface(3, 100, 150);
+    CHECK(!bigger.m_front);
+    CHECK_EQ(cache.stats().m_evictions, 1u);
+    CHECK_EQ(cache.bytes(), LayerCache::bytes(bounds) + LayerCache::bytes(Rect(0, 0, 100, 150)) * 2);
+}
+
+static void testDroppedKeysGiveBackTheirMemory() {
+    // what the window does as widgets are deleted
+    LayerCache cache;
+    auto l = list();
+    Rect bounds(0, 0, 200, 200);
+    draw(cache, 7, l, bounds);
+    auto& surface = cache.scrollSurface(8, 50, 50);
+    surface.m_front = std::make_unique<CountedSurface>();
+    CHECK_EQ(CountedSurface::s_live, 2);
+
+    cache.drop(7);
+    CHECK_EQ(cache.bytes(), LayerCache::bytes(Rect(0, 0, 50, 50)) * 2);
+    cache.drop(8);
+    CHECK_EQ(cache.bytes(), 0u);
+    CHECK_EQ(CountedSurface::s_live, 0);
+    // and a new widget that ends up with the key isn't handed the old layer
+    CHECK(!draw(cache, 7, l, bounds));
+    // dropping what isn't there does nothing
+    cache.drop(99);
+    CHECK_EQ(cache.size(), 1u);
+}
+
+int main() {
+    testHitsAndMisses();
+    testBudgetEvictsTheOldest();
+    testScrollSurfacesCountTowardsTheBudget();
+    testDroppedKeysGiveBackTheirMemory();
+    CHECK_EQ(CountedSurface::s_live, 0);
+    return finish();
+}
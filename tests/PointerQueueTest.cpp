@@ -0,0 +1,97 @@
+#include "Check.hpp"
+#include <PointerQueue.hpp>
+#include <vector>
+
+// A recorded pointer trace replayed against frames, the way the window
+// feeds WM_MOUSEMOVE into the queue and takes from it once per frame
+struct Replay {
+    PointerQueue m_queue;
+    std::vector<Point> m_dispatched;
+    size_t m_requests = 0;
+
+    void move(Point const& p, bool down = false) {
+        if (m_queue.move(p, down)) {
+            m_requests++;
+        }
+    }
+    void frame() {
+        Point p;
+        bool down;
+        if (m_queue.take(p, down)) {
+            m_dispatched.push_back(p);
+        }
+    }
+};
+
+static void testSlowMovesDispatchOnceEach() {
+    // a frame between every move, so none of them are coalesced
+    Replay r;
+    for (int i = 0; i < 100; i++) {
+        r.move(Point(i, i));
+        r.frame();
+    }
+    CHECK_EQ(r.m_dispatched.size(), 100u);
+    CHECK_EQ(r.m_requests, 100u);
+    CHECK_EQ(r.m_queue.stats().m_coalesced, 0u);
+    CHECK_EQ(r.m_dispatched.back().X, 99);
+}
+
+static void testFastMovesDispatchOncePerFrame() {
+    // a 1000 Hz mouse against 60 fps, 1 second of it
+    Replay r;
+    size_t frames = 0;
+    for (int ms = 0; ms < 1000; ms++) {
+        r.move(Point(ms, ms / 2));
+        if (ms % 16 == 15) {
+            r.frame();
+            frames++;
+        }
+    }
+    r.frame();
+    frames++;
+    auto& stats = r.m_queue.stats();
+    CHECK_EQ(r.m_dispatched.size(), frames);
+    // one frame asked for per dispatch, not per move
+    CHECK_EQ(r.m_requests, frames);
+    CHECK_EQ(stats.m_moves, 1000u);
+    CHECK_EQ(stats.m_moves, stats.m_dispatched + stats.m_coalesced + stats.m_cached);
+    // and it's always the latest position that's dispatched
+    CHECK_EQ(r.m_dispatched.back().X, 999);
+    std::printf(
+        "%-48s %10zu of %zu\n", "moves dispatched at 1000 Hz and 60 fps",
+        stats.m_dispatched, stats.m_moves
+    );
+}
+
+static void testMovesToTheSameSpotAreDropped() {
+    Replay r;
+    r.move(Point(10, 10));
+    r.frame();
+    // jitter that ends up where it started, and a repeat of the same move
+    r.move(Point(11, 10));
+    r.move(Point(10, 10));
+    r.frame();
+    r.move(Point(10, 10));
+    r.frame();
+    CHECK_EQ(r.m_dispatched.size(), 1u);
+    CHECK_EQ(r.m_queue.stats().m_cached, 2u);
+
+    // pressing at the same spot is a different move
+    r.move(Point(10, 10), true);
+    r.frame();
+    CHECK_EQ(r.m_dispatched.size(), 2u);
+
+    // once what's under the pointer changed, the same spot resolves again
+    r.m_queue.invalidate();
+    r.move(Point(10, 10), true);
+    r.frame();
+    CHECK_EQ(r.m_dispatched.size(), 3u);
+    CHECK(!r.m_queue.pending());
+}
+
+int main() {
+    testSlowMovesDispatchOnceEach();
+    testFastMovesDispatchOncePerFrame();
+    testMovesToTheSameSpotAreDropped();
+    return finish();
+}
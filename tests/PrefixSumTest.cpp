@@ -0,0 +1,88 @@
+#include "Check.hpp"
+#include <PrefixSum.hpp>
+#include <random>
+
+static void testMatchesRunningTotals() {
+    PrefixSum sums;
+    sums.assign(1000, 32);
+    std::vector<int> values(1000, 32);
+    std::mt19937 random(1);
+    for (int i = 0; i < 500; i++) {
+        auto index = random() % values.size();
+        auto value = static_cast<int>(random() % 100);
+        values[index] = value;
+        sums.set(index, value);
+    }
+    // every sum and every row start against adding it all up
+    int64_t total = 0;
+    auto same = true;
+    for (size_t i = 0; i < values.size(); i++) {
+        same = same && sums.sum(i) == total && sums.get(i) == values[i];
+        if (values[i]) {
+            same = same && sums.find(total) == i && sums.find(total + values[i] - 1) == i;
+        }
+        total += values[i];
+    }
+    CHECK(same);
+    CHECK_EQ(sums.total(), total);
+    CHECK_EQ(sums.find(-5), 0u);
+    CHECK_EQ(sums.find(total), values.size());
+}
+
+static void benchmarkRowCounts() {
+    // finding the row at a scroll offset and a row getting its measured
+    // height, as a list of that many rows scrolls
+    std::printf("%-24s %12s %12s %12s %14s\n", "rows", "find ms", "set ms", "scan ms", "bytes");
+    for (size_t rows : { 1000u, 10000u, 100000u, 1000000u }) {
+        PrefixSum sums;
+        sums.assign(rows, 32);
+        std::vector<int> heights(rows, 32);
+        std::mt19937 random(1);
+        constexpr int lookups = 10000;
+        std::vector<int64_t> offsets;
+        for (int i = 0; i < lookups; i++) {
+            offsets.push_back(random() % sums.total());
+        }
+
+        size_t found = 0;
+        auto find = timeMs([&] {
+            for (auto& offset : offsets) {
+                found += sums.find(offset);
+            }
+        });
+        auto set = timeMs([&] {
+            for (int i = 0; i < lookups; i++) {
+                auto row = random() % rows;
+                sums.set(row, 32 + (i % 2) * 8);
+                heights[row] = 32 + (i % 2) * 8;
+            }
+        });
+        // what a plain array of heights costs, adding up to the offset,
+        // for a hundredth of the lookups since it's linear in the rows
+        size_t scanned = 0;
+        auto scan = timeMs([&] {
+            for (int i = 0; i < lookups / 100; i++) {
+                int64_t at = 0;
+                size_t row = 0;
+                while (row < rows && at + heights[row] <= offsets[i]) {
+                    at += heights[row++];
+                }
+                scanned += row;
+            }
+        }) * 100;
+        CHECK(found > 0 && scanned > 0);
+        CHECK_EQ(sums.total(), sums.sum(rows));
+
+        // a value and a tree node per row, nothing else
+        auto bytes = rows * (sizeof(int) + sizeof(int64_t)) + sizeof(int64_t);
+        std::printf(
+            "%-24zu %12.3f %12.3f %12.3f %14zu\n", rows, find, set, scan, bytes
+        );
+    }
+}
+
+int main() {
+    testMatchesRunningTotals();
+    benchmarkRowCounts();
+    return finish();
+}
@@ -0,0 +1,68 @@
+#include "Check.hpp"
+#include <RoundRectCache.hpp>
+
+static void testShapesAreSharedBySize() {
+    RoundRectCache cache;
+    auto& a = cache.shape(100, 30, 8);
+    auto& b = cache.shape(100, 30, 8);
+    CHECK(&a == &b);
+    CHECK_EQ(cache.stats().m_built, 1u);
+    CHECK_EQ(cache.stats().m_hits, 1u);
+    // the outline is in local coordinates, so any button that size fits
+    auto fresh = RoundRectCache::flatten(100, 30, 8);
+    CHECK_EQ(a.m_polygon.size(), fresh.size());
+    CHECK(a.m_polygon.front().X == fresh.front().X && a.m_polygon.back().Y == fresh.back().Y);
+    cache.shape(100, 30, 20);
+    cache.shape(120, 30, 8);
+    CHECK_EQ(cache.size(), 3u);
+}
+
+static void testLeastRecentlyUsedIsDropped() {
+    RoundRectCache cache;
+    cache.shape(1, 1, 2);
+    for (int i = 0; i < static_cast<int>(RoundRectCache::s_capacity); i++) {
+        cache.shape(2 + i, 1, 2);
+    }
+    CHECK_EQ(cache.size(), RoundRectCache::s_capacity);
+    // the first one was the oldest, so it's built again
+    cache.resetStats();
+    cache.shape(1, 1, 2);
+    CHECK_EQ(cache.stats().m_built, 1u);
+}
+
+static void benchmarkButtons() {
+    // 500 buttons in a handful of sizes, painted for 100 frames,
+    // the way a settings page with a few kinds of buttons looks
+    constexpr int buttons = 500;
+    constexpr int frames = 100;
+    constexpr int widths[] = { 80, 100, 120, 160, 240 };
+    size_t points = 0;
+
+    report("500 buttons x 100 frames, fresh paths", timeMs([&] {
+        for (int f = 0; f < frames; f++) {
+            for (int i = 0; i < buttons; i++) {
+                points += RoundRectCache::flatten(widths[i % 5], 30, 8).size();
+            }
+        }
+    }));
+
+    RoundRectCache cache;
+    report("500 buttons x 100 frames, cached paths", timeMs([&] {
+        for (int f = 0; f < frames; f++) {
+            for (int i = 0; i < buttons; i++) {
+                points -= cache.shape(widths[i % 5], 30, 8).m_polygon.size();
+            }
+        }
+    }));
+    // the same outlines either way, built once per size
+    CHECK_EQ(points, 0u);
+    CHECK_EQ(cache.stats().m_built, 5u);
+    CHECK_EQ(cache.stats().m_hits, static_cast<size_t>(buttons) * frames - 5);
+}
+
+int main() {
+    testShapesAreSharedBySize();
+    testLeastRecentlyUsedIsDropped();
+    benchmarkButtons();
+    return finish();
+}
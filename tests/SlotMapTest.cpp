@@ -0,0 +1,126 @@
+#include "Check.hpp"
+#include <SlotMap.hpp>
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+
+// lets the tests see how many slots are backing the map
+template<class T, unsigned IndexBits = 20, unsigned GenerationBits = 32 - IndexBits>
+struct Probe : public SlotMap<T, IndexBits, GenerationBits> {
+    size_t slots() const {
+        return this->m_slots.size();
+    }
+};
+
+static void testStaleHandlesDontResolve() {
+    SlotMap<int> map;
+    auto a = map.insert(1);
+    CHECK(a);
+    CHECK_EQ(*map.get(a), 1);
+    CHECK(map.erase(a));
+    CHECK(!map.erase(a));
+    // the slot is reused, but the old handle doesn't see what's in it now
+    auto b = map.insert(2);
+    CHECK((a.value() & SlotMap<int>::s_indexMask) == (b.value() & SlotMap<int>::s_indexMask));
+    CHECK(a != b);
+    CHECK(!map.get(a));
+    CHECK_EQ(*map.get(b), 2);
+    CHECK(!map.get(SlotHandle()));
+    CHECK_EQ(map.size(), 1u);
+    // and only what's in there now is visited
+    auto c = map.insert(3);
+    map.erase(b);
+    std::vector<int> values;
+    map.forEach([&](int value) -> void {
+        values.push_back(value);
+    });
+    CHECK(map.contains(c));
+    CHECK(values.size() == 1 && values[0] == 3);
+}
+
+static void testNarrowHandlesWrapAround() {
+    // what menu IDs use, 10 bits of index and 6 of generation
+    Probe<bool, 10, 6> map;
+    auto first = map.insert(true);
+    auto handle = first;
+    for (uint32_t i = 0; i < SlotMap<bool, 10, 6>::s_maxGeneration; i++) {
+        map.erase(handle);
+        handle = map.insert(true);
+        CHECK(handle);
+        CHECK(handle.value() < (1u << 16));
+    }
+    // every generation was used once, so the first handle is back
+    CHECK(handle == first);
+    CHECK_EQ(map.slots(), 1u);
+
+    // and when every slot is taken there's a null handle
+    Probe<bool, 4, 4> small;
+    for (size_t i = 0; i < SlotMap<bool, 4, 4>::s_capacity; i++) {
+        CHECK(small.insert(true));
+    }
+    CHECK(!small.insert(true));
+}
+
+static void benchmarkChurn() {
+    // 100,000 acquires and releases with a thousand or so live at once,
+    // like timers and widget handles coming and going
+    constexpr int operations = 100000;
+    constexpr size_t live = 1000;
+    std::mt19937 random(1);
+
+    Probe<int> map;
+    std::vector<SlotHandle> handles;
+    size_t resolved = 0;
+    size_t peak = 0;
+    report("100,000 acquire/release, SlotMap", timeMs([&] {
+        for (int i = 0; i < operations; i++) {
+            if (handles.size() < live || random() % 2) {
+                handles.push_back(map.insert(i));
+            } else {
+                auto at = random() % handles.size();
+                map.erase(handles[at]);
+                handles[at] = handles.back();
+                handles.pop_back();
+            }
+            resolved += map.get(handles[random() % handles.size()]) != nullptr;
+            peak = std::max(peak, handles.size());
+        }
+    }));
+    CHECK_EQ(resolved, static_cast<size_t>(operations));
+    CHECK_EQ(map.size(), handles.size());
+    // released slots are taken again first, so the backing store only
+    // grows as far as the most that were ever live at once
+    CHECK_EQ(map.slots(), peak);
+    std::printf(
+        "%-48s %10zu for %zu live\n", "slots after the churn", map.slots(), map.size()
+    );
+
+    // the same with ever increasing IDs in a hash map
+    random.seed(1);
+    std::unordered_map<uint32_t, int> ids;
+    std::vector<uint32_t> keys;
+    uint32_t next = 1;
+    resolved = 0;
+    report("100,000 acquire/release, unordered_map", timeMs([&] {
+        for (int i = 0; i < operations; i++) {
+            if (keys.size() < live || random() % 2) {
+                ids.emplace(next, i);
+                keys.push_back(next++);
+            } else {
+                auto at = random() % keys.size();
+                ids.erase(keys[at]);
+                keys[at] = keys.back();
+                keys.pop_back();
+            }
+            resolved += ids.count(keys[random() % keys.size()]);
+        }
+    }));
+    CHECK_EQ(resolved, static_cast<size_t>(operations));
+}
+
+int main() {
+    testStaleHandlesDontResolve();
+    testNarrowHandlesWrapAround();
+    benchmarkChurn();
+    return finish();
+}
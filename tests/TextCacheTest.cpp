@@ -0,0 +1,144 @@
+#include "Check.hpp"
+#include <TextCache.hpp>
+#include <ThreadPool.hpp>
+#include <atomic>
+#include <thread>
+
+// Every character is 8 wide and 16 high, wrapping into as many
+// lines as it takes. Measuring spins for a while so that it costs
+// about as much as a real measurement does
+class FakeMeasurer : public TextMeasurer {
+public:
+    std::atomic<size_t> m_calls { 0 };
+    std::chrono::microseconds m_cost;
+
+    FakeMeasurer(std::chrono::microseconds cost = std::chrono::microseconds(0))
+      : m_cost(cost) {}
+
+    TextSize measure(TextQuery const& query, void*) override {
+        m_calls++;
+        auto until = std::chrono::steady_clock::now() + m_cost;
+        while (std::chrono::steady_clock::now() < until) {}
+        auto width = static_cast<float>(query.m_text.size() * 8);
+        if (!query.m_wrap || query.m_width <= 0 || width <= query.m_width) {
+            return { width, 16.f };
+        }
+        auto perLine = query.m_width / 8;
+        auto lines = (query.m_text.size() + perLine - 1) / perLine;
+        return { static_cast<float>(perLine * 8), static_cast<float>(lines * 16) };
+    }
+};
+
+static std::wstring const s_font = L"Segoe UI";
+
+static TextSize measure(TextCache& cache, std::wstring const& text, bool wrap = false, int width = -1) {
+    return cache.measure({ text, s_font, 18, 0, wrap, width }, nullptr);
+}
+
+static void testRepeatsAreHits() {
+    TextCache cache;
+    auto measurer = new FakeMeasurer();
+    cache.measurer(std::unique_ptr<TextMeasurer>(measurer));
+    std::wstring text = L"Launch";
+    CHECK_EQ(measure(cache, text).m_width, 48.f);
+    CHECK_EQ(measure(cache, text).m_width, 48.f);
+    // text that fits doesn't care about the width it's given
+    CHECK_EQ(measure(cache, text, true, 200).m_width, 48.f);
+    CHECK_EQ(measurer->m_calls.load(), 1u);
+    CHECK_EQ(cache.stats().m_hits, 2u);
+    CHECK_EQ(cache.stats().m_misses, 1u);
+}
+
+static void testWrappedWidthsShareBuckets() {
+    TextCache cache;
+    auto measurer = new FakeMeasurer();
+    cache.measurer(std::unique_ptr<TextMeasurer>(measurer));
+    std::wstring text(100, L'x');
+    // 101 to 103 round down to 100, so only the first one is measured wrapped
+    CHECK_EQ(measure(cache, text, true, 101).m_height, 144.f);
+    CHECK_EQ(measure(cache, text, true, 103).m_height, 144.f);
+    CHECK_EQ(measurer->m_calls.load(), 2u);
+    CHECK_EQ(measure(cache, text, true, 104).m_width, 104.f);
+    CHECK_EQ(measurer->m_calls.load(), 3u);
+}
+
+static void testLeastRecentlyUsedIsEvicted() {
+    TextCache cache(2);
+    auto measurer = new FakeMeasurer();
+    cache.measurer(std::unique_ptr<TextMeasurer>(measurer));
+    std::wstring a = L"a", b = L"bb", c = L"ccc";
+    measure(cache, a);
+    measure(cache, b);
+    measure(cache, a);
+    measure(cache, c);
+    CHECK_EQ(cache.size(), 2u);
+    CHECK_EQ(cache.stats().m_evictions, 1u);
+    // b was the one least recently used
+    measure(cache, a);
+    CHECK_EQ(measurer->m_calls.load(), 3u);
+    measure(cache, b);
+    CHECK_EQ(measurer->m_calls.load(), 4u);
+}
+
+static void testThreadsMeasureTheSameText() {
+    TextCache cache;
+    auto measurer = new FakeMeasurer();
+    cache.measurer(std::unique_ptr<TextMeasurer>(measurer));
+    std::vector<std::wstring> texts;
+    for (int i = 0; i < 64; i++) {
+        texts.push_back(std::wstring(i + 1, L'x'));
+    }
+    ThreadPool pool(8);
+    std::atomic<size_t> wrong { 0 };
+    pool.run(texts.size() * 16, [&](size_t i) {
+        auto& text = texts[i % texts.size()];
+        if (measure(cache, text).m_width != text.size() * 8.f) {
+            wrong++;
+        }
+    });
+    CHECK_EQ(wrong.load(), 0u);
+    CHECK_EQ(cache.size(), texts.size());
+    // threads that missed together may both have measured, but
+    // every text is only kept once
+    CHECK(measurer->m_calls.load() >= texts.size());
+}
+
+// what prefetching the text of a freshly built page costs on a
+// cold cache, with measuring split over more and more threads. It
+// can't go any faster than the machine has cores
+static void benchmarkThreadScaling() {
+    std::printf("%-48s %10u\n", "cores", std::thread::hardware_concurrency());
+    constexpr size_t labels = 2000;
+    std::vector<std::wstring> texts;
+    for (size_t i = 0; i < labels; i++) {
+        texts.push_back(L"Label number " + std::to_wstring(i));
+    }
+    double single = 0.0;
+    for (size_t threads : { 1, 2, 4, 8, 16 }) {
+        TextCache cache(labels);
+        auto measurer = new FakeMeasurer(std::chrono::microseconds(20));
+        cache.measurer(std::unique_ptr<TextMeasurer>(measurer));
+        ThreadPool pool(threads);
+        auto ms = timeMs([&] {
+            pool.run(texts.size(), [&](size_t i) {
+                measure(cache, texts[i]);
+            });
+        });
+        if (threads == 1) single = ms;
+        char what[64];
+        std::snprintf(what, sizeof(what), "measure 2,000 labels on %zu thread(s)", threads);
+        report(what, ms);
+        std::printf("%-48s %10.2fx\n", "  speedup", single / ms);
+        CHECK_EQ(cache.size(), labels);
+        CHECK_EQ(measurer->m_calls.load(), labels);
+    }
+}
+
+int main() {
+    testRepeatsAreHits();
+    testWrappedWidthsShareBuckets();
+    testLeastRecentlyUsedIsEvicted();
+    testThreadsMeasureTheSameText();
+    benchmarkThreadScaling();
+    return finish();
+}
@@ -0,0 +1,134 @@
+#include "Harness.hpp"
+#include <Button.hpp>
+#include <Label.hpp>
+#include <Layout.hpp>
+#include <RectWidget.hpp>
+#include <cstdlib>
+#include <new>
+
+// every allocation in the process goes through these
+static size_t g_allocations = 0;
+
+void* operator new(size_t size) {
+    g_allocations++;
+    if (auto ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+template<class Func>
+size_t allocationsIn(Func&& func) {
+    auto before = g_allocations;
+    func();
+    return g_allocations - before;
+}
+
+// Draws nothing, so that only what the widgets allocate is counted
+class NullCanvas : public Canvas {
+public:
+    Rect m_dirty;
+
+    NullCanvas(Rect const& dirty) : m_dirty(dirty) {}
+
+    void fillRect(RectF const&, Fill const&) override {}
+    void strokeRect(RectF const&, Color const&, REAL) override {}
+    void fillRoundRect(Rect const&, int, Fill const&) override {}
+    void strokeRoundRect(Rect const&, int, Color const&) override {}
+    void fillEllipse(RectF const&, Fill const&) override {}
+    void strokePath(Path const&, Color const&, REAL) override {}
+    void drawText(
+        std::wstring const&, std::wstring const&, int, int,
+        Color const&, RectF const&, TextLayout const&
+    ) override {}
+    void save() override {}
+    void restore() override {}
+    void clipRect(Rect const&) override {}
+    void translate(REAL, REAL) override {}
+    void rotate(REAL) override {}
+
+    Rect dirty() const override {
+        return m_dirty;
+    }
+    void* device() const override {
+        return nullptr;
+    }
+};
+
+// an opaque background with inverted rows of text, buttons and
+// opaque boxes, so there are occluders at every level
+static std::vector<Widget*> buildPage(HeadlessWindow& window) {
+    std::vector<Widget*> widgets;
+    auto background = new RectWidget();
+    background->fill();
+    window.add(background);
+    auto column = new VerticalLayout();
+    column->invert();
+    background->add(column);
+    widgets.push_back(column);
+    for (int i = 0; i < 50; i++) {
+        auto row = new HorizontalLayout();
+        row->invert();
+        column->add(row);
+        auto box = new RectWidget();
+        box->add(new Label("Box " + std::to_string(i)));
+        for (auto widget : std::initializer_list<Widget*> {
+            new Label("Row " + std::to_string(i)), new Button("Launch"), box
+        }) {
+            row->add(widget);
+            widgets.push_back(widget);
+        }
+        widgets.push_back(row);
+    }
+    return widgets;
+}
+
+static void testSteadyLayoutDoesNotAllocate() {
+    HeadlessWindow window;
+    auto widgets = buildPage(window);
+    window.layout();
+    for (auto& widget : widgets) {
+        widget->invalidateLayout();
+    }
+    // the second pass measures exactly what the first one did,
+    // with the text cached, so there's nothing for it to allocate
+    CHECK_EQ(allocationsIn([&] {
+        window.layout();
+    }), 0u);
+    // the accessors hand out what's there rather than copies
+    CHECK_EQ(allocationsIn([&] {
+        for (auto& widget : widgets) {
+            auto children = widget->getChildren();
+            (void)children;
+        }
+        auto& text = static_cast<Label*>(widgets[1])->text();
+        (void)text;
+    }), 0u);
+}
+
+static void testSteadyFrameDoesNotAllocate() {
+    HeadlessWindow window;
+    buildPage(window);
+    NullCanvas canvas(window.all());
+    // the first frame records every widget, the next only replays
+    window.render(canvas);
+    window.render(canvas);
+    CHECK(window.frameStats().m_occluded > 0);
+    CHECK_EQ(allocationsIn([&] {
+        window.render(canvas);
+    }), 0u);
+    CHECK_EQ(window.frameStats().m_recorded, 0u);
+}
+
+int main() {
+    TestApp app;
+    testSteadyLayoutDoesNotAllocate();
+    testSteadyFrameDoesNotAllocate();
+    return finish();
+}
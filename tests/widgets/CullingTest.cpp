@@ -0,0 +1,85 @@
+#include "Harness.hpp"
+#include <RectWidget.hpp>
+
+// a pane that clips a column of cells running far past its bottom,
+// 20 pixel cells 40 apart so none of them sits on the edge
+static RectWidget* buildPane(HeadlessWindow& window, int height, int cells) {
+    auto pane = new RectWidget();
+    pane->color({ 240, 240, 240 });
+    pane->clipChildren();
+    window.add(pane);
+    pane->resize(200, height);
+    pane->move(50, 50);
+    for (int i = 0; i < cells; i++) {
+        auto cell = new RectWidget();
+        cell->color({ 0, 120, 215 });
+        pane->add(cell);
+        cell->resize(200, 20);
+        cell->move(0, i * 40);
+    }
+    window.layout();
+    return pane;
+}
+
+static void testClippedChildrenAreCulled() {
+    HeadlessWindow window;
+    auto pane = buildPane(window, 100, 50);
+
+    // cells at 0, 40 and 80 show, the other 47 are never painted
+    auto& canvas = window.frame();
+    CHECK_EQ(window.frameStats().m_culled, 47u);
+    CHECK_EQ(window.frameStats().m_painted, 4u);
+    // the window background, the pane and three cells
+    CHECK_EQ(canvas.count(RecordingCanvas::Op::FillRect), 5u);
+
+    // the culled cells were left out of the pane's list when it was
+    // recorded, so replaying it has nothing more to cull
+    window.frame();
+    CHECK_EQ(window.frameStats().m_culled, 0u);
+    CHECK_EQ(window.frameStats().m_replayed, 1u);
+
+    // a taller pane records again and shows two more
+    pane->resize(200, 180);
+    window.layout();
+    window.frame();
+    CHECK_EQ(window.frameStats().m_culled, 45u);
+    CHECK_EQ(window.frameStats().m_painted, 6u);
+}
+
+static void testCoveredWidgetsAreOccluded() {
+    HeadlessWindow window;
+    buildPane(window, 100, 50);
+    window.frame();
+
+    // an opaque sibling painted after the pane and covering all of it
+    auto cover = new RectWidget();
+    window.add(cover);
+    cover->resize(220, 200);
+    cover->move(40, 40);
+    window.layout();
+    auto& canvas = window.frame();
+    CHECK_EQ(window.frameStats().m_occluded, 1u);
+    CHECK_EQ(window.frameStats().m_culled, 0u);
+    CHECK_EQ(window.frameStats().m_painted, 1u);
+    CHECK_EQ(canvas.count(RecordingCanvas::Op::FillRect), 2u);
+
+    // damage inside the cover doesn't need the window background either
+    auto& inside = window.frame(Rect(100, 100, 50, 50));
+    CHECK_EQ(window.frameStats().m_occluded, 2u);
+    CHECK_EQ(inside.count(RecordingCanvas::Op::FillRect), 1u);
+
+    // hidden, it stops hiding the pane, which replays what it recorded
+    cover->hide();
+    window.layout();
+    window.frame();
+    CHECK_EQ(window.frameStats().m_occluded, 0u);
+    CHECK_EQ(window.frameStats().m_painted, 1u);
+    CHECK_EQ(window.frameStats().m_replayed, 1u);
+}
+
+int main() {
+    TestApp app;
+    testClippedChildrenAreCulled();
+    testCoveredWidgetsAreOccluded();
+    return finish();
+}
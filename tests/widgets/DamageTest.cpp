@@ -0,0 +1,140 @@
+#include "Harness.hpp"
+#include <Button.hpp>
+#include <Label.hpp>
+#include <Layout.hpp>
+
+// rows of buttons and labels, like a settings page
+static std::vector<Button*> buildPage(HeadlessWindow& window) {
+    std::vector<Button*> buttons;
+    auto column = new VerticalLayout();
+    window.add(column);
+    for (int r = 0; r < 20; r++) {
+        auto row = new HorizontalLayout();
+        column->add(row);
+        row->add(new Label("Setting " + std::to_string(r)));
+        for (int c = 0; c < 10; c++) {
+            auto button = new Button("Option");
+            row->add(button);
+            buttons.push_back(button);
+        }
+    }
+    return buttons;
+}
+
+static void testHoverPaintsOnlyTheButton() {
+    HeadlessWindow window(1600, 1200);
+    auto buttons = buildPage(window);
+    window.frame();
+    auto everything = window.frameStats().m_recorded;
+    CHECK_EQ(everything, 1u + 20u + 20u * 11u);
+    CHECK(!window.scheduler().pending());
+
+    auto button = buttons[57];
+    window.hover(center(button), false);
+    auto damage = window.scheduler().damage();
+    // the button's own rect, nothing around it
+    CHECK(damage.Width <= button->width() + 2);
+    CHECK(damage.Height <= button->height() + 2);
+
+    auto& canvas = window.frame(damage);
+    auto& stats = window.frameStats();
+    // the button and the row and column above it paint again, the rest
+    // of the row and column is replayed from their lists and culled
+    CHECK_EQ(stats.m_recorded, 3u);
+    CHECK_EQ(canvas.count(RecordingCanvas::Op::DrawText), 1u);
+    CHECK_EQ(canvas.count(RecordingCanvas::Op::FillRoundRect), 1u);
+    std::printf(
+        "%-48s %10zu of %zu\n", "widgets repainted for a hover",
+        stats.m_recorded, everything
+    );
+    std::printf(
+        "%-48s %10d of %d\n", "pixels repainted for a hover",
+        damage.Width * damage.Height, window.width() * window.height()
+    );
+
+    // leaving it again is just as small
+    window.hover(Point(-10, -10), false);
+    window.frame(window.scheduler().damage());
+    CHECK_EQ(window.frameStats().m_recorded, 3u);
+}
+
+// the colors of the text that reaches it, nothing else
+class TextColors : public Canvas {
+public:
+    std::vector<ARGB> m_colors;
+
+    void fillRect(RectF const&, Fill const&) override {}
+    void strokeRect(RectF const&, Color const&, REAL) override {}
+    void fillRoundRect(Rect const&, int, Fill const&) override {}
+    void strokeRoundRect(Rect const&, int, Color const&) override {}
+    void fillEllipse(RectF const&, Fill const&) override {}
+    void strokePath(Path const&, Color const&, REAL) override {}
+    void drawText(
+        std::wstring const&, std::wstring const&, int, int,
+        Color const& color, RectF const&, TextLayout const&
+    ) override {
+        m_colors.push_back(color.GetValue());
+    }
+    void save() override {}
+    void restore() override {}
+    void clipRect(Rect const&) override {}
+    void translate(REAL, REAL) override {}
+    void rotate(REAL) override {}
+    Rect dirty() const override {
+        return RecordingCanvas::everything();
+    }
+    void* device() const override {
+        return nullptr;
+    }
+};
+
+static void testColorChangesRecordAgain() {
+    HeadlessWindow window;
+    auto column = new VerticalLayout();
+    window.add(column);
+    auto label = new Label("Status");
+    column->add(label);
+    column->add(new Label("Other"));
+    window.frame();
+
+    // nothing about the layout changes, only what the list would replay
+    label->color(Color(255, 200, 0, 0));
+    CHECK(window.scheduler().pending());
+    auto damage = window.scheduler().damage();
+    CHECK(damage.Width > 0 && damage.Height > 0);
+    auto& canvas = window.frame(damage);
+    // the label and the column above it
+    CHECK_EQ(window.frameStats().m_recorded, 2u);
+    TextColors colors;
+    canvas.replay(colors);
+    CHECK_EQ(colors.m_colors.size(), 1u);
+    CHECK_EQ(colors.m_colors.front(), Color(255, 200, 0, 0).GetValue());
+
+    // and a full frame afterwards replays the new color, not the old one
+    TextColors all;
+    window.frame().replay(all);
+    CHECK_EQ(all.m_colors.size(), 2u);
+    CHECK_EQ(all.m_colors.front(), Color(255, 200, 0, 0).GetValue());
+}
+
+static void testMovingDamagesBothRects() {
+    HeadlessWindow window;
+    auto button = new Button("Moving");
+    window.add(button);
+    window.frame();
+    button->move(300, 200);
+    auto damage = window.scheduler().damage();
+    // from the old rect at the corner to the new one
+    CHECK_EQ(damage.X, 0);
+    CHECK_EQ(damage.Y, 0);
+    CHECK(damage.GetRight() >= 300 + button->width());
+    CHECK(damage.GetBottom() >= 200 + button->height());
+}
+
+int main() {
+    TestApp app;
+    testHoverPaintsOnlyTheButton();
+    testMovingDamagesBothRects();
+    testColorChangesRecordAgain();
+    return finish();
+}
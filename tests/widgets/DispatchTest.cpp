@@ -0,0 +1,90 @@
+#include "Harness.hpp"
+#include <Button.hpp>
+#include <RectWidget.hpp>
+
+// A box that wants the mouse and counts what reaches its handlers
+class Box : public RectWidget {
+public:
+    bool m_childMouse = false;
+    size_t m_downs = 0;
+    size_t m_wheels = 0;
+
+    bool wantsMouse() const override {
+        return true;
+    }
+    bool handlesChildMouse() const override {
+        return m_childMouse;
+    }
+    void mouseDown(int, int) override {
+        m_downs++;
+    }
+    bool mouseWheel(int) override {
+        m_wheels++;
+        return true;
+    }
+};
+
+// takes the keyboard when clicked
+class Field : public Button {
+public:
+    bool m_captured = false;
+
+    Field() : Button("Field") {}
+
+    void mouseDown(int, int) override {
+        this->captureKeyboard();
+    }
+    void keyboardCaptured(bool captured) override {
+        m_captured = captured;
+    }
+};
+
+static void testClicksOnlyReachContainersThatAsk() {
+    HeadlessWindow window;
+    auto box = new Box();
+    auto button = new Button("Launch");
+    box->add(button);
+    window.add(box);
+    window.layout();
+
+    window.dispatchClick(center(button), true, 1);
+    window.dispatchClick(center(button), false, 1);
+    CHECK_EQ(box->m_downs, 0u);
+
+    box->m_childMouse = true;
+    window.dispatchClick(center(button), true, 1);
+    window.dispatchClick(center(button), false, 1);
+    CHECK_EQ(box->m_downs, 1u);
+
+    // the wheel goes up to whatever scrolls either way
+    box->m_childMouse = false;
+    Event wheel(Event::Type::MouseWheel);
+    wheel.m_target = button;
+    wheel.m_point = center(button);
+    wheel.m_delta = -WHEEL_DELTA;
+    window.dispatch(wheel);
+    CHECK_EQ(box->m_wheels, 1u);
+}
+
+static void testEscapeReleasesTheKeyboard() {
+    HeadlessWindow window;
+    auto field = new Field();
+    window.add(field);
+    window.layout();
+    window.dispatchClick(center(field), true, 1);
+    window.dispatchClick(center(field), false, 1);
+    CHECK(window.keyboardWidget() == field);
+    CHECK(field->m_captured);
+
+    window.proc(WM_KEYDOWN, VK_ESCAPE, 0);
+    CHECK(window.keyboardWidget() == nullptr);
+    // the widget hears about it, unlike when the handle was just dropped
+    CHECK(!field->m_captured);
+}
+
+int main() {
+    TestApp app;
+    testClicksOnlyReachContainersThatAsk();
+    testEscapeReleasesTheKeyboard();
+    return finish();
+}
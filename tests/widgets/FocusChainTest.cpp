@@ -0,0 +1,133 @@
+#include "Harness.hpp"
+#include <Input.hpp>
+#include <Label.hpp>
+#include <Layout.hpp>
+#include <algorithm>
+
+// a long form, a label and an input on every row
+static std::vector<Input*> buildForm(HeadlessWindow& window, VerticalLayout*& column, int fields) {
+    std::vector<Input*> inputs;
+    column = new VerticalLayout();
+    window.add(column);
+    for (int i = 0; i < fields; i++) {
+        auto row = new HorizontalLayout();
+        column->add(row);
+        row->add(new Label("Field " + std::to_string(i)));
+        auto input = new Input();
+        row->add(input);
+        inputs.push_back(input);
+    }
+    return inputs;
+}
+
+// what tabbing used to do, going through the whole tree for the
+// focusable widgets and finding where the focused one is among them
+static void collectFocusable(Widget* widget, std::vector<Widget*>& into) {
+    if (!widget->visible()) return;
+    if (widget->wantsMouse()) {
+        into.push_back(widget);
+    }
+    for (auto& child : widget->getChildren()) {
+        collectFocusable(child, into);
+    }
+}
+
+static void testTabGoesInTreeOrder() {
+    HeadlessWindow window;
+    VerticalLayout* column;
+    auto inputs = buildForm(window, column, 2000);
+    CHECK_EQ(window.focusChainSize(), 2000u);
+    auto inOrder = true;
+    for (auto& input : inputs) {
+        window.focusNext();
+        inOrder = inOrder && window.tabFocused() == input;
+    }
+    CHECK(inOrder);
+    // and around again from the start
+    window.focusNext();
+    CHECK(window.tabFocused() == inputs.front());
+    window.focusNext(true);
+    CHECK(window.tabFocused() == inputs.back());
+}
+
+static void testHiddenRowsLeaveTheChain() {
+    HeadlessWindow window;
+    VerticalLayout* column;
+    auto inputs = buildForm(window, column, 2000);
+    auto row = inputs[1000]->getParent();
+    row->hide();
+    CHECK_EQ(window.focusChainSize(), 1999u);
+
+    // tabbing steps over it
+    for (int i = 0; i < 1000; i++) {
+        window.focusNext();
+    }
+    CHECK(window.tabFocused() == inputs[999]);
+    window.focusNext();
+    CHECK(window.tabFocused() == inputs[1001]);
+
+    // showing it again puts it back where it was in the tree
+    row->show();
+    CHECK_EQ(window.focusChainSize(), 2000u);
+    window.focusNext(true);
+    CHECK(window.tabFocused() == inputs[1000]);
+
+    // as does adding a field to a row in the middle
+    auto extra = new Input();
+    inputs[500]->getParent()->add(extra);
+    CHECK_EQ(window.focusChainSize(), 2001u);
+    window.focusNext(true);
+    for (int i = 0; i < 499; i++) {
+        window.focusNext(true);
+    }
+    CHECK(window.tabFocused() == extra);
+}
+
+static void benchmarkFocusChain() {
+    HeadlessWindow window;
+    VerticalLayout* column;
+    std::vector<Input*> inputs;
+    report("build a 2,000 field form", timeMs([&] {
+        inputs = buildForm(window, column, 2000);
+    }));
+    report("tab through 2,000 fields", timeMs([&] {
+        for (size_t i = 0; i < inputs.size(); i++) {
+            window.focusNext();
+        }
+    }));
+    CHECK(window.tabFocused() == inputs.back());
+
+    size_t found = 0;
+    report("tab through 2,000 fields, walking the tree", timeMs([&] {
+        std::vector<Widget*> focusable;
+        Widget* focused = nullptr;
+        for (size_t i = 0; i < inputs.size(); i++) {
+            focusable.clear();
+            collectFocusable(&window, focusable);
+            auto it = std::find(focusable.begin(), focusable.end(), focused);
+            focused = it == focusable.end() || ++it == focusable.end() ?
+                focusable.front() : *it;
+            found++;
+        }
+        CHECK(focused == inputs.back());
+    }));
+    CHECK_EQ(found, inputs.size());
+
+    report("hide and show 1,000 rows", timeMs([&] {
+        for (int i = 0; i < 1000; i++) {
+            inputs[i]->getParent()->hide();
+        }
+        for (int i = 0; i < 1000; i++) {
+            inputs[i]->getParent()->show();
+        }
+    }));
+    CHECK_EQ(window.focusChainSize(), 2000u);
+}
+
+int main() {
+    TestApp app;
+    testTabGoesInTreeOrder();
+    testHiddenRowsLeaveTheChain();
+    benchmarkFocusChain();
+    return finish();
+}
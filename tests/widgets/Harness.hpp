@@ -0,0 +1,128 @@
+#pragma once
+
+#include "../Check.hpp"
+#include <Manager.hpp>
+#include <Window.hpp>
+#include <RecordingCanvas.hpp>
+
+inline Point center(Widget* widget) {
+    auto r = widget->rect();
+    return Point(r.X + r.Width / 2, r.Y + r.Height / 2);
+}
+
+// What Manager::run starts up, minus the message loop
+struct TestApp {
+    ULONG_PTR m_gdiToken;
+
+    TestApp() {
+        Manager::setup(GetModuleHandle(nullptr));
+        Gdiplus::GdiplusStartupInput input;
+        Gdiplus::GdiplusStartup(&m_gdiToken, &input, nullptr);
+    }
+    ~TestApp() {
+        Gdiplus::GdiplusShutdown(m_gdiToken);
+    }
+};
+
+// Records what's drawn with the lists replayed into it rather than
+// referred to, so the counts are what a backend would have to draw
+class FlatRecording : public RecordingCanvas {
+public:
+    using RecordingCanvas::RecordingCanvas;
+
+    void drawList(
+        std::shared_ptr<RecordingCanvas const> const& list,
+        Point const& offset,
+        Rect const& bounds
+    ) override {
+        Canvas::drawList(list, offset, bounds);
+    }
+    void drawLayer(
+        uintptr_t key,
+        std::shared_ptr<RecordingCanvas const> const& list,
+        Point const& offset,
+        Rect const& bounds
+    ) override {
+        Canvas::drawLayer(key, list, offset, bounds);
+    }
+    void drawScrolled(
+        uintptr_t key,
+        std::shared_ptr<RecordingCanvas const> const& list,
+        Point const& offset,
+        Rect const& bounds,
+        Rect const& viewport
+    ) override {
+        Canvas::drawScrolled(key, list, offset, bounds, viewport);
+    }
+};
+
+// A window that's never on screen. Frames run on demand the same way
+// WM_PAINT runs them, into a recording or into a bitmap through GDI+.
+// Base is the window class to run, e.g. MainWindow for the real tree
+template<class Base>
+class Headless : public Base {
+protected:
+    std::unique_ptr<FlatRecording> m_recording;
+
+public:
+    using Base::hover;
+    using Base::dispatchClick;
+    using Base::queuePointer;
+    using Base::flushPointer;
+
+    template<class... Args>
+    Headless(Args&&... args) : Base(std::forward<Args>(args)...) {
+        // windows show themselves when they're made, the widget stays
+        // shown so the tree paints but the HWND is hidden again
+        ShowWindow(this->m_hwnd, SW_HIDE);
+    }
+
+    Rect all() const {
+        return Rect(0, 0, this->width(), this->height());
+    }
+
+    FlatRecording& frame(Rect const& dirty) {
+        m_recording = std::make_unique<FlatRecording>(dirty);
+        this->render(*m_recording);
+        return *m_recording;
+    }
+    FlatRecording& frame() {
+        return this->frame(this->all());
+    }
+
+    void render(Canvas& canvas) {
+        auto hdc = GetDC(this->m_hwnd);
+        this->renderFrame(hdc, canvas);
+        ReleaseDC(this->m_hwnd, hdc);
+    }
+
+    void paintGdi(Rect const& dirty) {
+        auto screen = GetDC(this->m_hwnd);
+        auto hdc = CreateCompatibleDC(screen);
+        auto bitmap = CreateCompatibleBitmap(screen, this->width(), this->height());
+        auto old = SelectObject(hdc, bitmap);
+        {
+            GdiCanvas canvas(hdc, this->m_paintPool, &this->m_layerCache, dirty);
+            this->renderFrame(hdc, canvas);
+        }
+        SelectObject(hdc, old);
+        DeleteObject(bitmap);
+        DeleteDC(hdc);
+        ReleaseDC(this->m_hwnd, screen);
+    }
+    void paintGdi() {
+        this->paintGdi(this->all());
+    }
+
+    void layout() {
+        auto hdc = GetDC(this->m_hwnd);
+        this->runLayout(hdc);
+        ReleaseDC(this->m_hwnd, hdc);
+    }
+};
+
+class HeadlessWindow : public Headless<Window> {
+public:
+    HeadlessWindow(int width = 800, int height = 600)
+      : Headless<Window>("Test", width, height) {}
+};
@@ -0,0 +1,179 @@
+#include "Harness.hpp"
+#include <Button.hpp>
+#include <Layout.hpp>
+#include <random>
+
+// rows of buttons, rows * columns of them
+static std::vector<Button*> buildGrid(HeadlessWindow& window, int rows, int columns) {
+    std::vector<Button*> buttons;
+    auto column = new VerticalLayout();
+    window.add(column);
+    for (int r = 0; r < rows; r++) {
+        auto row = new HorizontalLayout();
+        column->add(row);
+        for (int c = 0; c < columns; c++) {
+            auto button = new Button("x");
+            row->add(button);
+            buttons.push_back(button);
+        }
+    }
+    window.layout();
+    return buttons;
+}
+
+static void testHitsAreInPaintOrder() {
+    HeadlessWindow window;
+    auto buttons = buildGrid(window, 3, 3);
+    // a button with a button inside of it, both under the pointer
+    auto inner = new Button("x");
+    buttons[4]->add(inner);
+    window.layout();
+    auto& hits = window.hitTest(center(inner));
+    CHECK_EQ(hits.size(), 2u);
+    CHECK(hits.front() == buttons[4]);
+    CHECK(hits.back() == inner);
+    CHECK(window.hover(center(buttons[0]), false) == buttons[0]);
+    CHECK(window.hitTest(Point(-10, -10)).empty());
+}
+
+static void testPaintsBeforeFollowsTheTree() {
+    HeadlessWindow window;
+    auto buttons = buildGrid(window, 2, 2);
+    CHECK(Widget::paintsBefore(buttons[0], buttons[1]));
+    CHECK(!Widget::paintsBefore(buttons[1], buttons[0]));
+    // across rows, through the ancestors they share
+    CHECK(Widget::paintsBefore(buttons[1], buttons[2]));
+    CHECK(Widget::paintsBefore(buttons[0]->getParent(), buttons[0]));
+    CHECK(!Widget::paintsBefore(buttons[0], buttons[0]->getParent()));
+    CHECK(!Widget::paintsBefore(buttons[3], buttons[3]));
+}
+
+static void benchmarkHitTesting() {
+    HeadlessWindow window(8000, 8000);
+    auto buttons = buildGrid(window, 100, 100);
+    CHECK_EQ(buttons.size(), 10000u);
+    std::mt19937 random(1);
+    std::vector<Point> points;
+    for (int i = 0; i < 10000; i++) {
+        points.push_back(center(buttons[random() % buttons.size()]));
+    }
+    size_t found = 0;
+    report("build the hit index of 10,000 buttons", timeMs([&] {
+        window.hitTest(points.front());
+    }));
+    report("hit test 10,000 points", timeMs([&] {
+        for (auto& p : points) {
+            found += window.hitTest(p).size();
+        }
+    }));
+    CHECK_EQ(found, points.size());
+    report("hover 10,000 points", timeMs([&] {
+        for (auto& p : points) {
+            window.hover(p, false);
+        }
+    }));
+    // what every move cost before, looking at every widget's rect
+    size_t scanned = 0;
+    report("scan 10,000 buttons for 1,000 points", timeMs([&] {
+        for (size_t i = 0; i < 1000; i++) {
+            for (auto& button : buttons) {
+                if (button->rect().Contains(points[i])) scanned++;
+            }
+        }
+    }));
+    CHECK_EQ(scanned, 1000u);
+}
+
+// columns of widgets nested depth deep, each with a button at the bottom
+static std::vector<Button*> buildDeep(HeadlessWindow& window, int columns, int depth) {
+    std::vector<Button*> buttons;
+    auto row = new HorizontalLayout();
+    window.add(row);
+    for (int c = 0; c < columns; c++) {
+        auto button = new Button("x");
+        Widget* widget = button;
+        for (int d = 0; d < depth; d++) {
+            widget = new PadWidget(1, widget);
+        }
+        row->add(widget);
+        buttons.push_back(button);
+    }
+    window.layout();
+    return buttons;
+}
+
+static void testDeepOffsetsFollowMoves() {
+    HeadlessWindow window;
+    auto buttons = buildDeep(window, 4, 40);
+    auto row = window.getChildren()[0];
+    CHECK(row->validateOffsets());
+    auto before = buttons[2]->rect();
+    // every level is padded by one, so the button sits 40 in
+    CHECK_EQ(before.Y - row->rect().Y, 40);
+
+    // moving the top of the tree moves everything under it
+    row->move(row->x() + 7, row->y() + 3);
+    CHECK(row->validateOffsets());
+    CHECK_EQ(buttons[2]->rect().X, before.X + 7);
+    CHECK_EQ(buttons[2]->rect().Y, before.Y + 3);
+    // the pads don't take the mouse, so only the button is hit, with
+    // the clip check going through all 40 levels above it
+    auto& hits = window.hitTest(center(buttons[2]));
+    CHECK_EQ(hits.size(), 1u);
+    CHECK(hits.back() == buttons[2]);
+}
+
+static void benchmarkDeepHitTesting() {
+    HeadlessWindow window(8000, 600);
+    auto buttons = buildDeep(window, 100, 40);
+    std::mt19937 random(1);
+    std::vector<Point> points;
+    for (int i = 0; i < 10000; i++) {
+        points.push_back(center(buttons[random() % buttons.size()]));
+    }
+    size_t found = 0;
+    report("hit test 10,000 points 40 levels deep", timeMs([&] {
+        for (auto& p : points) {
+            found += window.hitTest(p).size();
+        }
+    }));
+    CHECK_EQ(found, points.size());
+    report("hover 10,000 points 40 levels deep", timeMs([&] {
+        for (auto& p : points) {
+            window.hover(p, false);
+        }
+    }));
+
+    // rect() is the cached offset, against walking the parents each time
+    long long sum = 0;
+    report("rect() of 100 buttons x 1,000, cached", timeMs([&] {
+        for (int i = 0; i < 1000; i++) {
+            for (auto& button : buttons) {
+                sum += button->rect().X;
+            }
+        }
+    }));
+    report("rect() of 100 buttons x 1,000, walking parents", timeMs([&] {
+        for (int i = 0; i < 1000; i++) {
+            for (auto& button : buttons) {
+                Point p(button->x(), button->y());
+                for (auto w = button->getParent(); w && w->getParent(); w = w->getParent()) {
+                    p.X += w->x();
+                    p.Y += w->y();
+                }
+                sum -= p.X;
+            }
+        }
+    }));
+    CHECK_EQ(sum, 0);
+}
+
+int main() {
+    TestApp app;
+    testHitsAreInPaintOrder();
+    testPaintsBeforeFollowsTheTree();
+    benchmarkHitTesting();
+    testDeepOffsetsFollowMoves();
+    benchmarkDeepHitTesting();
+    return finish();
+}
@@ -0,0 +1,110 @@
+#include "Harness.hpp"
+#include <Button.hpp>
+#include <Layout.hpp>
+
+class CountingButton : public Button {
+public:
+    size_t m_enters = 0;
+    size_t m_leaves = 0;
+    size_t m_moves = 0;
+    size_t m_updates = 0;
+
+    CountingButton(std::string const& text) : Button(text) {}
+
+    void enter() override {
+        m_enters++;
+        Button::enter();
+    }
+    void leave() override {
+        m_leaves++;
+        Button::leave();
+    }
+    void mouseMove(int x, int y) override {
+        m_moves++;
+        Button::mouseMove(x, y);
+    }
+    void update() override {
+        m_updates++;
+        Button::update();
+    }
+
+    void reset() {
+        m_enters = m_leaves = m_moves = m_updates = 0;
+    }
+};
+
+// what Windows sends for one movement of the mouse over the client
+// area, a hit test in screen coordinates then the move in client ones
+static void moveMouse(HeadlessWindow& window, Point const& p) {
+    POINT screen = { p.X, p.Y };
+    ClientToScreen(window.getHWND(), &screen);
+    window.proc(WM_NCHITTEST, 0, MAKELPARAM(screen.x, screen.y));
+    window.proc(WM_MOUSEMOVE, 0, MAKELPARAM(p.X, p.Y));
+}
+
+static void testOneResolutionPerMove() {
+    HeadlessWindow window;
+    auto column = new VerticalLayout();
+    window.add(column);
+    auto a = new CountingButton("First");
+    auto b = new CountingButton("Second");
+    column->add(a);
+    column->add(b);
+    window.layout();
+    window.frame();
+    a->reset();
+    b->reset();
+    auto before = window.pointerStats();
+
+    // both messages at the same point, then the frame's input step
+    moveMouse(window, center(a));
+    window.flushPointer();
+    auto& stats = window.pointerStats();
+    CHECK_EQ(stats.m_moves - before.m_moves, 1u);
+    CHECK_EQ(stats.m_dispatched - before.m_dispatched, 1u);
+    CHECK(window.hoveredWidget() == a);
+    CHECK_EQ(a->m_enters, 1u);
+    CHECK_EQ(a->m_moves, 1u);
+    CHECK_EQ(a->m_updates, 1u);
+    CHECK_EQ(b->m_enters + b->m_moves + b->m_updates, 0u);
+
+    // the same point again is already resolved
+    moveMouse(window, center(a));
+    window.flushPointer();
+    CHECK_EQ(stats.m_dispatched - before.m_dispatched, 1u);
+    CHECK_EQ(stats.m_cached - before.m_cached, 1u);
+    CHECK_EQ(a->m_moves, 1u);
+    CHECK_EQ(a->m_updates, 1u);
+
+    // ten moves across the second button before a frame comes round
+    // are dispatched as the last of them
+    auto r = b->rect();
+    for (int i = 0; i < 10; i++) {
+        moveMouse(window, Point(r.X + 1 + i, r.Y + r.Height / 2));
+    }
+    window.flushPointer();
+    CHECK_EQ(stats.m_dispatched - before.m_dispatched, 2u);
+    CHECK_EQ(stats.m_coalesced - before.m_coalesced, 9u);
+    CHECK(window.hoveredWidget() == b);
+    CHECK_EQ(a->m_leaves, 1u);
+    CHECK_EQ(a->m_updates, 2u);
+    CHECK_EQ(b->m_enters, 1u);
+    CHECK_EQ(b->m_moves, 1u);
+    CHECK_EQ(b->m_updates, 1u);
+
+    // off every widget the hit test is all there is, and it lets go
+    b->reset();
+    moveMouse(window, Point(window.width() - 10, window.height() - 10));
+    window.flushPointer();
+    CHECK_EQ(stats.m_dispatched - before.m_dispatched, 3u);
+    CHECK(!window.hoveredWidget());
+    CHECK_EQ(b->m_leaves, 1u);
+    CHECK_EQ(b->m_updates, 1u);
+    CHECK_EQ(stats.m_moves, stats.m_dispatched + stats.m_coalesced + stats.m_cached);
+}
+
+int main() {
+    TestApp app;
+    testOneResolutionPerMove();
+    return finish();
+}
@@ -0,0 +1,104 @@
+#include "Harness.hpp"
+#include <Button.hpp>
+#include <Label.hpp>
+#include <Layout.hpp>
+
+struct Form {
+    VerticalLayout* m_column;
+    HorizontalLayout* m_row;
+    Label* m_label;
+    Button* m_ok;
+    Button* m_cancel;
+};
+
+// a row with a label and two buttons, under a column
+static Form buildForm(HeadlessWindow& window) {
+    Form form;
+    form.m_column = new VerticalLayout();
+    window.add(form.m_column);
+    form.m_row = new HorizontalLayout();
+    form.m_row->name("buttons");
+    form.m_column->add(form.m_row);
+    form.m_label = new Label("Save changes?");
+    form.m_label->id(1);
+    form.m_row->add(form.m_label);
+    form.m_ok = new Button("OK");
+    form.m_ok->name("ok");
+    form.m_ok->id(2);
+    form.m_row->add(form.m_ok);
+    form.m_cancel = new Button("Cancel");
+    form.m_cancel->name("cancel");
+    form.m_cancel->id(2);
+    form.m_row->add(form.m_cancel);
+    return form;
+}
+
+static void testLookupsFollowRenames() {
+    HeadlessWindow window;
+    auto form = buildForm(window);
+    CHECK(window.findByName("ok") == form.m_ok);
+    CHECK(window.findByName("buttons") == form.m_row);
+    CHECK(window.findByID(1) == form.m_label);
+    CHECK_EQ(window.findAllByID(2).size(), 2u);
+    CHECK_EQ(window.findByType("Button").size(), 2u);
+    CHECK_EQ(window.findByType("Label").size(), 1u);
+    CHECK(!window.findByName("missing"));
+    CHECK(!window.findByID(3));
+
+    // the old name and id stop finding it as soon as they change
+    form.m_ok->name("accept");
+    CHECK(!window.findByName("ok"));
+    CHECK(window.findByName("accept") == form.m_ok);
+    form.m_ok->id(3);
+    CHECK(window.findByID(3) == form.m_ok);
+    CHECK(window.findByID(2) == form.m_cancel);
+    CHECK_EQ(window.findAllByID(2).size(), 1u);
+    // and a cleared name isn't indexed at all
+    form.m_cancel->name("");
+    CHECK(!window.findByName("cancel"));
+    CHECK(!window.findByName(""));
+}
+
+static void testRemovedSubtreesLeaveTheIndex() {
+    HeadlessWindow window;
+    auto form = buildForm(window);
+
+    // taken out but kept, nothing under it is found any more
+    form.m_column->remove(form.m_row, false);
+    CHECK(!window.findByName("buttons"));
+    CHECK(!window.findByName("ok"));
+    CHECK(!window.findByID(1));
+    CHECK(window.findAllByID(2).empty());
+    CHECK(window.findByType("Button").empty());
+    CHECK(window.findByType("Label").empty());
+
+    // renamed while it's out, which isn't indexed either
+    form.m_ok->name("accept");
+    form.m_label->id(4);
+    CHECK(!window.findByName("accept"));
+    CHECK(!window.findByID(4));
+
+    // put back, the whole subtree is found under what it's called now
+    form.m_column->add(form.m_row);
+    CHECK(window.findByName("buttons") == form.m_row);
+    CHECK(window.findByName("accept") == form.m_ok);
+    CHECK(!window.findByName("ok"));
+    CHECK(window.findByID(4) == form.m_label);
+    CHECK(!window.findByID(1));
+    CHECK_EQ(window.findAllByID(2).size(), 2u);
+    CHECK_EQ(window.findByType("Button").size(), 2u);
+
+    // and deleted, it's gone for good
+    form.m_column->remove(form.m_row, true);
+    CHECK(!window.findByName("buttons"));
+    CHECK(!window.findByName("accept"));
+    CHECK(window.findByType("Button").empty());
+    CHECK_EQ(window.findByType("VerticalLayout").size(), 1u);
+}
+
+int main() {
+    TestApp app;
+    testLookupsFollowRenames();
+    testRemovedSubtreesLeaveTheIndex();
+    return finish();
+}
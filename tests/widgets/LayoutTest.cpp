@@ -0,0 +1,248 @@
+#include "Harness.hpp"
+#include <Label.hpp>
+#include <Layout.hpp>
+#include <RectWidget.hpp>
+#include <algorithm>
+
+static RectWidget* cell(int width, int height) {
+    auto rect = new RectWidget();
+    rect->resize(width, height);
+    return rect;
+}
+
+// rows * columns cells in flex rows stacked in a flex column, the
+// rows kept at their size rather than shrunk to fit the window
+static std::vector<Widget*> buildFlex(HeadlessWindow& window, int rows, int columns) {
+    std::vector<Widget*> cells;
+    auto column = new FlexLayout(FlexLayout::Direction::Column);
+    column->gap(1);
+    window.add(column);
+    FlexLayout::Item fixed;
+    fixed.m_shrink = 0.f;
+    for (int r = 0; r < rows; r++) {
+        auto row = new FlexLayout();
+        row->gap(1);
+        column->add(row, fixed);
+        for (int c = 0; c < columns; c++) {
+            auto widget = cell(5, 5);
+            row->add(widget, fixed);
+            cells.push_back(widget);
+        }
+    }
+    window.layout();
+    return cells;
+}
+
+// the same tree out of the box layouts
+static std::vector<Widget*> buildBoxes(HeadlessWindow& window, int rows, int columns) {
+    std::vector<Widget*> cells;
+    auto column = new VerticalLayout();
+    column->pad(1);
+    window.add(column);
+    for (int r = 0; r < rows; r++) {
+        auto row = new HorizontalLayout();
+        row->pad(1);
+        column->add(row);
+        for (int c = 0; c < columns; c++) {
+            auto widget = cell(5, 5);
+            row->add(widget);
+            cells.push_back(widget);
+        }
+    }
+    window.layout();
+    return cells;
+}
+
+static void testFlexPlacesLikeTheBoxLayouts() {
+    HeadlessWindow flexWindow;
+    HeadlessWindow boxWindow;
+    auto flex = buildFlex(flexWindow, 10, 10);
+    auto boxes = buildBoxes(boxWindow, 10, 10);
+    auto same = true;
+    for (size_t i = 0; i < flex.size(); i++) {
+        auto a = flex[i]->rect();
+        auto b = boxes[i]->rect();
+        same = same && a.X == b.X && a.Y == b.Y;
+    }
+    CHECK(same);
+    CHECK_EQ(flex.back()->rect().X - flex.front()->rect().X, 9 * 6);
+    CHECK_EQ(flex.back()->rect().Y - flex.front()->rect().Y, 9 * 6);
+
+    // a cell growing pushes the rest of its row along, and only that row
+    flex[13]->resize(20, 5);
+    flexWindow.layout();
+    CHECK_EQ(flex[14]->rect().X - flex[13]->rect().X, 21);
+    CHECK_EQ(flex[24]->rect().X - flex[23]->rect().X, 6);
+    CHECK(flexWindow.getChildren()[0]->validateOffsets());
+}
+
+static void benchmarkLayout(
+    const char* name,
+    std::vector<Widget*> (*build)(HeadlessWindow&, int, int)
+) {
+    // 500 rows of 100 cells, a little over 50,000 widgets
+    HeadlessWindow window;
+    std::vector<Widget*> cells;
+    auto first = timeMs([&] {
+        cells = build(window, 500, 100);
+    });
+    CHECK_EQ(cells.size(), 50000u);
+    auto bottom = cells.back()->rect();
+    CHECK_EQ(bottom.Y - cells.front()->rect().Y, 499 * 6);
+
+    // one cell changing size lays out its row and the column again
+    auto change = timeMs([&] {
+        for (int i = 0; i < 100; i++) {
+            cells[25000 + i]->resize(i % 2 ? 6 : 5, 5);
+            window.layout();
+        }
+    });
+    // and everything measured again from scratch
+    auto all = timeMs([&] {
+        for (auto& widget : cells) {
+            widget->invalidateLayout();
+        }
+        window.layout();
+    });
+    CHECK(window.getChildren()[0]->validateOffsets());
+
+    std::printf("%s\n", name);
+    report("  build and lay out 50,000 widgets", first);
+    report("  lay out again after one cell changes, x100", change);
+    report("  lay out everything again", all);
+}
+
+// a settings form, names in a column sized to fit them and values
+// in a column taking the rest of the width
+static std::vector<Label*> buildGrid(HeadlessWindow& window, GridLayout*& grid, int rows) {
+    std::vector<Label*> labels;
+    grid = new GridLayout();
+    grid->columns({ GridLayout::Track::content(), GridLayout::Track::fraction() });
+    grid->pad(4);
+    window.add(grid);
+    for (int r = 0; r < rows; r++) {
+        auto name = new Label("Setting " + std::to_string(r));
+        auto value = new Label("Value");
+        grid->add(name);
+        grid->add(value);
+        labels.push_back(name);
+        labels.push_back(value);
+    }
+    window.layout();
+    return labels;
+}
+
+// the same form as rows of box layouts, which can't line the values
+// up in a column but is what it would take without the grid
+static std::vector<Label*> buildRows(HeadlessWindow& window, int rows) {
+    std::vector<Label*> labels;
+    auto column = new VerticalLayout();
+    column->pad(4);
+    window.add(column);
+    for (int r = 0; r < rows; r++) {
+        auto row = new HorizontalLayout();
+        row->pad(4);
+        column->add(row);
+        auto name = new Label("Setting " + std::to_string(r));
+        auto value = new Label("Value");
+        row->add(name);
+        row->add(value);
+        labels.push_back(name);
+        labels.push_back(value);
+    }
+    window.layout();
+    return labels;
+}
+
+static void testGridSolvesTracksOnlyWhenNeeded() {
+    HeadlessWindow window;
+    GridLayout* grid;
+    auto labels = buildGrid(window, grid, 50);
+    CHECK_EQ(grid->trackSolves(), 1u);
+    // the values line up after the widest name
+    auto widest = 0;
+    for (size_t i = 0; i < labels.size(); i += 2) {
+        widest = std::max(widest, labels[i]->width());
+    }
+    CHECK_EQ(labels[1]->rect().X - grid->rect().X, widest + 4);
+    CHECK_EQ(labels[99]->rect().X, labels[1]->rect().X);
+
+    // measuring a cell again to the same size keeps the tracks
+    labels[20]->invalidateLayout();
+    window.layout();
+    CHECK_EQ(grid->trackSolves(), 1u);
+
+    // a name getting wider moves every value over
+    labels[20]->text("A much longer setting name");
+    window.layout();
+    CHECK_EQ(grid->trackSolves(), 2u);
+    CHECK_EQ(labels[1]->rect().X - grid->rect().X, labels[20]->width() + 4);
+
+    // and so does a different gap
+    grid->pad(8);
+    window.layout();
+    CHECK_EQ(grid->trackSolves(), 3u);
+    CHECK(grid->validateOffsets());
+}
+
+static void benchmarkGrid() {
+    constexpr int rows = 2000;
+    struct Times {
+        double m_change;
+        double m_all;
+    };
+    auto run = [](HeadlessWindow& window, std::vector<Label*>& labels) -> Times {
+        Times times;
+        // one value changing a hundred times, then everything measured again
+        times.m_change = timeMs([&] {
+            for (int i = 0; i < 100; i++) {
+                labels[rows + 1]->text(i % 2 ? "On" : "Off");
+                window.layout();
+            }
+        });
+        times.m_all = timeMs([&] {
+            for (auto& label : labels) {
+                label->invalidateLayout();
+            }
+            window.layout();
+        });
+        return times;
+    };
+
+    HeadlessWindow gridWindow;
+    GridLayout* grid;
+    std::vector<Label*> gridLabels;
+    auto gridFirst = timeMs([&] {
+        gridLabels = buildGrid(gridWindow, grid, rows);
+    });
+    auto gridTimes = run(gridWindow, gridLabels);
+    // once for each time the value measured differently, and not again
+    // for the cells that measured the same as before
+    CHECK_EQ(grid->trackSolves(), 101u);
+
+    HeadlessWindow rowWindow;
+    std::vector<Label*> rowLabels;
+    auto rowFirst = timeMs([&] {
+        rowLabels = buildRows(rowWindow, rows);
+    });
+    auto rowTimes = run(rowWindow, rowLabels);
+
+    std::printf("GridLayout, %d rows\n", rows);
+    report("  build and lay out", gridFirst);
+    report("  lay out again after one value changes, x100", gridTimes.m_change);
+    report("  lay out everything again", gridTimes.m_all);
+    std::printf("VerticalLayout of HorizontalLayouts, %d rows\n", rows);
+    report("  build and lay out", rowFirst);
+    report("  lay out again after one value changes, x100", rowTimes.m_change);
+    report("  lay out everything again", rowTimes.m_all);
+}
+
+int main() {
+    TestApp app;
+    testFlexPlacesLikeTheBoxLayouts();
+    benchmarkLayout("FlexLayout", &buildFlex);
+    benchmarkLayout("VerticalLayout and HorizontalLayout", &buildBoxes);
+    testGridSolvesTracksOnlyWhenNeeded();
+    benchmarkGrid();
+    return finish();
+}
@@ -0,0 +1,70 @@
+#include "Harness.hpp"
+#include <MainWindow.hpp>
+#include <Label.hpp>
+#include <Layout.hpp>
+
+static void testMainWindowMeasuresOnlyWhatChanged() {
+    Headless<MainWindow> window;
+    window.frame();
+    auto first = window.frameStats().m_measured;
+    CHECK(first > 0);
+    std::printf("%-48s %10zu\n", "main window, first frame", first);
+
+    // nothing changed, nothing measured
+    window.frame();
+    CHECK_EQ(window.frameStats().m_measured, 0u);
+
+    // hovering repaints, but sizes stay the same
+    auto buttons = window.findByType("Button");
+    CHECK(!buttons.empty());
+    window.hover(center(buttons.front()), false);
+    window.frame(window.scheduler().damage());
+    CHECK_EQ(window.frameStats().m_measured, 0u);
+    std::printf("%-48s %10zu\n", "main window, hover", window.frameStats().m_measured);
+}
+
+static void testChangedTextMeasuresItsAncestors() {
+    // 100 rows of 50 labels
+    HeadlessWindow window(4000, 4000);
+    auto column = new VerticalLayout();
+    window.add(column);
+    std::vector<Label*> last;
+    for (int r = 0; r < 100; r++) {
+        auto row = new HorizontalLayout();
+        column->add(row);
+        for (int c = 0; c < 50; c++) {
+            auto label = new Label("Label");
+            row->add(label);
+            if (c == 49) last.push_back(label);
+        }
+    }
+    double ms = timeMs([&] {
+        window.frame();
+    });
+    CHECK_EQ(window.frameStats().m_measured, 1u + 100u + 5000u);
+    std::printf("%-48s %10zu\n", "5,000 labels, first frame", window.frameStats().m_measured);
+    report("5,000 labels, first frame", ms);
+
+    // the last label in a row leaves its siblings' space as it was,
+    // so only it and the row and column it's in are measured again
+    last[50]->text("Longer label");
+    ms = timeMs([&] {
+        window.frame(window.scheduler().damage());
+    });
+    CHECK_EQ(window.frameStats().m_measured, 3u);
+    std::printf("%-48s %10zu\n", "5,000 labels, one text changed", window.frameStats().m_measured);
+    report("5,000 labels, one text changed", ms);
+
+    ms = timeMs([&] {
+        window.frame();
+    });
+    CHECK_EQ(window.frameStats().m_measured, 0u);
+    report("5,000 labels, nothing changed", ms);
+}
+
+int main() {
+    TestApp app;
+    testMainWindowMeasuresOnlyWhatChanged();
+    testChangedTextMeasuresItsAncestors();
+    return finish();
+}
@@ -0,0 +1,113 @@
+#include "Harness.hpp"
+#include <MainWindow.hpp>
+#include <Checkbox.hpp>
+#include <Label.hpp>
+
+class PageWindow : public Headless<MainWindow> {
+public:
+    using MainWindow::onTab;
+};
+
+static void buildRows(VerticalLayout* page, int rows) {
+    for (int i = 0; i < rows; i++) {
+        auto row = new HorizontalLayout();
+        page->add(row);
+        row->add(new Label("Setting " + std::to_string(i)));
+        row->add(new Checkbox("Enabled", i % 2));
+    }
+}
+
+static void testPagesGoWithTheirArena() {
+    PageWindow window;
+    // the first tab's page is built straight away
+    CHECK_EQ(window.page(), "home"_id);
+    auto arena = window.pageArena();
+    CHECK(arena != nullptr);
+    auto home = arena->stats().m_liveObjects;
+    auto reserved = arena->stats().m_bytesReserved;
+    CHECK(home > 0);
+
+    window.addPage("rows"_id, "Rows", [](VerticalLayout* page) -> void {
+        buildRows(page, 1000);
+    });
+    window.onTab("rows"_id);
+    window.layout();
+    window.frame();
+    CHECK_EQ(window.page(), "rows"_id);
+    CHECK(window.pageArena() == arena);
+    CHECK(arena->stats().m_liveObjects > 3000u);
+    CHECK(arena->stats().m_blocks > 1u);
+    CHECK_EQ(window.findByType("Checkbox").size(), 1000u);
+
+    // back again, the rows are gone and so is all but the first block
+    window.onTab("home"_id);
+    CHECK_EQ(window.findByType("Checkbox").size(), 1u);
+    CHECK_EQ(arena->stats().m_liveObjects, home);
+    CHECK_EQ(arena->stats().m_bytesReserved, reserved);
+}
+
+static void testStrayWidgetsGoWithTheirArena() {
+    // made while a page was built but never added to it
+    PageWindow window;
+    SlotHandle stray;
+    window.addPage("stray"_id, "Stray", [&](VerticalLayout* page) -> void {
+        stray = (new Label("Never added"))->handle();
+        page->add(new Label("Added"));
+    });
+    window.onTab("stray"_id);
+    CHECK(Widget::fromHandle(stray) != nullptr);
+    window.onTab("home"_id);
+    CHECK(Widget::fromHandle(stray) == nullptr);
+
+    // and the same for the window's own arena when it closes
+    {
+        HeadlessWindow other;
+        ArenaScope scope(other.arena());
+        other.add(new Label("Added"));
+        stray = (new Label("Never added"))->handle();
+    }
+    CHECK(Widget::fromHandle(stray) == nullptr);
+}
+
+static void benchmarkPages() {
+    // a settings page of 5,000 rows, built and torn down again
+    constexpr int rows = 5000;
+    constexpr int rounds = 10;
+    PageWindow window;
+    window.addPage("rows"_id, "Rows", [](VerticalLayout* page) -> void {
+        buildRows(page, rows);
+    });
+    size_t blocks = 0;
+    auto arena = timeMs([&] {
+        for (int i = 0; i < rounds; i++) {
+            window.onTab("rows"_id);
+            blocks = window.pageArena()->stats().m_blocks;
+            window.onTab("home"_id);
+        }
+    });
+    CHECK_EQ(window.findByType("Checkbox").size(), 1u);
+
+    // the same rows on the heap, in and out of a window
+    HeadlessWindow heapWindow;
+    auto heap = timeMs([&] {
+        for (int i = 0; i < rounds; i++) {
+            auto page = new VerticalLayout();
+            buildRows(page, rows);
+            heapWindow.add(page);
+            heapWindow.remove(page);
+        }
+    });
+    CHECK(heapWindow.findByType("Checkbox").empty());
+
+    report("5,000 row page x10, page arena", arena);
+    report("5,000 row page x10, heap", heap);
+    std::printf("%-48s %10zu\n", "arena blocks for the page", blocks);
+}
+
+int main() {
+    TestApp app;
+    testPagesGoWithTheirArena();
+    testStrayWidgetsGoWithTheirArena();
+    benchmarkPages();
+    return finish();
+}
@@ -0,0 +1,80 @@
+#include "Harness.hpp"
+#include <Button.hpp>
+#include <Checkbox.hpp>
+#include <Label.hpp>
+#include <Layout.hpp>
+#include <RectWidget.hpp>
+#include <Style.hpp>
+
+// a bit of everything that asks the pool for brushes, pens and fonts
+static std::vector<Button*> buildPage(HeadlessWindow& window) {
+    std::vector<Button*> buttons;
+    auto background = new RectWidget();
+    background->fill();
+    window.add(background);
+    auto column = new VerticalLayout();
+    background->add(column);
+    for (int i = 0; i < 10; i++) {
+        auto row = new HorizontalLayout();
+        column->add(row);
+        row->add(new Label("Setting " + std::to_string(i)));
+        row->add(new Checkbox("Enabled", i % 2));
+        auto button = new Button("Launch");
+        row->add(button);
+        buttons.push_back(button);
+    }
+    return buttons;
+}
+
+static void testSteadyHoverCreatesNothing() {
+    HeadlessWindow window;
+    auto buttons = buildPage(window);
+    window.paintGdi();
+    auto first = window.frameStats().m_paintObjectsCreated;
+    CHECK(first > 0);
+
+    // the first hover makes the lighter gradient, leaving and hovering
+    // again only asks for what the pool already has
+    auto button = buttons[4];
+    window.hover(center(button), false);
+    window.paintGdi(window.scheduler().damage());
+    window.hover(Point(-10, -10), false);
+    window.paintGdi(window.scheduler().damage());
+    window.hover(center(button), false);
+    window.paintGdi(window.scheduler().damage());
+    CHECK_EQ(window.frameStats().m_paintObjectsCreated, 0u);
+    CHECK(window.paintPool().stats().m_reused > 0);
+    std::printf(
+        "%-48s %10zu then %zu\n", "paint objects created, first frame and hover",
+        first, window.frameStats().m_paintObjectsCreated
+    );
+
+    // a full frame is steady too
+    window.paintGdi();
+    CHECK_EQ(window.frameStats().m_paintObjectsCreated, 0u);
+}
+
+static void testThemeReloadStartsOver() {
+    HeadlessWindow window;
+    buildPage(window);
+    window.paintGdi();
+    window.paintGdi();
+    CHECK_EQ(window.frameStats().m_paintObjectsCreated, 0u);
+
+    // the pool can't know which colors changed, so it drops them all
+    auto id = Style::id();
+    Style::current()->load(Theme::get(
+        id == "dark" ? Theme::Default::Light : Theme::Default::Dark
+    ));
+    window.paintGdi();
+    CHECK(window.frameStats().m_paintObjectsCreated > 0);
+    window.paintGdi();
+    CHECK_EQ(window.frameStats().m_paintObjectsCreated, 0u);
+}
+
+int main() {
+    TestApp app;
+    testSteadyHoverCreatesNothing();
+    testThemeReloadStartsOver();
+    return finish();
+}
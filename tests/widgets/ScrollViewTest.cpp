@@ -0,0 +1,123 @@
+#include "Harness.hpp"
+#include <Button.hpp>
+#include <Layout.hpp>
+#include <RectWidget.hpp>
+#include <ScrollView.hpp>
+
+class PressButton : public Button {
+public:
+    size_t m_clicks = 0;
+
+    PressButton() : Button("Launch") {}
+
+    bool pressed() const {
+        return m_mousedown;
+    }
+    void click() override {
+        m_clicks++;
+    }
+};
+
+static void testDraggingCancelsThePress() {
+    HeadlessWindow window;
+    auto view = new ScrollView();
+    window.add(view);
+    std::vector<PressButton*> buttons;
+    for (int i = 0; i < 50; i++) {
+        auto button = new PressButton();
+        view->add(button);
+        buttons.push_back(button);
+    }
+    window.layout();
+
+    auto button = buttons[2];
+    auto p = center(button);
+    window.hover(p, false);
+    window.dispatchClick(p, true, 1);
+    CHECK(button->pressed());
+
+    // past the threshold the view takes the press over as a drag
+    auto moved = Point(p.X, p.Y - ScrollView::s_dragThreshold * 4);
+    window.queuePointer(moved, true);
+    window.flushPointer();
+    CHECK(window.capturingWidget() == view);
+    // neither the button it went down on nor whichever one the
+    // pointer moved onto on the way stays pressed
+    for (auto& b : buttons) {
+        CHECK(!b->pressed());
+    }
+    CHECK_EQ(view->scroll().Y, ScrollView::s_dragThreshold * 4);
+
+    window.dispatchClick(moved, false, 1);
+    CHECK(window.capturingWidget() == nullptr);
+    CHECK_EQ(button->m_clicks, 0u);
+
+    // a press that doesn't move still clicks
+    window.layout();
+    window.hover(center(button), false);
+    window.dispatchClick(center(button), true, 1);
+    window.dispatchClick(center(button), false, 1);
+    CHECK_EQ(button->m_clicks, 1u);
+}
+
+static void testExtentCoversNestedContent() {
+    HeadlessWindow window;
+    auto view = new ScrollView();
+    window.add(view);
+    // a holder with no size of its own, and a button far below it
+    auto holder = new Widget();
+    holder->show();
+    auto far = new Button("Far");
+    holder->add(far);
+    far->resize(100, 30);
+    far->move(0, 3000);
+    view->add(holder);
+    window.layout();
+
+    view->scrollTo(0, 1000000, true);
+    window.layout();
+    auto bottom = far->rect().Y + far->height();
+    auto viewBottom = view->rect().Y + view->height();
+    CHECK_EQ(bottom, viewBottom);
+}
+
+static void testRowsOutOfViewAreCulled() {
+    HeadlessWindow window;
+    // 50 rows 40 apart in a view 100 high, three of them in view
+    auto content = new Widget();
+    content->show();
+    for (int i = 0; i < 50; i++) {
+        auto row = new RectWidget();
+        content->add(row);
+        row->resize(200, 20);
+        row->move(0, i * 40);
+    }
+    auto view = new ScrollView(content);
+    window.add(view);
+    view->resize(200, 100);
+    view->move(50, 50);
+    window.layout();
+
+    // every row is recorded into the content's list, since it's
+    // kept for the whole extent, and culled against the viewport
+    auto& canvas = window.frame();
+    CHECK_EQ(window.frameStats().m_culled, 47u);
+    CHECK_EQ(canvas.count(RecordingCanvas::Op::FillRect), 4u);
+
+    // scrolled ten rows down, the list is only replayed further up
+    // and a different three make it through
+    view->scrollTo(0, 400, true);
+    window.layout();
+    window.frame();
+    CHECK_EQ(window.frameStats().m_culled, 47u);
+    CHECK_EQ(window.frameStats().m_recorded, 1u);
+    CHECK_EQ(window.frameStats().m_replayed, 1u);
+}
+
+int main() {
+    TestApp app;
+    testDraggingCancelsThePress();
+    testExtentCoversNestedContent();
+    testRowsOutOfViewAreCulled();
+    return finish();
+}
@@ -0,0 +1,74 @@
+#include "Harness.hpp"
+#include <Label.hpp>
+#include <VirtualList.hpp>
+
+static Widget* buildRow(size_t index, Widget* recycled) {
+    auto text = "Row " + std::to_string(index);
+    if (auto label = static_cast<Label*>(recycled)) {
+        label->text(text);
+        return label;
+    }
+    return new Label(text);
+}
+
+static void testOnlyRowsInViewHaveWidgets() {
+    HeadlessWindow window;
+    auto list = new VirtualList(100000, &buildRow);
+    window.add(list);
+    window.layout();
+    window.frame();
+    auto created = list->stats().m_created;
+    CHECK(created > 0);
+    CHECK(created < 100u);
+
+    // all the way down and back up again reuses the same widgets
+    list->scrollToRow(99999);
+    window.layout();
+    list->scrollTo(0);
+    window.layout();
+    CHECK_EQ(list->stats().m_created, created);
+    CHECK(list->stats().m_recycled > 0);
+    CHECK(list->getChildren().size() <= created);
+
+    list->scrollToRow(50000);
+    window.layout();
+    auto& canvas = window.frame();
+    CHECK(canvas.count(RecordingCanvas::Op::DrawText) > 0);
+    CHECK(canvas.count(RecordingCanvas::Op::DrawText) <= list->getChildren().size());
+}
+
+static void benchmarkRowCounts() {
+    // the same window scrolled through lists of more and more rows, so
+    // the widgets and the time per frame should stay the same
+    std::printf("%-24s %12s %12s %12s\n", "rows", "widgets", "ms/frame", "bytes");
+    for (size_t rows : { 1000u, 10000u, 100000u, 1000000u }) {
+        HeadlessWindow window;
+        auto list = new VirtualList(rows, &buildRow);
+        window.add(list);
+        window.layout();
+        window.frame();
+
+        constexpr int frames = 200;
+        auto took = timeMs([&] {
+            for (int i = 0; i < frames; i++) {
+                list->scrollToRow(rows * i / frames);
+                window.layout();
+                window.frame(window.scheduler().damage());
+            }
+        });
+        CHECK(list->stats().m_created < 100u);
+        // what the list keeps per row, a height and a tree node
+        auto bytes = rows * (sizeof(int) + sizeof(int64_t));
+        std::printf(
+            "%-24zu %12zu %12.3f %12zu\n",
+            rows, list->getChildren().size(), took / frames, bytes
+        );
+    }
+}
+
+int main() {
+    TestApp app;
+    testOnlyRowsInViewHaveWidgets();
+    benchmarkRowCounts();
+    return finish();
+}
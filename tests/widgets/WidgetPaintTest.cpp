@@ -0,0 +1,50 @@
+#include "Harness.hpp"
+#include <Button.hpp>
+#include <Label.hpp>
+#include <Layout.hpp>
+
+static void testButtonsPaintThroughTheCanvas() {
+    HeadlessWindow window;
+    auto layout = new VerticalLayout();
+    window.add(layout);
+    for (int i = 0; i < 10; i++) {
+        layout->add(new Button("Launch"));
+    }
+    auto& canvas = window.frame();
+    CHECK_EQ(canvas.count(RecordingCanvas::Op::FillRoundRect), 10u);
+    CHECK_EQ(canvas.count(RecordingCanvas::Op::DrawText), 10u);
+    // the same text and font for every button, stored once
+    CHECK_EQ(canvas.strings().size(), 2u);
+    CHECK_EQ(window.frameStats().m_painted, 11u);
+
+    // a second frame replays what the first one recorded
+    window.frame();
+    CHECK_EQ(window.frameStats().m_recorded, 0u);
+}
+
+static void benchmarkPaint() {
+    HeadlessWindow window(800, 20000);
+    auto layout = new VerticalLayout();
+    window.add(layout);
+    for (int i = 0; i < 1000; i++) {
+        layout->add(new Button("Launch"));
+        layout->add(new Label("Label " + std::to_string(i)));
+    }
+    report("record the first frame of 2,000 widgets", timeMs([&] {
+        window.frame();
+    }));
+    CHECK_EQ(window.frameStats().m_recorded, 2001u);
+    report("record it again", timeMs([&] {
+        window.frame();
+    }));
+    report("paint it with GDI+", timeMs([&] {
+        window.paintGdi();
+    }));
+}
+
+int main() {
+    TestApp app;
+    testButtonsPaintThroughTheCanvas();
+    benchmarkPaint();
+    return finish();
+}